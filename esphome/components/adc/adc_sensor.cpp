@@ -1,5 +1,11 @@
 #include "adc_sensor.h"
 #include "esphome/core/log.h"
+#include "esphome/components/voltage_sampler/block_kernels.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <driver/adc.h>
+#include <driver/i2s.h>
+#endif
 
 #ifdef USE_ADC_SENSOR_VCC
 ADC_MODE(ADC_VCC)
@@ -11,7 +17,66 @@ namespace adc {
 static const char *TAG = "adc";
 
 #ifdef ARDUINO_ARCH_ESP32
+/// The I2S peripheral that can be driven by ADC1, continuous sampling is only possible on one pin at a time.
+static const i2s_port_t ADC_I2S_PORT = I2S_NUM_0;
+/// Number of DMA buffers of one block each, one is being filled while the others wait for loop().
+static const int ADC_DMA_BUFFERS = 4;
+
+static bool gpio_to_adc1_channel(uint8_t pin, adc1_channel_t *channel) {
+  switch (pin) {
+    case 36:
+      *channel = ADC1_CHANNEL_0;
+      return true;
+    case 37:
+      *channel = ADC1_CHANNEL_1;
+      return true;
+    case 38:
+      *channel = ADC1_CHANNEL_2;
+      return true;
+    case 39:
+      *channel = ADC1_CHANNEL_3;
+      return true;
+    case 32:
+      *channel = ADC1_CHANNEL_4;
+      return true;
+    case 33:
+      *channel = ADC1_CHANNEL_5;
+      return true;
+    case 34:
+      *channel = ADC1_CHANNEL_6;
+      return true;
+    case 35:
+      *channel = ADC1_CHANNEL_7;
+      return true;
+    default:
+      return false;
+  }
+}
+
 void ADCSensor::set_attenuation(adc_attenuation_t attenuation) { this->attenuation_ = attenuation; }
+void ADCSensor::set_continuous(uint32_t sample_rate, size_t block_size) {
+  this->sample_rate_ = sample_rate;
+  this->block_size_ = block_size;
+}
+bool ADCSensor::add_on_sample_block_callback(voltage_sampler::sample_block_callback_t &&callback) {
+  if (this->sample_rate_ == 0)
+    return false;
+  this->sample_block_callback_.add(std::move(callback));
+  return true;
+}
+float ADCSensor::full_scale_voltage_() const {
+  switch (this->attenuation_) {
+    case ADC_0db:
+      return 1.1f;
+    case ADC_2_5db:
+      return 1.5f;
+    case ADC_6db:
+      return 2.2f;
+    case ADC_11db:
+      return 3.9f;
+  }
+  return 1.1f;
+}
 #endif
 
 void ADCSensor::setup() {
@@ -20,8 +85,81 @@ void ADCSensor::setup() {
 
 #ifdef ARDUINO_ARCH_ESP32
   analogSetPinAttenuation(this->pin_, this->attenuation_);
+
+  if (this->sample_rate_ != 0) {
+    adc1_channel_t channel;
+    if (!gpio_to_adc1_channel(this->pin_, &channel)) {
+      ESP_LOGE(TAG, "Continuous sampling is only possible on ADC1 pins (GPIO32-GPIO39)!");
+      this->mark_failed();
+      return;
+    }
+    i2s_config_t config = {
+        .mode = i2s_mode_t(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN),
+        .sample_rate = int(this->sample_rate_),
+        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+        .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
+        .communication_format = I2S_COMM_FORMAT_I2S_MSB,
+        .intr_alloc_flags = 0,
+        .dma_buf_count = ADC_DMA_BUFFERS,
+        .dma_buf_len = int(this->block_size_),
+        .use_apll = false,
+    };
+    // the completed DMA buffers are counted through the event queue to detect overruns
+    if (i2s_driver_install(ADC_I2S_PORT, &config, ADC_DMA_BUFFERS * 2, &this->i2s_events_) != ESP_OK) {
+      ESP_LOGE(TAG, "Installing the I2S driver failed, is another ADC sensor already sampling continuously?");
+      this->mark_failed();
+      return;
+    }
+    i2s_set_adc_mode(ADC_UNIT_1, channel);
+    adc1_config_channel_atten(channel, adc_atten_t(this->attenuation_));
+    i2s_adc_enable(ADC_I2S_PORT);
+
+    this->raw_.reset(new uint16_t[this->block_size_]);
+    this->block_.reset(new float[this->block_size_]);
+  }
 #endif
 }
+#ifdef ARDUINO_ARCH_ESP32
+void ADCSensor::loop() {
+  if (this->sample_rate_ == 0)
+    return;
+  // loop() reads all completed buffers, so once ADC_DMA_BUFFERS completed in between the oldest was overwritten
+  uint32_t completed = 0;
+  i2s_event_t event;
+  while (xQueueReceive(this->i2s_events_, &event, 0) == pdTRUE) {
+    if (event.type == I2S_EVENT_RX_DONE)
+      completed++;
+    else if (event.type == I2S_EVENT_DMA_ERROR)
+      this->lost_blocks_++;
+  }
+  if (completed >= ADC_DMA_BUFFERS)
+    this->lost_blocks_ += completed - (ADC_DMA_BUFFERS - 1);
+
+  const size_t block_bytes = this->block_size_ * sizeof(uint16_t);
+  while (true) {
+    size_t bytes_read = 0;
+    auto *dest = reinterpret_cast<uint8_t *>(this->raw_.get()) + this->raw_size_;
+    // don't block, the rest of this block is read in the next loop()
+    i2s_read(ADC_I2S_PORT, dest, block_bytes - this->raw_size_, &bytes_read, 0);
+    this->raw_size_ += bytes_read;
+    if (this->raw_size_ < block_bytes)
+      return;
+    this->raw_size_ = 0;
+
+    const float scale = this->full_scale_voltage_() / 4095.0f;
+    const uint16_t *raw = this->raw_.get();
+    float *block = this->block_.get();
+    // the I2S peripheral stores the 16 bit samples of a 32 bit word in swapped order, the upper 4 bits of a
+    // sample are the channel
+    for (size_t i = 0; i + 1 < this->block_size_; i += 2) {
+      block[i] = (raw[i + 1] & 0x0FFF) * scale;
+      block[i + 1] = (raw[i] & 0x0FFF) * scale;
+    }
+    this->last_block_mean_ = voltage_sampler::block_mean(block, this->block_size_);
+    this->sample_block_callback_.call(block, this->block_size_);
+  }
+}
+#endif
 void ADCSensor::dump_config() {
   LOG_SENSOR("", "ADC Sensor", this);
 #ifdef ARDUINO_ARCH_ESP8266
@@ -47,33 +185,31 @@ void ADCSensor::dump_config() {
       ESP_LOGCONFIG(TAG, " Attenuation: 11db (max 3.9V)");
       break;
   }
+  if (this->sample_rate_ != 0)
+    ESP_LOGCONFIG(TAG, "  Continuous Sampling: %u Hz in blocks of %u samples", this->sample_rate_,
+                  this->block_size_);  // NOLINT
 #endif
   LOG_UPDATE_INTERVAL(this);
 }
 float ADCSensor::get_setup_priority() const { return setup_priority::DATA; }
 void ADCSensor::update() {
+#ifdef ARDUINO_ARCH_ESP32
+  if (this->lost_blocks_ != 0) {
+    ESP_LOGW(TAG, "'%s': Lost %u sample blocks, loop() doesn't keep up with the sample rate",
+             this->get_name().c_str(), this->lost_blocks_);
+    this->lost_blocks_ = 0;
+  }
+#endif
   float value_v = this->sample();
   ESP_LOGD(TAG, "'%s': Got voltage=%.2fV", this->get_name().c_str(), value_v);
   this->publish_state(value_v);
 }
 float ADCSensor::sample() {
 #ifdef ARDUINO_ARCH_ESP32
-  float value_v = analogRead(this->pin_) / 4095.0f;
-  switch (this->attenuation_) {
-    case ADC_0db:
-      value_v *= 1.1;
-      break;
-    case ADC_2_5db:
-      value_v *= 1.5;
-      break;
-    case ADC_6db:
-      value_v *= 2.2;
-      break;
-    case ADC_11db:
-      value_v *= 3.9;
-      break;
-  }
-  return value_v;
+  // analogRead() would stop the continuous sampling of the I2S peripheral
+  if (this->sample_rate_ != 0)
+    return this->last_block_mean_;
+  return analogRead(this->pin_) / 4095.0f * this->full_scale_voltage_();
 #endif
 
 #ifdef ARDUINO_ARCH_ESP8266
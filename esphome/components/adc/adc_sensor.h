@@ -6,6 +6,10 @@
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/voltage_sampler/voltage_sampler.h"
 
+#ifdef ARDUINO_ARCH_ESP32
+#include <memory>
+#endif
+
 namespace esphome {
 namespace adc {
 
@@ -14,6 +18,15 @@ class ADCSensor : public sensor::Sensor, public PollingComponent, public voltage
 #ifdef ARDUINO_ARCH_ESP32
   /// Set the attenuation for this pin. Only available on the ESP32.
   void set_attenuation(adc_attenuation_t attenuation);
+  /** Sample continuously with the I2S peripheral and DMA instead of one analogRead() per sample.
+   *
+   * Only available on the ESP32, for ADC1 pins and one sensor at a time. The samples are delivered in blocks of
+   * block_size to the sample block callbacks, sample() returns the mean of the last block.
+   */
+  void set_continuous(uint32_t sample_rate, size_t block_size);
+  bool add_on_sample_block_callback(voltage_sampler::sample_block_callback_t &&callback) override;
+  /// Hand the blocks that the DMA has completed since the last call to the sample block callbacks.
+  void loop() override;
 #endif
 
   /// Update adc values.
@@ -34,7 +47,23 @@ class ADCSensor : public sensor::Sensor, public PollingComponent, public voltage
   uint8_t pin_;
 
 #ifdef ARDUINO_ARCH_ESP32
+  /// The full-scale voltage of the configured attenuation.
+  float full_scale_voltage_() const;
+
   adc_attenuation_t attenuation_{ADC_0db};
+  /// The I2S sample rate in continuous mode, 0 if the pin is read with analogRead().
+  uint32_t sample_rate_{0};
+  size_t block_size_{0};
+  /// Raw I2S data of the block that is currently being received.
+  std::unique_ptr<uint16_t[]> raw_;
+  size_t raw_size_{0};
+  std::unique_ptr<float[]> block_;
+  float last_block_mean_{NAN};
+  /// Events of the I2S driver, one per completed DMA buffer.
+  QueueHandle_t i2s_events_{nullptr};
+  /// Blocks overwritten before loop() read them since the last update().
+  uint32_t lost_blocks_{0};
+  CallbackManager<void(const float *, size_t)> sample_block_callback_{};
 #endif
 };
 
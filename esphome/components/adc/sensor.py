@@ -1,3 +1,5 @@
+import math
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import pins
@@ -22,16 +24,55 @@ def validate_adc_pin(value):
     return pins.analog_pin(value)
 
 
+CONF_CONTINUOUS = 'continuous'
+CONF_SAMPLE_RATE = 'sample_rate'
+CONF_BLOCK_SIZE = 'block_size'
+
+# GPIOs of ADC1, the only ADC that the I2S peripheral can sample from
+ADC1_PINS = [32, 33, 34, 35, 36, 37, 38, 39]
+# ADC_DMA_BUFFERS in adc_sensor.cpp, one of them is being filled while the others wait for loop()
+ADC_DMA_BUFFERS = 4
+# Blocks are read in loop(), which runs every 16ms. Buffer twice that as loop iterations often take longer.
+MIN_BUFFERED_TIME = 0.032
+
+
+def validate_block_size(value):
+    value = cv.int_range(min=8, max=1024)(value)
+    if value % 2 != 0:
+        raise cv.Invalid("block_size must be a multiple of 2")
+    return value
+
+
+def validate_continuous(config):
+    if CONF_CONTINUOUS not in config:
+        return config
+    if config[CONF_PIN] not in ADC1_PINS:
+        raise cv.Invalid("Continuous sampling is only possible on the ADC1 pins GPIO32-GPIO39",
+                         [CONF_CONTINUOUS])
+    conf = config[CONF_CONTINUOUS]
+    buffered = (ADC_DMA_BUFFERS - 1) * conf[CONF_BLOCK_SIZE] / float(conf[CONF_SAMPLE_RATE])
+    if buffered < MIN_BUFFERED_TIME:
+        min_block_size = int(math.ceil(MIN_BUFFERED_TIME * conf[CONF_SAMPLE_RATE] / (ADC_DMA_BUFFERS - 1) / 2)) * 2
+        raise cv.Invalid("The DMA buffers only hold {:.1f}ms of samples, which would be lost between two "
+                         "loop iterations. Use a block_size of at least {} or a lower sample_rate"
+                         "".format(buffered * 1000, min_block_size), [CONF_CONTINUOUS, CONF_BLOCK_SIZE])
+    return config
+
+
 adc_ns = cg.esphome_ns.namespace('adc')
 ADCSensor = adc_ns.class_('ADCSensor', sensor.Sensor, cg.PollingComponent,
                           voltage_sampler.VoltageSampler)
 
-CONFIG_SCHEMA = sensor.sensor_schema(UNIT_VOLT, ICON_FLASH, 2).extend({
+CONFIG_SCHEMA = cv.All(sensor.sensor_schema(UNIT_VOLT, ICON_FLASH, 2).extend({
     cv.GenerateID(): cv.declare_id(ADCSensor),
     cv.Required(CONF_PIN): validate_adc_pin,
     cv.SplitDefault(CONF_ATTENUATION, esp32='0db'):
         cv.All(cv.only_on_esp32, cv.enum(ATTENUATION_MODES, lower=True)),
-}).extend(cv.polling_component_schema('60s'))
+    cv.Optional(CONF_CONTINUOUS): cv.All(cv.only_on_esp32, cv.Schema({
+        cv.Optional(CONF_SAMPLE_RATE, default='10kHz'): cv.All(cv.frequency, cv.Range(min=1000, max=150000)),
+        cv.Optional(CONF_BLOCK_SIZE, default=256): validate_block_size,
+    })),
+}).extend(cv.polling_component_schema('60s')), validate_continuous)
 
 
 def to_code(config):
@@ -46,3 +87,6 @@ def to_code(config):
 
     if CONF_ATTENUATION in config:
         cg.add(var.set_attenuation(config[CONF_ATTENUATION]))
+    if CONF_CONTINUOUS in config:
+        conf = config[CONF_CONTINUOUS]
+        cg.add(var.set_continuous(int(conf[CONF_SAMPLE_RATE]), conf[CONF_BLOCK_SIZE]))
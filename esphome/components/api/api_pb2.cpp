@@ -0,0 +1,426 @@
+// This file was automatically generated with script/api_protobuf.py
+// from api.proto - do not edit it by hand.
+
+#include "api_pb2.h"
+#include <cstddef>
+
+// the structs are not standard-layout because of their std::string members, but offsetof
+// is well-defined for them with GCC
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+
+namespace esphome {
+namespace api {
+
+static const ProtoField HELLO_REQUEST_FIELDS[1] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(HelloRequest, client_info), nullptr, nullptr},
+};
+const ProtoMessageInfo HelloRequest::INFO PROGMEM = {HELLO_REQUEST_FIELDS, 1};
+
+static const ProtoField HELLO_RESPONSE_FIELDS[3] PROGMEM = {
+    {PROTO_TYPE_UINT32, false, offsetof(HelloResponse, api_version_major), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(HelloResponse, api_version_minor), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(HelloResponse, server_info), nullptr, nullptr},
+};
+const ProtoMessageInfo HelloResponse::INFO PROGMEM = {HELLO_RESPONSE_FIELDS, 3};
+
+static const ProtoField CONNECT_REQUEST_FIELDS[1] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ConnectRequest, password), nullptr, nullptr},
+};
+const ProtoMessageInfo ConnectRequest::INFO PROGMEM = {CONNECT_REQUEST_FIELDS, 1};
+
+static const ProtoField CONNECT_RESPONSE_FIELDS[1] PROGMEM = {
+    {PROTO_TYPE_BOOL, false, offsetof(ConnectResponse, invalid_password), nullptr, nullptr},
+};
+const ProtoMessageInfo ConnectResponse::INFO PROGMEM = {CONNECT_RESPONSE_FIELDS, 1};
+
+const ProtoMessageInfo DisconnectRequest::INFO PROGMEM = {nullptr, 0};
+
+const ProtoMessageInfo DisconnectResponse::INFO PROGMEM = {nullptr, 0};
+
+const ProtoMessageInfo PingRequest::INFO PROGMEM = {nullptr, 0};
+
+const ProtoMessageInfo PingResponse::INFO PROGMEM = {nullptr, 0};
+
+const ProtoMessageInfo DeviceInfoRequest::INFO PROGMEM = {nullptr, 0};
+
+static const ProtoField DEVICE_INFO_RESPONSE_FIELDS[7] PROGMEM = {
+    {PROTO_TYPE_BOOL, false, offsetof(DeviceInfoResponse, uses_password), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(DeviceInfoResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(DeviceInfoResponse, mac_address), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(DeviceInfoResponse, esphome_core_version), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(DeviceInfoResponse, compilation_time), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(DeviceInfoResponse, model), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(DeviceInfoResponse, has_deep_sleep), nullptr, nullptr},
+};
+const ProtoMessageInfo DeviceInfoResponse::INFO PROGMEM = {DEVICE_INFO_RESPONSE_FIELDS, 7};
+
+const ProtoMessageInfo ListEntitiesRequest::INFO PROGMEM = {nullptr, 0};
+
+const ProtoMessageInfo ListEntitiesDoneResponse::INFO PROGMEM = {nullptr, 0};
+
+static const ProtoField SUBSCRIBE_STATES_THROTTLE_FIELDS[4] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(SubscribeStatesThrottle, key), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(SubscribeStatesThrottle, entity_type), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(SubscribeStatesThrottle, min_interval), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(SubscribeStatesThrottle, deadband), nullptr, nullptr},
+};
+const ProtoMessageInfo SubscribeStatesThrottle::INFO PROGMEM = {SUBSCRIBE_STATES_THROTTLE_FIELDS, 4};
+
+static const ProtoField SUBSCRIBE_STATES_REQUEST_FIELDS[1] PROGMEM = {
+    {PROTO_TYPE_MESSAGE, true, offsetof(SubscribeStatesRequest, throttles), &SubscribeStatesThrottle::INFO,
+     &ProtoRepeated<SubscribeStatesThrottle>::OPS},
+};
+const ProtoMessageInfo SubscribeStatesRequest::INFO PROGMEM = {SUBSCRIBE_STATES_REQUEST_FIELDS, 1};
+
+static const ProtoField LIST_ENTITIES_BINARY_SENSOR_RESPONSE_FIELDS[6] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesBinarySensorResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesBinarySensorResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesBinarySensorResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesBinarySensorResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesBinarySensorResponse, device_class), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesBinarySensorResponse, is_status_binary_sensor), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesBinarySensorResponse::INFO PROGMEM = {LIST_ENTITIES_BINARY_SENSOR_RESPONSE_FIELDS,
+                                                                         6};
+
+static const ProtoField BINARY_SENSOR_STATE_RESPONSE_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(BinarySensorStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(BinarySensorStateResponse, state), nullptr, nullptr},
+};
+const ProtoMessageInfo BinarySensorStateResponse::INFO PROGMEM = {BINARY_SENSOR_STATE_RESPONSE_FIELDS, 2};
+
+static const ProtoField LIST_ENTITIES_COVER_RESPONSE_FIELDS[8] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCoverResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesCoverResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCoverResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCoverResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesCoverResponse, assumed_state), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesCoverResponse, supports_position), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesCoverResponse, supports_tilt), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCoverResponse, device_class), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesCoverResponse::INFO PROGMEM = {LIST_ENTITIES_COVER_RESPONSE_FIELDS, 8};
+
+static const ProtoField COVER_STATE_RESPONSE_FIELDS[5] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(CoverStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(CoverStateResponse, legacy_state), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(CoverStateResponse, position), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(CoverStateResponse, tilt), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(CoverStateResponse, current_operation), nullptr, nullptr},
+};
+const ProtoMessageInfo CoverStateResponse::INFO PROGMEM = {COVER_STATE_RESPONSE_FIELDS, 5};
+
+static const ProtoField COVER_COMMAND_REQUEST_FIELDS[8] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(CoverCommandRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(CoverCommandRequest, has_legacy_command), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(CoverCommandRequest, legacy_command), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(CoverCommandRequest, has_position), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(CoverCommandRequest, position), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(CoverCommandRequest, has_tilt), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(CoverCommandRequest, tilt), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(CoverCommandRequest, stop), nullptr, nullptr},
+};
+const ProtoMessageInfo CoverCommandRequest::INFO PROGMEM = {COVER_COMMAND_REQUEST_FIELDS, 8};
+
+static const ProtoField LIST_ENTITIES_FAN_RESPONSE_FIELDS[6] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesFanResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesFanResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesFanResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesFanResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesFanResponse, supports_oscillation), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesFanResponse, supports_speed), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesFanResponse::INFO PROGMEM = {LIST_ENTITIES_FAN_RESPONSE_FIELDS, 6};
+
+static const ProtoField FAN_STATE_RESPONSE_FIELDS[4] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(FanStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanStateResponse, state), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanStateResponse, oscillating), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(FanStateResponse, speed), nullptr, nullptr},
+};
+const ProtoMessageInfo FanStateResponse::INFO PROGMEM = {FAN_STATE_RESPONSE_FIELDS, 4};
+
+static const ProtoField FAN_COMMAND_REQUEST_FIELDS[7] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(FanCommandRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanCommandRequest, has_state), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanCommandRequest, state), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanCommandRequest, has_speed), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(FanCommandRequest, speed), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanCommandRequest, has_oscillating), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(FanCommandRequest, oscillating), nullptr, nullptr},
+};
+const ProtoMessageInfo FanCommandRequest::INFO PROGMEM = {FAN_COMMAND_REQUEST_FIELDS, 7};
+
+static const ProtoField LIST_ENTITIES_LIGHT_RESPONSE_FIELDS[11] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesLightResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesLightResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesLightResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesLightResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesLightResponse, supports_brightness), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesLightResponse, supports_rgb), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesLightResponse, supports_white_value), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesLightResponse, supports_color_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ListEntitiesLightResponse, min_mireds), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ListEntitiesLightResponse, max_mireds), nullptr, nullptr},
+    {PROTO_TYPE_STRING, true, offsetof(ListEntitiesLightResponse, effects), nullptr, &ProtoRepeated<std::string>::OPS},
+};
+const ProtoMessageInfo ListEntitiesLightResponse::INFO PROGMEM = {LIST_ENTITIES_LIGHT_RESPONSE_FIELDS, 11};
+
+static const ProtoField LIGHT_STATE_RESPONSE_FIELDS[9] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(LightStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightStateResponse, state), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightStateResponse, brightness), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightStateResponse, red), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightStateResponse, green), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightStateResponse, blue), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightStateResponse, white), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightStateResponse, color_temperature), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(LightStateResponse, effect), nullptr, nullptr},
+};
+const ProtoMessageInfo LightStateResponse::INFO PROGMEM = {LIGHT_STATE_RESPONSE_FIELDS, 9};
+
+static const ProtoField LIGHT_COMMAND_REQUEST_FIELDS[19] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(LightCommandRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_state), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, state), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_brightness), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightCommandRequest, brightness), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_rgb), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightCommandRequest, red), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightCommandRequest, green), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightCommandRequest, blue), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_white), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightCommandRequest, white), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_color_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(LightCommandRequest, color_temperature), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_transition_length), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(LightCommandRequest, transition_length), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_flash_length), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(LightCommandRequest, flash_length), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(LightCommandRequest, has_effect), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(LightCommandRequest, effect), nullptr, nullptr},
+};
+const ProtoMessageInfo LightCommandRequest::INFO PROGMEM = {LIGHT_COMMAND_REQUEST_FIELDS, 19};
+
+static const ProtoField LIST_ENTITIES_SENSOR_RESPONSE_FIELDS[7] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSensorResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesSensorResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSensorResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSensorResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSensorResponse, icon), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSensorResponse, unit_of_measurement), nullptr, nullptr},
+    {PROTO_TYPE_INT32, false, offsetof(ListEntitiesSensorResponse, accuracy_decimals), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesSensorResponse::INFO PROGMEM = {LIST_ENTITIES_SENSOR_RESPONSE_FIELDS, 7};
+
+static const ProtoField SENSOR_STATE_RESPONSE_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(SensorStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(SensorStateResponse, state), nullptr, nullptr},
+};
+const ProtoMessageInfo SensorStateResponse::INFO PROGMEM = {SENSOR_STATE_RESPONSE_FIELDS, 2};
+
+static const ProtoField LIST_ENTITIES_SWITCH_RESPONSE_FIELDS[6] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSwitchResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesSwitchResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSwitchResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSwitchResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesSwitchResponse, icon), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesSwitchResponse, assumed_state), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesSwitchResponse::INFO PROGMEM = {LIST_ENTITIES_SWITCH_RESPONSE_FIELDS, 6};
+
+static const ProtoField SWITCH_STATE_RESPONSE_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(SwitchStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(SwitchStateResponse, state), nullptr, nullptr},
+};
+const ProtoMessageInfo SwitchStateResponse::INFO PROGMEM = {SWITCH_STATE_RESPONSE_FIELDS, 2};
+
+static const ProtoField SWITCH_COMMAND_REQUEST_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(SwitchCommandRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(SwitchCommandRequest, state), nullptr, nullptr},
+};
+const ProtoMessageInfo SwitchCommandRequest::INFO PROGMEM = {SWITCH_COMMAND_REQUEST_FIELDS, 2};
+
+static const ProtoField LIST_ENTITIES_TEXT_SENSOR_RESPONSE_FIELDS[5] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesTextSensorResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesTextSensorResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesTextSensorResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesTextSensorResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesTextSensorResponse, icon), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesTextSensorResponse::INFO PROGMEM = {LIST_ENTITIES_TEXT_SENSOR_RESPONSE_FIELDS, 5};
+
+static const ProtoField TEXT_SENSOR_STATE_RESPONSE_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(TextSensorStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(TextSensorStateResponse, state), nullptr, nullptr},
+};
+const ProtoMessageInfo TextSensorStateResponse::INFO PROGMEM = {TEXT_SENSOR_STATE_RESPONSE_FIELDS, 2};
+
+static const ProtoField SUBSCRIBE_LOGS_REQUEST_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_ENUM, false, offsetof(SubscribeLogsRequest, level), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(SubscribeLogsRequest, dump_config), nullptr, nullptr},
+};
+const ProtoMessageInfo SubscribeLogsRequest::INFO PROGMEM = {SUBSCRIBE_LOGS_REQUEST_FIELDS, 2};
+
+static const ProtoField SUBSCRIBE_LOGS_RESPONSE_FIELDS[4] PROGMEM = {
+    {PROTO_TYPE_ENUM, false, offsetof(SubscribeLogsResponse, level), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(SubscribeLogsResponse, tag), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(SubscribeLogsResponse, message), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(SubscribeLogsResponse, send_failed), nullptr, nullptr},
+};
+const ProtoMessageInfo SubscribeLogsResponse::INFO PROGMEM = {SUBSCRIBE_LOGS_RESPONSE_FIELDS, 4};
+
+const ProtoMessageInfo SubscribeServiceCallsRequest::INFO PROGMEM = {nullptr, 0};
+
+static const ProtoField SERVICE_CALL_MAP_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ServiceCallMap, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ServiceCallMap, value), nullptr, nullptr},
+};
+const ProtoMessageInfo ServiceCallMap::INFO PROGMEM = {SERVICE_CALL_MAP_FIELDS, 2};
+
+static const ProtoField SERVICE_CALL_RESPONSE_FIELDS[4] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ServiceCallResponse, service), nullptr, nullptr},
+    {PROTO_TYPE_MESSAGE, true, offsetof(ServiceCallResponse, data), &ServiceCallMap::INFO,
+     &ProtoRepeated<ServiceCallMap>::OPS},
+    {PROTO_TYPE_MESSAGE, true, offsetof(ServiceCallResponse, data_template), &ServiceCallMap::INFO,
+     &ProtoRepeated<ServiceCallMap>::OPS},
+    {PROTO_TYPE_MESSAGE, true, offsetof(ServiceCallResponse, variables), &ServiceCallMap::INFO,
+     &ProtoRepeated<ServiceCallMap>::OPS},
+};
+const ProtoMessageInfo ServiceCallResponse::INFO PROGMEM = {SERVICE_CALL_RESPONSE_FIELDS, 4};
+
+const ProtoMessageInfo SubscribeHomeAssistantStatesRequest::INFO PROGMEM = {nullptr, 0};
+
+static const ProtoField SUBSCRIBE_HOME_ASSISTANT_STATE_RESPONSE_FIELDS[1] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(SubscribeHomeAssistantStateResponse, entity_id), nullptr, nullptr},
+};
+const ProtoMessageInfo SubscribeHomeAssistantStateResponse::INFO PROGMEM = {
+    SUBSCRIBE_HOME_ASSISTANT_STATE_RESPONSE_FIELDS, 1};
+
+static const ProtoField HOME_ASSISTANT_STATE_RESPONSE_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(HomeAssistantStateResponse, entity_id), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(HomeAssistantStateResponse, state), nullptr, nullptr},
+};
+const ProtoMessageInfo HomeAssistantStateResponse::INFO PROGMEM = {HOME_ASSISTANT_STATE_RESPONSE_FIELDS, 2};
+
+const ProtoMessageInfo GetTimeRequest::INFO PROGMEM = {nullptr, 0};
+
+static const ProtoField GET_TIME_RESPONSE_FIELDS[1] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(GetTimeResponse, epoch_seconds), nullptr, nullptr},
+};
+const ProtoMessageInfo GetTimeResponse::INFO PROGMEM = {GET_TIME_RESPONSE_FIELDS, 1};
+
+static const ProtoField LIST_ENTITIES_SERVICES_ARGUMENT_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesServicesArgument, name), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(ListEntitiesServicesArgument, type), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesServicesArgument::INFO PROGMEM = {LIST_ENTITIES_SERVICES_ARGUMENT_FIELDS, 2};
+
+static const ProtoField LIST_ENTITIES_SERVICES_RESPONSE_FIELDS[3] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesServicesResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesServicesResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_MESSAGE, true, offsetof(ListEntitiesServicesResponse, args), &ListEntitiesServicesArgument::INFO,
+     &ProtoRepeated<ListEntitiesServicesArgument>::OPS},
+};
+const ProtoMessageInfo ListEntitiesServicesResponse::INFO PROGMEM = {LIST_ENTITIES_SERVICES_RESPONSE_FIELDS, 3};
+
+static const ProtoField EXECUTE_SERVICE_ARGUMENT_FIELDS[4] PROGMEM = {
+    {PROTO_TYPE_BOOL, false, offsetof(ExecuteServiceArgument, bool_), nullptr, nullptr},
+    {PROTO_TYPE_INT32, false, offsetof(ExecuteServiceArgument, int_), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ExecuteServiceArgument, float_), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ExecuteServiceArgument, string_), nullptr, nullptr},
+};
+const ProtoMessageInfo ExecuteServiceArgument::INFO PROGMEM = {EXECUTE_SERVICE_ARGUMENT_FIELDS, 4};
+
+static const ProtoField EXECUTE_SERVICE_REQUEST_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(ExecuteServiceRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_MESSAGE, true, offsetof(ExecuteServiceRequest, args), &ExecuteServiceArgument::INFO,
+     &ProtoRepeated<ExecuteServiceArgument>::OPS},
+};
+const ProtoMessageInfo ExecuteServiceRequest::INFO PROGMEM = {EXECUTE_SERVICE_REQUEST_FIELDS, 2};
+
+static const ProtoField LIST_ENTITIES_CAMERA_RESPONSE_FIELDS[4] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCameraResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesCameraResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCameraResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesCameraResponse, unique_id), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesCameraResponse::INFO PROGMEM = {LIST_ENTITIES_CAMERA_RESPONSE_FIELDS, 4};
+
+static const ProtoField CAMERA_IMAGE_RESPONSE_FIELDS[3] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(CameraImageResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(CameraImageResponse, data), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(CameraImageResponse, done), nullptr, nullptr},
+};
+const ProtoMessageInfo CameraImageResponse::INFO PROGMEM = {CAMERA_IMAGE_RESPONSE_FIELDS, 3};
+
+static const ProtoField CAMERA_IMAGE_REQUEST_FIELDS[2] PROGMEM = {
+    {PROTO_TYPE_BOOL, false, offsetof(CameraImageRequest, single), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(CameraImageRequest, stream), nullptr, nullptr},
+};
+const ProtoMessageInfo CameraImageRequest::INFO PROGMEM = {CAMERA_IMAGE_REQUEST_FIELDS, 2};
+
+static const ProtoField LIST_ENTITIES_CLIMATE_RESPONSE_FIELDS[11] PROGMEM = {
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesClimateResponse, object_id), nullptr, nullptr},
+    {PROTO_TYPE_FIXED32, false, offsetof(ListEntitiesClimateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesClimateResponse, name), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(ListEntitiesClimateResponse, unique_id), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesClimateResponse, supports_current_temperature), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesClimateResponse, supports_two_point_target_temperature), nullptr,
+     nullptr},
+    {PROTO_TYPE_ENUM, true, offsetof(ListEntitiesClimateResponse, supported_modes), nullptr,
+     &ProtoRepeated<ClimateMode>::OPS},
+    {PROTO_TYPE_FLOAT, false, offsetof(ListEntitiesClimateResponse, visual_min_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ListEntitiesClimateResponse, visual_max_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ListEntitiesClimateResponse, visual_temperature_step), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ListEntitiesClimateResponse, supports_away), nullptr, nullptr},
+};
+const ProtoMessageInfo ListEntitiesClimateResponse::INFO PROGMEM = {LIST_ENTITIES_CLIMATE_RESPONSE_FIELDS, 11};
+
+static const ProtoField CLIMATE_STATE_RESPONSE_FIELDS[7] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(ClimateStateResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(ClimateStateResponse, mode), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateStateResponse, current_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateStateResponse, target_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateStateResponse, target_temperature_low), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateStateResponse, target_temperature_high), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateStateResponse, away), nullptr, nullptr},
+};
+const ProtoMessageInfo ClimateStateResponse::INFO PROGMEM = {CLIMATE_STATE_RESPONSE_FIELDS, 7};
+
+static const ProtoField CLIMATE_COMMAND_REQUEST_FIELDS[11] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(ClimateCommandRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateCommandRequest, has_mode), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(ClimateCommandRequest, mode), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateCommandRequest, has_target_temperature), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateCommandRequest, target_temperature), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateCommandRequest, has_target_temperature_low), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateCommandRequest, target_temperature_low), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateCommandRequest, has_target_temperature_high), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(ClimateCommandRequest, target_temperature_high), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateCommandRequest, has_away), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(ClimateCommandRequest, away), nullptr, nullptr},
+};
+const ProtoMessageInfo ClimateCommandRequest::INFO PROGMEM = {CLIMATE_COMMAND_REQUEST_FIELDS, 11};
+
+static const ProtoField SENSOR_HISTORY_REQUEST_FIELDS[3] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(SensorHistoryRequest, key), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(SensorHistoryRequest, tier), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(SensorHistoryRequest, max_age), nullptr, nullptr},
+};
+const ProtoMessageInfo SensorHistoryRequest::INFO PROGMEM = {SENSOR_HISTORY_REQUEST_FIELDS, 3};
+
+static const ProtoField SENSOR_HISTORY_RESPONSE_FIELDS[8] PROGMEM = {
+    {PROTO_TYPE_FIXED32, false, offsetof(SensorHistoryResponse, key), nullptr, nullptr},
+    {PROTO_TYPE_ENUM, false, offsetof(SensorHistoryResponse, tier), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(SensorHistoryResponse, period), nullptr, nullptr},
+    {PROTO_TYPE_UINT32, false, offsetof(SensorHistoryResponse, age), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(SensorHistoryResponse, base), nullptr, nullptr},
+    {PROTO_TYPE_FLOAT, false, offsetof(SensorHistoryResponse, resolution), nullptr, nullptr},
+    {PROTO_TYPE_STRING, false, offsetof(SensorHistoryResponse, points), nullptr, nullptr},
+    {PROTO_TYPE_BOOL, false, offsetof(SensorHistoryResponse, done), nullptr, nullptr},
+};
+const ProtoMessageInfo SensorHistoryResponse::INFO PROGMEM = {SENSOR_HISTORY_RESPONSE_FIELDS, 8};
+
+}  // namespace api
+}  // namespace esphome
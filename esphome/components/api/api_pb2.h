@@ -0,0 +1,645 @@
+// This file was automatically generated with script/api_protobuf.py
+// from api.proto - do not edit it by hand.
+
+#pragma once
+
+#include "proto.h"
+
+namespace esphome {
+namespace api {
+
+enum class APIMessageType {
+  HELLO_REQUEST = 1,
+  HELLO_RESPONSE = 2,
+  CONNECT_REQUEST = 3,
+  CONNECT_RESPONSE = 4,
+  DISCONNECT_REQUEST = 5,
+  DISCONNECT_RESPONSE = 6,
+  PING_REQUEST = 7,
+  PING_RESPONSE = 8,
+  DEVICE_INFO_REQUEST = 9,
+  DEVICE_INFO_RESPONSE = 10,
+  LIST_ENTITIES_REQUEST = 11,
+  LIST_ENTITIES_BINARY_SENSOR_RESPONSE = 12,
+  LIST_ENTITIES_COVER_RESPONSE = 13,
+  LIST_ENTITIES_FAN_RESPONSE = 14,
+  LIST_ENTITIES_LIGHT_RESPONSE = 15,
+  LIST_ENTITIES_SENSOR_RESPONSE = 16,
+  LIST_ENTITIES_SWITCH_RESPONSE = 17,
+  LIST_ENTITIES_TEXT_SENSOR_RESPONSE = 18,
+  LIST_ENTITIES_DONE_RESPONSE = 19,
+  SUBSCRIBE_STATES_REQUEST = 20,
+  BINARY_SENSOR_STATE_RESPONSE = 21,
+  COVER_STATE_RESPONSE = 22,
+  FAN_STATE_RESPONSE = 23,
+  LIGHT_STATE_RESPONSE = 24,
+  SENSOR_STATE_RESPONSE = 25,
+  SWITCH_STATE_RESPONSE = 26,
+  TEXT_SENSOR_STATE_RESPONSE = 27,
+  SUBSCRIBE_LOGS_REQUEST = 28,
+  SUBSCRIBE_LOGS_RESPONSE = 29,
+  COVER_COMMAND_REQUEST = 30,
+  FAN_COMMAND_REQUEST = 31,
+  LIGHT_COMMAND_REQUEST = 32,
+  SWITCH_COMMAND_REQUEST = 33,
+  SUBSCRIBE_SERVICE_CALLS_REQUEST = 34,
+  SERVICE_CALL_RESPONSE = 35,
+  GET_TIME_REQUEST = 36,
+  GET_TIME_RESPONSE = 37,
+  SUBSCRIBE_HOME_ASSISTANT_STATES_REQUEST = 38,
+  SUBSCRIBE_HOME_ASSISTANT_STATE_RESPONSE = 39,
+  HOME_ASSISTANT_STATE_RESPONSE = 40,
+  LIST_ENTITIES_SERVICES_RESPONSE = 41,
+  EXECUTE_SERVICE_REQUEST = 42,
+  LIST_ENTITIES_CAMERA_RESPONSE = 43,
+  CAMERA_IMAGE_RESPONSE = 44,
+  CAMERA_IMAGE_REQUEST = 45,
+  LIST_ENTITIES_CLIMATE_RESPONSE = 46,
+  CLIMATE_STATE_RESPONSE = 47,
+  CLIMATE_COMMAND_REQUEST = 48,
+  SENSOR_HISTORY_REQUEST = 49,
+  SENSOR_HISTORY_RESPONSE = 50,
+};
+
+enum StateEntityType : uint32_t {
+  STATE_ENTITY_TYPE_ALL = 0,
+  STATE_ENTITY_TYPE_BINARY_SENSOR = 1,
+  STATE_ENTITY_TYPE_COVER = 2,
+  STATE_ENTITY_TYPE_FAN = 3,
+  STATE_ENTITY_TYPE_LIGHT = 4,
+  STATE_ENTITY_TYPE_SENSOR = 5,
+  STATE_ENTITY_TYPE_SWITCH = 6,
+  STATE_ENTITY_TYPE_TEXT_SENSOR = 7,
+  STATE_ENTITY_TYPE_CLIMATE = 8,
+};
+
+enum LegacyCoverState : uint32_t {
+  LEGACY_COVER_STATE_OPEN = 0,
+  LEGACY_COVER_STATE_CLOSED = 1,
+};
+
+enum CoverOperation : uint32_t {
+  COVER_OPERATION_IDLE = 0,
+  COVER_OPERATION_IS_OPENING = 1,
+  COVER_OPERATION_IS_CLOSING = 2,
+};
+
+enum LegacyCoverCommand : uint32_t {
+  LEGACY_COVER_COMMAND_OPEN = 0,
+  LEGACY_COVER_COMMAND_CLOSE = 1,
+  LEGACY_COVER_COMMAND_STOP = 2,
+};
+
+enum FanSpeed : uint32_t {
+  FAN_SPEED_LOW = 0,
+  FAN_SPEED_MEDIUM = 1,
+  FAN_SPEED_HIGH = 2,
+};
+
+enum LogLevel : uint32_t {
+  LOG_LEVEL_NONE = 0,
+  LOG_LEVEL_ERROR = 1,
+  LOG_LEVEL_WARN = 2,
+  LOG_LEVEL_INFO = 3,
+  LOG_LEVEL_DEBUG = 4,
+  LOG_LEVEL_VERBOSE = 5,
+  LOG_LEVEL_VERY_VERBOSE = 6,
+};
+
+enum ServiceArgType : uint32_t {
+  SERVICE_ARG_TYPE_BOOL = 0,
+  SERVICE_ARG_TYPE_INT = 1,
+  SERVICE_ARG_TYPE_FLOAT = 2,
+  SERVICE_ARG_TYPE_STRING = 3,
+};
+
+enum ClimateMode : uint32_t {
+  CLIMATE_MODE_OFF = 0,
+  CLIMATE_MODE_AUTO = 1,
+  CLIMATE_MODE_COOL = 2,
+  CLIMATE_MODE_HEAT = 3,
+};
+
+enum SensorHistoryTier : uint32_t {
+  SENSOR_HISTORY_TIER_RAW = 0,
+  SENSOR_HISTORY_TIER_MINUTES = 1,
+  SENSOR_HISTORY_TIER_HOURS = 2,
+};
+
+struct HelloRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::HELLO_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  std::string client_info;
+};
+
+struct HelloResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::HELLO_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t api_version_major{0};
+  uint32_t api_version_minor{0};
+  std::string server_info;
+};
+
+struct ConnectRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::CONNECT_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  std::string password;
+};
+
+struct ConnectResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::CONNECT_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  bool invalid_password{false};
+};
+
+struct DisconnectRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::DISCONNECT_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct DisconnectResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::DISCONNECT_RESPONSE;
+  static const ProtoMessageInfo INFO;
+};
+
+struct PingRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::PING_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct PingResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::PING_RESPONSE;
+  static const ProtoMessageInfo INFO;
+};
+
+struct DeviceInfoRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::DEVICE_INFO_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct DeviceInfoResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::DEVICE_INFO_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  bool uses_password{false};
+  std::string name;
+  std::string mac_address;
+  std::string esphome_core_version;
+  std::string compilation_time;
+  std::string model;
+  bool has_deep_sleep{false};
+};
+
+struct ListEntitiesRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct ListEntitiesDoneResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_DONE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+};
+
+struct SubscribeStatesThrottle {
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  StateEntityType entity_type{STATE_ENTITY_TYPE_ALL};
+  uint32_t min_interval{0};
+  float deadband{0.0f};
+};
+
+struct SubscribeStatesRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SUBSCRIBE_STATES_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  std::vector<SubscribeStatesThrottle> throttles;
+};
+
+struct ListEntitiesBinarySensorResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_BINARY_SENSOR_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  std::string device_class;
+  bool is_status_binary_sensor{false};
+};
+
+struct BinarySensorStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::BINARY_SENSOR_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool state{false};
+};
+
+struct ListEntitiesCoverResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_COVER_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  bool assumed_state{false};
+  bool supports_position{false};
+  bool supports_tilt{false};
+  std::string device_class;
+};
+
+struct CoverStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::COVER_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  LegacyCoverState legacy_state{LEGACY_COVER_STATE_OPEN};
+  float position{0.0f};
+  float tilt{0.0f};
+  CoverOperation current_operation{COVER_OPERATION_IDLE};
+};
+
+struct CoverCommandRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::COVER_COMMAND_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool has_legacy_command{false};
+  LegacyCoverCommand legacy_command{LEGACY_COVER_COMMAND_OPEN};
+  bool has_position{false};
+  float position{0.0f};
+  bool has_tilt{false};
+  float tilt{0.0f};
+  bool stop{false};
+};
+
+struct ListEntitiesFanResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_FAN_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  bool supports_oscillation{false};
+  bool supports_speed{false};
+};
+
+struct FanStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::FAN_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool state{false};
+  bool oscillating{false};
+  FanSpeed speed{FAN_SPEED_LOW};
+};
+
+struct FanCommandRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::FAN_COMMAND_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool has_state{false};
+  bool state{false};
+  bool has_speed{false};
+  FanSpeed speed{FAN_SPEED_LOW};
+  bool has_oscillating{false};
+  bool oscillating{false};
+};
+
+struct ListEntitiesLightResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_LIGHT_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  bool supports_brightness{false};
+  bool supports_rgb{false};
+  bool supports_white_value{false};
+  bool supports_color_temperature{false};
+  float min_mireds{0.0f};
+  float max_mireds{0.0f};
+  std::vector<std::string> effects;
+};
+
+struct LightStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIGHT_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool state{false};
+  float brightness{0.0f};
+  float red{0.0f};
+  float green{0.0f};
+  float blue{0.0f};
+  float white{0.0f};
+  float color_temperature{0.0f};
+  std::string effect;
+};
+
+struct LightCommandRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIGHT_COMMAND_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool has_state{false};
+  bool state{false};
+  bool has_brightness{false};
+  float brightness{0.0f};
+  bool has_rgb{false};
+  float red{0.0f};
+  float green{0.0f};
+  float blue{0.0f};
+  bool has_white{false};
+  float white{0.0f};
+  bool has_color_temperature{false};
+  float color_temperature{0.0f};
+  bool has_transition_length{false};
+  uint32_t transition_length{0};
+  bool has_flash_length{false};
+  uint32_t flash_length{0};
+  bool has_effect{false};
+  std::string effect;
+};
+
+struct ListEntitiesSensorResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_SENSOR_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  std::string icon;
+  std::string unit_of_measurement;
+  int32_t accuracy_decimals{0};
+};
+
+struct SensorStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SENSOR_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  float state{0.0f};
+};
+
+struct ListEntitiesSwitchResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_SWITCH_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  std::string icon;
+  bool assumed_state{false};
+};
+
+struct SwitchStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SWITCH_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool state{false};
+};
+
+struct SwitchCommandRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SWITCH_COMMAND_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool state{false};
+};
+
+struct ListEntitiesTextSensorResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_TEXT_SENSOR_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  std::string icon;
+};
+
+struct TextSensorStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::TEXT_SENSOR_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  std::string state;
+};
+
+struct SubscribeLogsRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SUBSCRIBE_LOGS_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  LogLevel level{LOG_LEVEL_NONE};
+  bool dump_config{false};
+};
+
+struct SubscribeLogsResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SUBSCRIBE_LOGS_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  LogLevel level{LOG_LEVEL_NONE};
+  std::string tag;
+  std::string message;
+  bool send_failed{false};
+};
+
+struct SubscribeServiceCallsRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SUBSCRIBE_SERVICE_CALLS_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct ServiceCallMap {
+  static const ProtoMessageInfo INFO;
+
+  std::string key;
+  std::string value;
+};
+
+struct ServiceCallResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SERVICE_CALL_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string service;
+  std::vector<ServiceCallMap> data;
+  std::vector<ServiceCallMap> data_template;
+  std::vector<ServiceCallMap> variables;
+};
+
+struct SubscribeHomeAssistantStatesRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SUBSCRIBE_HOME_ASSISTANT_STATES_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct SubscribeHomeAssistantStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SUBSCRIBE_HOME_ASSISTANT_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string entity_id;
+};
+
+struct HomeAssistantStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::HOME_ASSISTANT_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string entity_id;
+  std::string state;
+};
+
+struct GetTimeRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::GET_TIME_REQUEST;
+  static const ProtoMessageInfo INFO;
+};
+
+struct GetTimeResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::GET_TIME_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t epoch_seconds{0};
+};
+
+struct ListEntitiesServicesArgument {
+  static const ProtoMessageInfo INFO;
+
+  std::string name;
+  ServiceArgType type{SERVICE_ARG_TYPE_BOOL};
+};
+
+struct ListEntitiesServicesResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_SERVICES_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string name;
+  uint32_t key{0};
+  std::vector<ListEntitiesServicesArgument> args;
+};
+
+struct ExecuteServiceArgument {
+  static const ProtoMessageInfo INFO;
+
+  bool bool_{false};
+  int32_t int_{0};
+  float float_{0.0f};
+  std::string string_;
+};
+
+struct ExecuteServiceRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::EXECUTE_SERVICE_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  std::vector<ExecuteServiceArgument> args;
+};
+
+struct ListEntitiesCameraResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_CAMERA_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+};
+
+struct CameraImageResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::CAMERA_IMAGE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  std::string data;
+  bool done{false};
+};
+
+struct CameraImageRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::CAMERA_IMAGE_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  bool single{false};
+  bool stream{false};
+};
+
+struct ListEntitiesClimateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::LIST_ENTITIES_CLIMATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  std::string object_id;
+  uint32_t key{0};
+  std::string name;
+  std::string unique_id;
+  bool supports_current_temperature{false};
+  bool supports_two_point_target_temperature{false};
+  std::vector<ClimateMode> supported_modes;
+  float visual_min_temperature{0.0f};
+  float visual_max_temperature{0.0f};
+  float visual_temperature_step{0.0f};
+  bool supports_away{false};
+};
+
+struct ClimateStateResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::CLIMATE_STATE_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  ClimateMode mode{CLIMATE_MODE_OFF};
+  float current_temperature{0.0f};
+  float target_temperature{0.0f};
+  float target_temperature_low{0.0f};
+  float target_temperature_high{0.0f};
+  bool away{false};
+};
+
+struct ClimateCommandRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::CLIMATE_COMMAND_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  bool has_mode{false};
+  ClimateMode mode{CLIMATE_MODE_OFF};
+  bool has_target_temperature{false};
+  float target_temperature{0.0f};
+  bool has_target_temperature_low{false};
+  float target_temperature_low{0.0f};
+  bool has_target_temperature_high{false};
+  float target_temperature_high{0.0f};
+  bool has_away{false};
+  bool away{false};
+};
+
+struct SensorHistoryRequest {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SENSOR_HISTORY_REQUEST;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  SensorHistoryTier tier{SENSOR_HISTORY_TIER_RAW};
+  uint32_t max_age{0};
+};
+
+struct SensorHistoryResponse {
+  static const APIMessageType MESSAGE_TYPE = APIMessageType::SENSOR_HISTORY_RESPONSE;
+  static const ProtoMessageInfo INFO;
+
+  uint32_t key{0};
+  SensorHistoryTier tier{SENSOR_HISTORY_TIER_RAW};
+  uint32_t period{0};
+  uint32_t age{0};
+  float base{0.0f};
+  float resolution{0.0f};
+  std::string points;
+  bool done{false};
+};
+
+}  // namespace api
+}  // namespace esphome
@@ -1,7 +1,6 @@
 #include <utility>
 
 #include "api_server.h"
-#include "basic_messages.h"
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
 #include "esphome/core/util.h"
@@ -25,6 +24,110 @@ namespace api {
 
 static const char *TAG = "api";
 
+/// Maximum number of entities per connection whose state is held back until TCP buffer space frees up.
+static const size_t MAX_PENDING_STATES = 32;
+
+#ifdef USE_BINARY_SENSOR
+static BinarySensorStateResponse binary_sensor_state_response(binary_sensor::BinarySensor *binary_sensor, bool state) {
+  BinarySensorStateResponse resp;
+  resp.key = binary_sensor->get_object_id_hash();
+  resp.state = state;
+  return resp;
+}
+#endif
+#ifdef USE_COVER
+static CoverStateResponse cover_state_response(cover::Cover *cover) {
+  auto traits = cover->get_traits();
+  CoverStateResponse resp;
+  resp.key = cover->get_object_id_hash();
+  resp.legacy_state = (cover->position == cover::COVER_OPEN) ? LEGACY_COVER_STATE_OPEN : LEGACY_COVER_STATE_CLOSED;
+  resp.position = cover->position;
+  if (traits.get_supports_tilt())
+    resp.tilt = cover->tilt;
+  resp.current_operation = static_cast<CoverOperation>(cover->current_operation);
+  return resp;
+}
+#endif
+#ifdef USE_FAN
+static FanStateResponse fan_state_response(fan::FanState *fan) {
+  FanStateResponse resp;
+  resp.key = fan->get_object_id_hash();
+  resp.state = fan->state;
+  if (fan->get_traits().supports_oscillation())
+    resp.oscillating = fan->oscillating;
+  if (fan->get_traits().supports_speed())
+    resp.speed = static_cast<FanSpeed>(fan->speed);
+  return resp;
+}
+#endif
+#ifdef USE_LIGHT
+static LightStateResponse light_state_response(light::LightState *light) {
+  auto traits = light->get_traits();
+  auto values = light->remote_values;
+
+  LightStateResponse resp;
+  resp.key = light->get_object_id_hash();
+  resp.state = values.get_state() != 0.0f;
+  if (traits.get_supports_brightness())
+    resp.brightness = values.get_brightness();
+  if (traits.get_supports_rgb()) {
+    resp.red = values.get_red();
+    resp.green = values.get_green();
+    resp.blue = values.get_blue();
+  }
+  if (traits.get_supports_rgb_white_value())
+    resp.white = values.get_white();
+  if (traits.get_supports_color_temperature())
+    resp.color_temperature = values.get_color_temperature();
+  if (light->supports_effects())
+    resp.effect = light->get_effect_name();
+  return resp;
+}
+#endif
+#ifdef USE_SENSOR
+static SensorStateResponse sensor_state_response(sensor::Sensor *sensor, float state) {
+  SensorStateResponse resp;
+  resp.key = sensor->get_object_id_hash();
+  resp.state = state;
+  return resp;
+}
+#endif
+#ifdef USE_SWITCH
+static SwitchStateResponse switch_state_response(switch_::Switch *a_switch, bool state) {
+  SwitchStateResponse resp;
+  resp.key = a_switch->get_object_id_hash();
+  resp.state = state;
+  return resp;
+}
+#endif
+#ifdef USE_TEXT_SENSOR
+static TextSensorStateResponse text_sensor_state_response(text_sensor::TextSensor *text_sensor, std::string state) {
+  TextSensorStateResponse resp;
+  resp.key = text_sensor->get_object_id_hash();
+  resp.state = std::move(state);
+  return resp;
+}
+#endif
+#ifdef USE_CLIMATE
+static ClimateStateResponse climate_state_response(climate::Climate *climate) {
+  auto traits = climate->get_traits();
+  ClimateStateResponse resp;
+  resp.key = climate->get_object_id_hash();
+  resp.mode = static_cast<ClimateMode>(climate->mode);
+  if (traits.get_supports_current_temperature())
+    resp.current_temperature = climate->current_temperature;
+  if (traits.get_supports_two_point_target_temperature()) {
+    resp.target_temperature_low = climate->target_temperature_low;
+    resp.target_temperature_high = climate->target_temperature_high;
+  } else {
+    resp.target_temperature = climate->target_temperature;
+  }
+  if (traits.get_supports_away())
+    resp.away = climate->away;
+  return resp;
+}
+#endif
+
 // APIServer
 void APIServer::setup() {
   ESP_LOGCONFIG(TAG, "Setting up Home Assistant API server...");
@@ -73,6 +176,12 @@ void APIServer::loop() {
   // print disconnection messages
   for (auto it = new_end; it != this->clients_.end(); ++it) {
     ESP_LOGD(TAG, "Disconnecting %s", (*it)->client_info_.c_str());
+    if ((*it)->pending_dropped_ != 0 || (*it)->pending_coalesced_ != 0) {
+      ESP_LOGD(TAG, "  State updates coalesced: %u, dropped: %u", (*it)->pending_coalesced_, (*it)->pending_dropped_);
+    }
+    if ((*it)->throttled_ != 0) {
+      ESP_LOGD(TAG, "  State updates throttled: %u", (*it)->throttled_);
+    }
   }
   // only then delete the pointers, otherwise log routine
   // would access freed memory
@@ -137,8 +246,7 @@ void APIServer::handle_disconnect(APIConnection *conn) {}
 void APIServer::on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_binary_sensor_state(obj, state);
+  this->broadcast_state_message_(obj, binary_sensor_state_response(obj, state));
 }
 #endif
 
@@ -146,8 +254,7 @@ void APIServer::on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool s
 void APIServer::on_cover_update(cover::Cover *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_cover_state(obj);
+  this->broadcast_state_message_(obj, cover_state_response(obj));
 }
 #endif
 
@@ -155,8 +262,7 @@ void APIServer::on_cover_update(cover::Cover *obj) {
 void APIServer::on_fan_update(fan::FanState *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_fan_state(obj);
+  this->broadcast_state_message_(obj, fan_state_response(obj));
 }
 #endif
 
@@ -164,8 +270,7 @@ void APIServer::on_fan_update(fan::FanState *obj) {
 void APIServer::on_light_update(light::LightState *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_light_state(obj);
+  this->broadcast_state_message_(obj, light_state_response(obj));
 }
 #endif
 
@@ -173,8 +278,7 @@ void APIServer::on_light_update(light::LightState *obj) {
 void APIServer::on_sensor_update(sensor::Sensor *obj, float state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_sensor_state(obj, state);
+  this->broadcast_state_message_(obj, sensor_state_response(obj, state), state);
 }
 #endif
 
@@ -182,8 +286,7 @@ void APIServer::on_sensor_update(sensor::Sensor *obj, float state) {
 void APIServer::on_switch_update(switch_::Switch *obj, bool state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_switch_state(obj, state);
+  this->broadcast_state_message_(obj, switch_state_response(obj, state));
 }
 #endif
 
@@ -191,8 +294,7 @@ void APIServer::on_switch_update(switch_::Switch *obj, bool state) {
 void APIServer::on_text_sensor_update(text_sensor::TextSensor *obj, std::string state) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_text_sensor_state(obj, state);
+  this->broadcast_state_message_(obj, text_sensor_state_response(obj, state));
 }
 #endif
 
@@ -200,8 +302,7 @@ void APIServer::on_text_sensor_update(text_sensor::TextSensor *obj, std::string
 void APIServer::on_climate_update(climate::Climate *obj) {
   if (obj->is_internal())
     return;
-  for (auto *c : this->clients_)
-    c->send_climate_state(obj);
+  this->broadcast_state_message_(obj, climate_state_response(obj));
 }
 #endif
 
@@ -210,17 +311,33 @@ void APIServer::set_port(uint16_t port) { this->port_ = port; }
 APIServer *global_api_server = nullptr;
 
 void APIServer::set_password(const std::string &password) { this->password_ = password; }
-void APIServer::send_service_call(ServiceCallResponse &call) {
+void APIServer::send_service_call(const ServiceCallResponse &call) {
   for (auto *client : this->clients_) {
     client->send_service_call(call);
   }
 }
 APIServer::APIServer() { global_api_server = this; }
 void APIServer::subscribe_home_assistant_state(std::string entity_id, std::function<void(std::string)> f) {
-  this->state_subs_.push_back(HomeAssistantStateSubscription{
-      .entity_id = std::move(entity_id),
-      .callback = std::move(f),
-  });
+  const uint32_t hash = fnv1_hash(entity_id);
+  // keep the subscriptions sorted by hash so incoming states can be matched with a binary search
+  auto pos = std::upper_bound(
+      this->state_subs_.begin(), this->state_subs_.end(), hash,
+      [](uint32_t hash, const HomeAssistantStateSubscription &sub) { return hash < sub.entity_id_hash; });
+  this->state_subs_.insert(pos, HomeAssistantStateSubscription{
+                                    .entity_id = std::move(entity_id),
+                                    .entity_id_hash = hash,
+                                    .callback = std::move(f),
+                                });
+}
+void APIServer::on_home_assistant_state(const std::string &entity_id, const std::string &state) {
+  const uint32_t hash = fnv1_hash(entity_id);
+  auto it = std::lower_bound(
+      this->state_subs_.begin(), this->state_subs_.end(), hash,
+      [](const HomeAssistantStateSubscription &sub, uint32_t hash) { return sub.entity_id_hash < hash; });
+  for (; it != this->state_subs_.end() && it->entity_id_hash == hash; ++it) {
+    if (it->entity_id == entity_id)
+      it->callback(state);
+  }
 }
 const std::vector<APIServer::HomeAssistantStateSubscription> &APIServer::get_state_subs() const {
   return this->state_subs_;
@@ -235,6 +352,17 @@ void APIServer::request_time() {
   }
 }
 #endif
+const std::vector<uint8_t> &APIServer::get_list_entities_catalog() {
+  if (this->list_entities_catalog_.empty()) {
+    ListEntitiesIterator iterator(this, &this->list_entities_catalog_);
+    iterator.begin();
+    while (!iterator.completed())
+      iterator.advance();
+    this->list_entities_catalog_.shrink_to_fit();
+    ESP_LOGD(TAG, "Serialized entity catalog: %u bytes", static_cast<unsigned>(this->list_entities_catalog_.size()));
+  }
+  return this->list_entities_catalog_;
+}
 bool APIServer::is_connected() const { return !this->clients_.empty(); }
 void APIServer::on_shutdown() {
   for (auto *c : this->clients_) {
@@ -245,7 +373,7 @@ void APIServer::on_shutdown() {
 
 // APIConnection
 APIConnection::APIConnection(AsyncClient *client, APIServer *parent)
-    : client_(client), parent_(parent), initial_state_iterator_(parent, this), list_entities_iterator_(parent, this) {
+    : client_(client), parent_(parent), initial_state_iterator_(parent, this) {
   this->client_->onError([](void *s, AsyncClient *c, int8_t error) { ((APIConnection *) s)->on_error_(error); }, this);
   this->client_->onDisconnect([](void *s, AsyncClient *c) { ((APIConnection *) s)->on_disconnect_(); }, this);
   this->client_->onTimeout([](void *s, AsyncClient *c, uint32_t time) { ((APIConnection *) s)->on_timeout_(time); },
@@ -253,13 +381,21 @@ APIConnection::APIConnection(AsyncClient *client, APIServer *parent)
   this->client_->onData([](void *s, AsyncClient *c, void *buf,
                            size_t len) { ((APIConnection *) s)->on_data_(reinterpret_cast<uint8_t *>(buf), len); },
                         this);
+  this->client_->onAck([](void *s, AsyncClient *c, size_t len, uint32_t time) { ((APIConnection *) s)->on_ack_(len); },
+                       this);
 
   this->send_buffer_.reserve(64);
-  this->recv_buffer_.reserve(32);
   this->client_info_ = this->client_->remoteIP().toString().c_str();
   this->last_traffic_ = millis();
 }
-APIConnection::~APIConnection() { delete this->client_; }
+APIConnection::~APIConnection() {
+#ifdef USE_ESP32_CAMERA
+  // lwIP must not keep sending unacknowledged frame buffer data after the image is released
+  if (this->camera_data_in_flight_())
+    this->client_->abort();
+#endif
+  delete this->client_;
+}
 void APIConnection::on_error_(int8_t error) {
   // disconnect will also be called, nothing to do here
   this->remove_ = true;
@@ -269,287 +405,277 @@ void APIConnection::on_disconnect_() {
   this->remove_ = true;
 }
 void APIConnection::on_timeout_(uint32_t time) { this->disconnect_client(); }
+void APIConnection::on_ack_(size_t len) { this->tx_acked_ += len; }
 void APIConnection::on_data_(uint8_t *buf, size_t len) {
   if (len == 0 || buf == nullptr)
     return;
 
-  this->recv_buffer_.insert(this->recv_buffer_.end(), buf, buf + len);
+  // acknowledged in parse_recv_buffer_(), until then the TCP window keeps the peer from sending more than fits
+  this->client_->ackLater();
+  if (!this->recv_buffer_.write(buf, len)) {
+    // only if the peer ignores the TCP window; can't drop bytes from a stream, the connection is closed from the loop
+    this->recv_overflow_ = true;
+  }
   // TODO: On ESP32, use queue to notify main thread of new data
 }
 void APIConnection::parse_recv_buffer_() {
-  if (this->recv_buffer_.empty() || this->remove_)
+  if (this->remove_)
     return;
+  if (this->recv_overflow_) {
+    ESP_LOGW(TAG, "Receive buffer overflow from %s", this->client_info_.c_str());
+    this->fatal_error_();
+    return;
+  }
 
+  const uint32_t parsed = this->parse_messages_();
+  // reopen the TCP window by what was taken out of the ring
+  if (parsed != 0 && !this->remove_)
+    this->client_->ack(parsed);
+}
+uint32_t APIConnection::parse_messages_() {
+  uint32_t parsed = 0;
   while (!this->recv_buffer_.empty()) {
-    if (this->recv_buffer_[0] != 0x00) {
+    if (this->large_message_remaining_ != 0) {
+      // a message that doesn't fit into the ring, collect it piece by piece
+      const uint32_t len = std::min<uint32_t>(this->recv_buffer_.size(), this->large_message_remaining_);
+      // within the capacity reserved for the message, doesn't reallocate
+      const size_t offset = this->recv_scratch_.size();
+      this->recv_scratch_.resize(offset + len);
+      this->recv_buffer_.read(len, this->recv_scratch_.data() + offset);
+      parsed += len;
+      this->large_message_remaining_ -= len;
+      if (this->large_message_remaining_ != 0)
+        return parsed;
+
+      this->read_message_(this->recv_scratch_.size(), this->large_message_type_, this->recv_scratch_.data());
+      this->recv_scratch_.clear();
+      this->recv_scratch_.shrink_to_fit();
+      if (this->remove_)
+        return parsed;
+      continue;
+    }
+
+    if (this->recv_buffer_.peek(0) != 0x00) {
       ESP_LOGW(TAG, "Invalid preamble from %s", this->client_info_.c_str());
       this->fatal_error_();
-      return;
+      return parsed;
     }
     uint32_t i = 1;
     const uint32_t size = this->recv_buffer_.size();
     uint32_t msg_size = 0;
-    while (i < size) {
-      const uint8_t dat = this->recv_buffer_[i];
-      msg_size |= (dat & 0x7F);
+    bool msg_size_done = false;
+    for (uint8_t shift = 0; i < size && shift < 32; shift += 7) {
+      const uint8_t dat = this->recv_buffer_.peek(i);
+      msg_size |= uint32_t(dat & 0x7F) << shift;
       // consume
       i += 1;
       if ((dat & 0x80) == 0x00) {
+        msg_size_done = true;
         break;
-      } else {
-        msg_size <<= 7;
       }
     }
-    if (i == size)
+    if (!msg_size_done)
       // not enough data there yet
-      return;
+      return parsed;
 
     uint32_t msg_type = 0;
     bool msg_type_done = false;
-    while (i < size) {
-      const uint8_t dat = this->recv_buffer_[i];
-      msg_type |= (dat & 0x7F);
+    for (uint8_t shift = 0; i < size && shift < 32; shift += 7) {
+      const uint8_t dat = this->recv_buffer_.peek(i);
+      msg_type |= uint32_t(dat & 0x7F) << shift;
       // consume
       i += 1;
       if ((dat & 0x80) == 0x00) {
         msg_type_done = true;
         break;
-      } else {
-        msg_type <<= 7;
       }
     }
     if (!msg_type_done)
       // not enough data there yet
-      return;
-
-    if (size - i < msg_size)
-      // message body not fully received
-      return;
+      return parsed;
 
     // ESP_LOGVV(TAG, "RECV Message: Size=%u Type=%u", msg_size, msg_type);
 
     if (!this->valid_rx_message_type_(msg_type)) {
       ESP_LOGE(TAG, "Not a valid message type: %u", msg_type);
       this->fatal_error_();
-      return;
+      return parsed;
+    }
+
+    if (msg_size > API_MAX_MESSAGE_SIZE) {
+      // checked before anything is allocated for it, the header is all it takes to claim gigabytes
+      ESP_LOGW(TAG, "Message of %u bytes from %s is too large", msg_size, this->client_info_.c_str());
+      this->fatal_error_();
+      return parsed;
+    }
+    if (msg_size > API_RECV_BUFFER_SIZE - i) {
+      // can never be complete in the ring, continue with the body on the heap
+      this->recv_buffer_.consume(i);
+      parsed += i;
+      this->recv_scratch_.clear();
+      this->recv_scratch_.reserve(msg_size);
+      this->large_message_remaining_ = msg_size;
+      this->large_message_type_ = msg_type;
+      continue;
     }
 
-    uint8_t *msg = &this->recv_buffer_[i];
+    if (size - i < msg_size)
+      // message body not fully received
+      return parsed;
+
+    const uint8_t *msg = this->recv_buffer_.peek_contiguous(i, msg_size, this->recv_scratch_);
     this->read_message_(msg_size, msg_type, msg);
     if (this->remove_)
-      return;
+      return parsed;
     // pop front
-    uint32_t total = i + msg_size;
-    this->recv_buffer_.erase(this->recv_buffer_.begin(), this->recv_buffer_.begin() + total);
+    this->recv_buffer_.consume(i + msg_size);
+    parsed += i + msg_size;
   }
+  return parsed;
 }
-void APIConnection::read_message_(uint32_t size, uint32_t type, uint8_t *msg) {
-  this->last_traffic_ = millis();
-
-  switch (static_cast<APIMessageType>(type)) {
-    case APIMessageType::HELLO_REQUEST: {
-      HelloRequest req;
-      req.decode(msg, size);
-      this->on_hello_request_(req);
-      break;
-    }
-    case APIMessageType::HELLO_RESPONSE: {
-      // Invalid
-      break;
-    }
-    case APIMessageType::CONNECT_REQUEST: {
-      ConnectRequest req;
-      req.decode(msg, size);
-      this->on_connect_request_(req);
-      break;
-    }
-    case APIMessageType::CONNECT_RESPONSE:
-      // Invalid
-      break;
-    case APIMessageType::DISCONNECT_REQUEST: {
-      DisconnectRequest req;
-      req.decode(msg, size);
-      this->on_disconnect_request_(req);
-      break;
-    }
-    case APIMessageType::DISCONNECT_RESPONSE: {
-      DisconnectResponse req;
-      req.decode(msg, size);
-      this->on_disconnect_response_(req);
-      break;
-    }
-    case APIMessageType::PING_REQUEST: {
-      PingRequest req;
-      req.decode(msg, size);
-      this->on_ping_request_(req);
-      break;
-    }
-    case APIMessageType::PING_RESPONSE: {
-      PingResponse req;
-      req.decode(msg, size);
-      this->on_ping_response_(req);
-      break;
-    }
-    case APIMessageType::DEVICE_INFO_REQUEST: {
-      DeviceInfoRequest req;
-      req.decode(msg, size);
-      this->on_device_info_request_(req);
-      break;
-    }
-    case APIMessageType::DEVICE_INFO_RESPONSE: {
-      // Invalid
-      break;
-    }
-    case APIMessageType::LIST_ENTITIES_REQUEST: {
-      ListEntitiesRequest req;
-      req.decode(msg, size);
-      this->on_list_entities_request_(req);
-      break;
-    }
-    case APIMessageType::LIST_ENTITIES_BINARY_SENSOR_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_COVER_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_FAN_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_LIGHT_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_SENSOR_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_SWITCH_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_TEXT_SENSOR_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_SERVICE_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_CAMERA_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_CLIMATE_RESPONSE:
-    case APIMessageType::LIST_ENTITIES_DONE_RESPONSE:
-      // Invalid
-      break;
-    case APIMessageType::SUBSCRIBE_STATES_REQUEST: {
-      SubscribeStatesRequest req;
-      req.decode(msg, size);
-      this->on_subscribe_states_request_(req);
-      break;
-    }
-    case APIMessageType::BINARY_SENSOR_STATE_RESPONSE:
-    case APIMessageType::COVER_STATE_RESPONSE:
-    case APIMessageType::FAN_STATE_RESPONSE:
-    case APIMessageType::LIGHT_STATE_RESPONSE:
-    case APIMessageType::SENSOR_STATE_RESPONSE:
-    case APIMessageType::SWITCH_STATE_RESPONSE:
-    case APIMessageType::TEXT_SENSOR_STATE_RESPONSE:
-    case APIMessageType::CAMERA_IMAGE_RESPONSE:
-    case APIMessageType::CLIMATE_STATE_RESPONSE:
-      // Invalid
-      break;
-    case APIMessageType::SUBSCRIBE_LOGS_REQUEST: {
-      SubscribeLogsRequest req;
-      req.decode(msg, size);
-      this->on_subscribe_logs_request_(req);
-      break;
-    }
-    case APIMessageType ::SUBSCRIBE_LOGS_RESPONSE:
-      // Invalid
-      break;
-    case APIMessageType::COVER_COMMAND_REQUEST: {
+template<typename T> static bool decode_message(T &msg, const uint8_t *buf, uint32_t size) {
+  if (proto_decode(msg, buf, size))
+    return true;
+  ESP_LOGV(TAG, "Invalid message of type %u", static_cast<uint32_t>(T::MESSAGE_TYPE));
+  return false;
+}
+template<typename T, void (APIConnection::*H)(const T &)>
+void APIConnection::handle_message_(APIConnection *conn, const uint8_t *msg, uint32_t size) {
+  T req;
+  if (decode_message(req, msg, size))
+    (conn->*H)(req);
+}
+
+// connection states in which a message type is accepted, one bit per ConnectionState
+static const uint8_t RX_HELLO = 1 << 0;
+static const uint8_t RX_CONNECT = 1 << 1;
+static const uint8_t RX_CONNECTED = 1 << 2;
+static const uint8_t RX_AUTHENTICATED = RX_CONNECT | RX_CONNECTED;
+
+const APIConnection::MessageHandler APIConnection::MESSAGE_HANDLERS[] PROGMEM = {
+    {nullptr, 0},  // 0: unused
+    {&APIConnection::handle_message_<HelloRequest, &APIConnection::on_hello_request_>, RX_HELLO},
+    {nullptr, 0},  // HelloResponse
+    {&APIConnection::handle_message_<ConnectRequest, &APIConnection::on_connect_request_>, RX_CONNECT},
+    {nullptr, 0},  // ConnectResponse
+    {&APIConnection::handle_message_<DisconnectRequest, &APIConnection::on_disconnect_request_>, RX_AUTHENTICATED},
+    {&APIConnection::handle_message_<DisconnectResponse, &APIConnection::on_disconnect_response_>, RX_AUTHENTICATED},
+    {&APIConnection::handle_message_<PingRequest, &APIConnection::on_ping_request_>, RX_AUTHENTICATED},
+    {&APIConnection::handle_message_<PingResponse, &APIConnection::on_ping_response_>, RX_AUTHENTICATED},
+    {&APIConnection::handle_message_<DeviceInfoRequest, &APIConnection::on_device_info_request_>, RX_AUTHENTICATED},
+    {nullptr, RX_CONNECTED},  // DeviceInfoResponse
+    {&APIConnection::handle_message_<ListEntitiesRequest, &APIConnection::on_list_entities_request_>, RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // ListEntitiesBinarySensorResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesCoverResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesFanResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesLightResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesSensorResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesSwitchResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesTextSensorResponse
+    {nullptr, RX_CONNECTED},  // ListEntitiesDoneResponse
+    {&APIConnection::handle_message_<SubscribeStatesRequest, &APIConnection::on_subscribe_states_request_>,
+     RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // BinarySensorStateResponse
+    {nullptr, RX_CONNECTED},  // CoverStateResponse
+    {nullptr, RX_CONNECTED},  // FanStateResponse
+    {nullptr, RX_CONNECTED},  // LightStateResponse
+    {nullptr, RX_CONNECTED},  // SensorStateResponse
+    {nullptr, RX_CONNECTED},  // SwitchStateResponse
+    {nullptr, RX_CONNECTED},  // TextSensorStateResponse
+    {&APIConnection::handle_message_<SubscribeLogsRequest, &APIConnection::on_subscribe_logs_request_>, RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // SubscribeLogsResponse
 #ifdef USE_COVER
-      CoverCommandRequest req;
-      req.decode(msg, size);
-      this->on_cover_command_request_(req);
+    {&APIConnection::handle_message_<CoverCommandRequest, &APIConnection::on_cover_command_request_>, RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // CoverCommandRequest
 #endif
-      break;
-    }
-    case APIMessageType::FAN_COMMAND_REQUEST: {
 #ifdef USE_FAN
-      FanCommandRequest req;
-      req.decode(msg, size);
-      this->on_fan_command_request_(req);
+    {&APIConnection::handle_message_<FanCommandRequest, &APIConnection::on_fan_command_request_>, RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // FanCommandRequest
 #endif
-      break;
-    }
-    case APIMessageType::LIGHT_COMMAND_REQUEST: {
 #ifdef USE_LIGHT
-      LightCommandRequest req;
-      req.decode(msg, size);
-      this->on_light_command_request_(req);
+    {&APIConnection::handle_message_<LightCommandRequest, &APIConnection::on_light_command_request_>, RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // LightCommandRequest
 #endif
-      break;
-    }
-    case APIMessageType::SWITCH_COMMAND_REQUEST: {
 #ifdef USE_SWITCH
-      SwitchCommandRequest req;
-      req.decode(msg, size);
-      this->on_switch_command_request_(req);
+    {&APIConnection::handle_message_<SwitchCommandRequest, &APIConnection::on_switch_command_request_>, RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // SwitchCommandRequest
 #endif
-      break;
-    }
-    case APIMessageType::CLIMATE_COMMAND_REQUEST: {
-#ifdef USE_CLIMATE
-      ClimateCommandRequest req;
-      req.decode(msg, size);
-      this->on_climate_command_request_(req);
-#endif
-      break;
-    }
-    case APIMessageType::SUBSCRIBE_SERVICE_CALLS_REQUEST: {
-      SubscribeServiceCallsRequest req;
-      req.decode(msg, size);
-      this->on_subscribe_service_calls_request_(req);
-      break;
-    }
-    case APIMessageType::SERVICE_CALL_RESPONSE:
-      // Invalid
-      break;
-    case APIMessageType::GET_TIME_REQUEST:
-      // Invalid
-      break;
-    case APIMessageType::GET_TIME_RESPONSE: {
+    {&APIConnection::handle_message_<SubscribeServiceCallsRequest,
+                                     &APIConnection::on_subscribe_service_calls_request_>,
+     RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // ServiceCallResponse
+    {nullptr, RX_CONNECTED},  // GetTimeRequest
 #ifdef USE_HOMEASSISTANT_TIME
-      homeassistant::GetTimeResponse req;
-      req.decode(msg, size);
+    {&APIConnection::handle_message_<GetTimeResponse, &APIConnection::on_get_time_response_>, RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // GetTimeResponse
 #endif
-      break;
-    }
-    case APIMessageType::SUBSCRIBE_HOME_ASSISTANT_STATES_REQUEST: {
-      SubscribeHomeAssistantStatesRequest req;
-      req.decode(msg, size);
-      this->on_subscribe_home_assistant_states_request_(req);
-      break;
-    }
-    case APIMessageType::SUBSCRIBE_HOME_ASSISTANT_STATE_RESPONSE:
-      // Invalid
-      break;
-    case APIMessageType::HOME_ASSISTANT_STATE_RESPONSE: {
-      HomeAssistantStateResponse req;
-      req.decode(msg, size);
-      this->on_home_assistant_state_response_(req);
-      break;
-    }
-    case APIMessageType::EXECUTE_SERVICE_REQUEST: {
-      ExecuteServiceRequest req;
-      req.decode(msg, size);
-      this->on_execute_service_(req);
-      break;
-    }
-    case APIMessageType::CAMERA_IMAGE_REQUEST: {
+    {&APIConnection::handle_message_<SubscribeHomeAssistantStatesRequest,
+                                     &APIConnection::on_subscribe_home_assistant_states_request_>,
+     RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // SubscribeHomeAssistantStateResponse
+    {&APIConnection::handle_message_<HomeAssistantStateResponse, &APIConnection::on_home_assistant_state_response_>,
+     RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // ListEntitiesServicesResponse
+    {&APIConnection::handle_message_<ExecuteServiceRequest, &APIConnection::on_execute_service_>, RX_CONNECTED},
+    {nullptr, RX_CONNECTED},  // ListEntitiesCameraResponse
+    {nullptr, RX_CONNECTED},  // CameraImageResponse
 #ifdef USE_ESP32_CAMERA
-      CameraImageRequest req;
-      req.decode(msg, size);
-      this->on_camera_image_request_(req);
+    {&APIConnection::handle_message_<CameraImageRequest, &APIConnection::on_camera_image_request_>, RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // CameraImageRequest
 #endif
-      break;
-    }
+    {nullptr, RX_CONNECTED},  // ListEntitiesClimateResponse
+    {nullptr, RX_CONNECTED},  // ClimateStateResponse
+#ifdef USE_CLIMATE
+    {&APIConnection::handle_message_<ClimateCommandRequest, &APIConnection::on_climate_command_request_>,
+     RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // ClimateCommandRequest
+#endif
+#ifdef USE_SENSOR_HISTORY
+    {&APIConnection::handle_message_<SensorHistoryRequest, &APIConnection::on_sensor_history_request_>,
+     RX_CONNECTED},
+#else
+    {nullptr, RX_CONNECTED},  // SensorHistoryRequest
+#endif
+    {nullptr, RX_CONNECTED},  // SensorHistoryResponse
+};
+APIConnection::MessageHandler APIConnection::get_message_handler_(uint32_t type) {
+  static const uint32_t count = sizeof(MESSAGE_HANDLERS) / sizeof(MESSAGE_HANDLERS[0]);
+  static_assert(count == static_cast<uint32_t>(APIMessageType::SENSOR_HISTORY_RESPONSE) + 1,
+                "Every message type needs an entry in MESSAGE_HANDLERS");
+  MessageHandler handler;
+  if (type < count) {
+    memcpy_P(&handler, &MESSAGE_HANDLERS[type], sizeof(MessageHandler));
+  } else {
+    // unknown (newer) message types are ignored once connected
+    handler = {nullptr, RX_CONNECTED};
   }
+  return handler;
+}
+void APIConnection::read_message_(uint32_t size, uint32_t type, const uint8_t *msg) {
+  this->last_traffic_ = millis();
+
+  auto handler = this->get_message_handler_(type);
+  if (handler.handle != nullptr)
+    handler.handle(this, msg, size);
 }
 void APIConnection::on_hello_request_(const HelloRequest &req) {
-  ESP_LOGVV(TAG, "on_hello_request_(client_info='%s')", req.get_client_info().c_str());
-  this->client_info_ = req.get_client_info() + " (" + this->client_->remoteIP().toString().c_str();
+  ESP_LOGVV(TAG, "on_hello_request_(client_info='%s')", req.client_info.c_str());
+  this->client_info_ = req.client_info + " (" + this->client_->remoteIP().toString().c_str();
   this->client_info_ += ")";
   ESP_LOGV(TAG, "Hello from client: '%s'", this->client_info_.c_str());
 
-  auto buffer = this->get_buffer();
-  // uint32 api_version_major = 1; -> 1
-  buffer.encode_uint32(1, 1);
-  // uint32 api_version_minor = 2; -> 1
-  buffer.encode_uint32(2, 1);
-
-  // string server_info = 3;
-  buffer.encode_string(3, App.get_name() + " (esphome v" ESPHOME_VERSION ")");
-  bool success = this->send_buffer(APIMessageType::HELLO_RESPONSE);
+  HelloResponse resp;
+  resp.api_version_major = 1;
+  resp.api_version_minor = 1;
+  resp.server_info = App.get_name() + " (esphome v" ESPHOME_VERSION ")";
+  bool success = this->send_message(resp);
   if (!success) {
     this->fatal_error_();
     return;
@@ -558,12 +684,11 @@ void APIConnection::on_hello_request_(const HelloRequest &req) {
   this->connection_state_ = ConnectionState::WAITING_FOR_CONNECT;
 }
 void APIConnection::on_connect_request_(const ConnectRequest &req) {
-  ESP_LOGVV(TAG, "on_connect_request_(password='%s')", req.get_password().c_str());
-  bool correct = this->parent_->check_password(req.get_password());
-  auto buffer = this->get_buffer();
-  // bool invalid_password = 1;
-  buffer.encode_bool(1, !correct);
-  bool success = this->send_buffer(APIMessageType::CONNECT_RESPONSE);
+  ESP_LOGVV(TAG, "on_connect_request_(password='%s')", req.password.c_str());
+  bool correct = this->parent_->check_password(req.password);
+  ConnectResponse resp;
+  resp.invalid_password = !correct;
+  bool success = this->send_message(resp);
   if (!success) {
     this->fatal_error_();
     return;
@@ -596,8 +721,7 @@ void APIConnection::on_disconnect_response_(const DisconnectResponse &req) {
 }
 void APIConnection::on_ping_request_(const PingRequest &req) {
   ESP_LOGVV(TAG, "on_ping_request_");
-  PingResponse resp;
-  this->send_message(resp);
+  this->send_message(PingResponse());
 }
 void APIConnection::on_ping_response_(const PingResponse &req) {
   ESP_LOGVV(TAG, "on_ping_response_");
@@ -606,40 +730,64 @@ void APIConnection::on_ping_response_(const PingResponse &req) {
 }
 void APIConnection::on_device_info_request_(const DeviceInfoRequest &req) {
   ESP_LOGVV(TAG, "on_device_info_request_");
-  auto buffer = this->get_buffer();
-  // bool uses_password = 1;
-  buffer.encode_bool(1, this->parent_->uses_password());
-  // string name = 2;
-  buffer.encode_string(2, App.get_name());
-  // string mac_address = 3;
-  buffer.encode_string(3, get_mac_address_pretty());
-  // string esphome_version = 4;
-  buffer.encode_string(4, ESPHOME_VERSION);
-  // string compilation_time = 5;
-  buffer.encode_string(5, App.get_compilation_time());
+  DeviceInfoResponse resp;
+  resp.uses_password = this->parent_->uses_password();
+  resp.name = App.get_name();
+  resp.mac_address = get_mac_address_pretty();
+  resp.esphome_core_version = ESPHOME_VERSION;
+  resp.compilation_time = App.get_compilation_time();
 #ifdef ARDUINO_BOARD
-  // string model = 6;
-  buffer.encode_string(6, ARDUINO_BOARD);
+  resp.model = ARDUINO_BOARD;
 #endif
 #ifdef USE_DEEP_SLEEP
-  // bool has_deep_sleep = 7;
-  buffer.encode_bool(7, deep_sleep::global_has_deep_sleep);
+  resp.has_deep_sleep = deep_sleep::global_has_deep_sleep;
 #endif
-  this->send_buffer(APIMessageType::DEVICE_INFO_RESPONSE);
+  this->send_message(resp);
 }
 void APIConnection::on_list_entities_request_(const ListEntitiesRequest &req) {
   ESP_LOGVV(TAG, "on_list_entities_request_");
-  this->list_entities_iterator_.begin();
+  this->listing_entities_ = true;
+  this->list_entities_sent_ = 0;
+}
+void APIConnection::process_list_entities_() {
+  if (!this->listing_entities_)
+    return;
+
+  const std::vector<uint8_t> &catalog = this->parent_->get_list_entities_catalog();
+  const size_t space = this->client_->space();
+  // only send whole messages, other messages may be sent in between
+  size_t end = this->list_entities_sent_;
+  while (end < catalog.size()) {
+    uint32_t size_len, type_len;
+    auto size = proto_decode_varuint32(&catalog[end + 1], catalog.size() - end - 1, &size_len);
+    proto_decode_varuint32(&catalog[end + 1 + size_len], catalog.size() - end - 1 - size_len, &type_len);
+    const size_t frame_len = 1 + size_len + type_len + *size;
+    if (end + frame_len - this->list_entities_sent_ > space)
+      break;
+    end += frame_len;
+  }
+  if (end == this->list_entities_sent_)
+    return;
+
+  this->write_(&catalog[this->list_entities_sent_], end - this->list_entities_sent_);
+  this->client_->send();
+  this->list_entities_sent_ = end;
+  if (end == catalog.size())
+    this->listing_entities_ = false;
 }
 void APIConnection::on_subscribe_states_request_(const SubscribeStatesRequest &req) {
   ESP_LOGVV(TAG, "on_subscribe_states_request_");
   this->state_subscription_ = true;
+  this->throttle_rules_ = req.throttles;
+  this->entity_throttles_.clear();
+  if (!this->throttle_rules_.empty())
+    ESP_LOGV(TAG, "%s requested %u state throttle rules", this->client_info_.c_str(), this->throttle_rules_.size());
   this->initial_state_iterator_.begin();
 }
 void APIConnection::on_subscribe_logs_request_(const SubscribeLogsRequest &req) {
   ESP_LOGVV(TAG, "on_subscribe_logs_request_");
-  this->log_subscription_ = req.get_level();
-  if (req.get_dump_config()) {
+  this->log_subscription_ = req.level;
+  if (req.dump_config) {
     App.schedule_dump_config();
   }
 }
@@ -649,30 +797,8 @@ void APIConnection::fatal_error_() {
   this->remove_ = true;
 }
 bool APIConnection::valid_rx_message_type_(uint32_t type) {
-  switch (static_cast<APIMessageType>(type)) {
-    case APIMessageType::HELLO_RESPONSE:
-    case APIMessageType::CONNECT_RESPONSE:
-      return false;
-    case APIMessageType::HELLO_REQUEST:
-      return this->connection_state_ == ConnectionState::WAITING_FOR_HELLO;
-    case APIMessageType::CONNECT_REQUEST:
-      return this->connection_state_ == ConnectionState::WAITING_FOR_CONNECT;
-    case APIMessageType::PING_REQUEST:
-    case APIMessageType::PING_RESPONSE:
-    case APIMessageType::DISCONNECT_REQUEST:
-    case APIMessageType::DISCONNECT_RESPONSE:
-    case APIMessageType::DEVICE_INFO_REQUEST:
-      if (this->connection_state_ == ConnectionState::WAITING_FOR_CONNECT)
-        return true;
-    default:
-      return this->connection_state_ == ConnectionState::CONNECTED;
-  }
-}
-bool APIConnection::send_message(APIMessage &msg) {
-  this->send_buffer_.clear();
-  APIBuffer buf(&this->send_buffer_);
-  msg.encode(buf);
-  return this->send_buffer(msg.message_type());
+  const uint8_t state_bit = 1 << static_cast<uint8_t>(this->connection_state_);
+  return (this->get_message_handler_(type).allowed_states & state_bit) != 0;
 }
 bool APIConnection::send_empty_message(APIMessageType type) {
   this->send_buffer_.clear();
@@ -703,14 +829,14 @@ void encode_varint(uint8_t *dat, uint8_t *len, uint32_t value) {
   }
 }
 
-bool APIConnection::send_buffer(APIMessageType type) {
+bool APIConnection::send_payload_(APIMessageType type, const std::vector<uint8_t> &payload) {
   uint8_t header[20];
   header[0] = 0x00;
   uint8_t header_len = 1;
-  encode_varint(header + header_len, &header_len, this->send_buffer_.size());
+  encode_varint(header + header_len, &header_len, payload.size());
   encode_varint(header + header_len, &header_len, static_cast<uint32_t>(type));
 
-  size_t needed_space = this->send_buffer_.size() + header_len;
+  size_t needed_space = payload.size() + header_len;
 
   if (needed_space > this->client_->space()) {
     delay(0);
@@ -729,7 +855,7 @@ bool APIConnection::send_buffer(APIMessageType type) {
   //    offset += snprintf(buffer + offset, 512 - offset, "0x%02X ", header[j]);
   //  }
   //  offset += snprintf(buffer + offset, 512 - offset, "| ");
-  //  for (auto &it : this->send_buffer_) {
+  //  for (auto &it : payload) {
   //    int i = snprintf(buffer + offset, 512 - offset, "0x%02X ", it);
   //    if (i <= 0)
   //      break;
@@ -737,9 +863,14 @@ bool APIConnection::send_buffer(APIMessageType type) {
   //  }
   //  ESP_LOGVV(TAG, "SEND %s", buffer);
 
-  this->client_->add(reinterpret_cast<char *>(header), header_len);
-  this->client_->add(reinterpret_cast<char *>(this->send_buffer_.data()), this->send_buffer_.size());
-  return this->client_->send();
+  this->write_(header, header_len);
+  this->write_(payload.data(), payload.size());
+  // the data is queued on the connection either way, if it can't go out right now the TCP stack sends it later
+  this->client_->send();
+  return true;
+}
+void APIConnection::write_(const void *data, size_t len, bool copy) {
+  this->tx_queued_ += this->client_->add(reinterpret_cast<const char *>(data), len, copy ? ASYNC_WRITE_FLAG_COPY : 0);
 }
 
 void APIConnection::loop() {
@@ -756,8 +887,16 @@ void APIConnection::loop() {
   }
   this->parse_recv_buffer_();
 
-  this->list_entities_iterator_.advance();
-  this->initial_state_iterator_.advance();
+  this->process_pending_states_();
+  this->process_throttled_states_();
+
+  this->process_list_entities_();
+#ifdef USE_SENSOR_HISTORY
+  this->process_history_query_();
+#endif
+  // only queue more initial states once the held back ones are out
+  if (this->pending_states_.empty())
+    this->initial_state_iterator_.advance();
 
   const uint32_t keepalive = 60000;
   if (this->sent_ping_) {
@@ -771,27 +910,14 @@ void APIConnection::loop() {
   }
 
 #ifdef USE_ESP32_CAMERA
+  if (this->image_in_flight_ && !this->camera_data_in_flight_())
+    // lets the camera capture the next frame once every client is done with this one
+    this->image_in_flight_.reset();
   if (this->image_reader_.available()) {
     uint32_t space = this->client_->space();
-    // reserve 15 bytes for metadata, and at least 64 bytes of data
-    if (space >= 15 + 64) {
-      uint32_t to_send = std::min(space - 15, this->image_reader_.available());
-      auto buffer = this->get_buffer();
-      // fixed32 key = 1;
-      buffer.encode_fixed32(1, esp32_camera::global_esp32_camera->get_object_id_hash());
-      // bytes data = 2;
-      buffer.encode_bytes(2, this->image_reader_.peek_data_buffer(), to_send);
-      // bool done = 3;
-      bool done = this->image_reader_.available() == to_send;
-      buffer.encode_bool(3, done);
-      bool success = this->send_buffer(APIMessageType::CAMERA_IMAGE_RESPONSE);
-      if (success) {
-        this->image_reader_.consume_data(to_send);
-      }
-      if (success && done) {
-        this->image_reader_.return_image();
-      }
-    }
+    // reserve 20 bytes for header and metadata, and at least 64 bytes of data
+    if (space >= 20 + 64)
+      this->send_camera_chunk_(space - 20);
   }
 #endif
 }
@@ -800,13 +926,10 @@ void APIConnection::loop() {
 bool APIConnection::send_binary_sensor_state(binary_sensor::BinarySensor *binary_sensor, bool state) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(binary_sensor))
+    return true;
 
-  auto buffer = this->get_buffer();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, binary_sensor->get_object_id_hash());
-  // bool state = 2;
-  buffer.encode_bool(2, state);
-  return this->send_buffer(APIMessageType::BINARY_SENSOR_STATE_RESPONSE);
+  return this->send_state_message_(binary_sensor, binary_sensor_state_response(binary_sensor, state));
 }
 #endif
 
@@ -814,32 +937,10 @@ bool APIConnection::send_binary_sensor_state(binary_sensor::BinarySensor *binary
 bool APIConnection::send_cover_state(cover::Cover *cover) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(cover))
+    return true;
 
-  auto buffer = this->get_buffer();
-  auto traits = cover->get_traits();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, cover->get_object_id_hash());
-  // enum LegacyCoverState {
-  //   OPEN = 0;
-  //   CLOSED = 1;
-  // }
-  // LegacyCoverState legacy_state = 2;
-  uint32_t state = (cover->position == cover::COVER_OPEN) ? 0 : 1;
-  buffer.encode_uint32(2, state);
-  // float position = 3;
-  buffer.encode_float(3, cover->position);
-  if (traits.get_supports_tilt()) {
-    // float tilt = 4;
-    buffer.encode_float(4, cover->tilt);
-  }
-  // enum CoverCurrentOperation {
-  //   IDLE = 0;
-  //   IS_OPENING = 1;
-  //   IS_CLOSING = 2;
-  // }
-  // CoverCurrentOperation current_operation = 5;
-  buffer.encode_uint32(5, cover->current_operation);
-  return this->send_buffer(APIMessageType::COVER_STATE_RESPONSE);
+  return this->send_state_message_(cover, cover_state_response(cover));
 }
 #endif
 
@@ -847,26 +948,10 @@ bool APIConnection::send_cover_state(cover::Cover *cover) {
 bool APIConnection::send_fan_state(fan::FanState *fan) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(fan))
+    return true;
 
-  auto buffer = this->get_buffer();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, fan->get_object_id_hash());
-  // bool state = 2;
-  buffer.encode_bool(2, fan->state);
-  // bool oscillating = 3;
-  if (fan->get_traits().supports_oscillation()) {
-    buffer.encode_bool(3, fan->oscillating);
-  }
-  // enum FanSpeed {
-  //   LOW = 0;
-  //   MEDIUM = 1;
-  //   HIGH = 2;
-  // }
-  // FanSpeed speed = 4;
-  if (fan->get_traits().supports_speed()) {
-    buffer.encode_uint32(4, fan->speed);
-  }
-  return this->send_buffer(APIMessageType::FAN_STATE_RESPONSE);
+  return this->send_state_message_(fan, fan_state_response(fan));
 }
 #endif
 
@@ -874,40 +959,10 @@ bool APIConnection::send_fan_state(fan::FanState *fan) {
 bool APIConnection::send_light_state(light::LightState *light) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(light))
+    return true;
 
-  auto buffer = this->get_buffer();
-  auto traits = light->get_traits();
-  auto values = light->remote_values;
-
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, light->get_object_id_hash());
-  // bool state = 2;
-  buffer.encode_bool(2, values.get_state() != 0.0f);
-  // float brightness = 3;
-  if (traits.get_supports_brightness()) {
-    buffer.encode_float(3, values.get_brightness());
-  }
-  if (traits.get_supports_rgb()) {
-    // float red = 4;
-    buffer.encode_float(4, values.get_red());
-    // float green = 5;
-    buffer.encode_float(5, values.get_green());
-    // float blue = 6;
-    buffer.encode_float(6, values.get_blue());
-  }
-  // float white = 7;
-  if (traits.get_supports_rgb_white_value()) {
-    buffer.encode_float(7, values.get_white());
-  }
-  // float color_temperature = 8;
-  if (traits.get_supports_color_temperature()) {
-    buffer.encode_float(8, values.get_color_temperature());
-  }
-  // string effect = 9;
-  if (light->supports_effects()) {
-    buffer.encode_string(9, light->get_effect_name());
-  }
-  return this->send_buffer(APIMessageType::LIGHT_STATE_RESPONSE);
+  return this->send_state_message_(light, light_state_response(light));
 }
 #endif
 
@@ -915,13 +970,10 @@ bool APIConnection::send_light_state(light::LightState *light) {
 bool APIConnection::send_sensor_state(sensor::Sensor *sensor, float state) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(sensor))
+    return true;
 
-  auto buffer = this->get_buffer();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, sensor->get_object_id_hash());
-  // float state = 2;
-  buffer.encode_float(2, state);
-  return this->send_buffer(APIMessageType::SENSOR_STATE_RESPONSE);
+  return this->send_state_message_(sensor, sensor_state_response(sensor, state));
 }
 #endif
 
@@ -929,13 +981,10 @@ bool APIConnection::send_sensor_state(sensor::Sensor *sensor, float state) {
 bool APIConnection::send_switch_state(switch_::Switch *a_switch, bool state) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(a_switch))
+    return true;
 
-  auto buffer = this->get_buffer();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, a_switch->get_object_id_hash());
-  // bool state = 2;
-  buffer.encode_bool(2, state);
-  return this->send_buffer(APIMessageType::SWITCH_STATE_RESPONSE);
+  return this->send_state_message_(a_switch, switch_state_response(a_switch, state));
 }
 #endif
 
@@ -943,13 +992,10 @@ bool APIConnection::send_switch_state(switch_::Switch *a_switch, bool state) {
 bool APIConnection::send_text_sensor_state(text_sensor::TextSensor *text_sensor, std::string state) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(text_sensor))
+    return true;
 
-  auto buffer = this->get_buffer();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, text_sensor->get_object_id_hash());
-  // string state = 2;
-  buffer.encode_string(2, state);
-  return this->send_buffer(APIMessageType::TEXT_SENSOR_STATE_RESPONSE);
+  return this->send_state_message_(text_sensor, text_sensor_state_response(text_sensor, state));
 }
 #endif
 
@@ -957,34 +1003,208 @@ bool APIConnection::send_text_sensor_state(text_sensor::TextSensor *text_sensor,
 bool APIConnection::send_climate_state(climate::Climate *climate) {
   if (!this->state_subscription_)
     return false;
+  if (this->coalesce_pending_state_(climate))
+    return true;
 
-  auto buffer = this->get_buffer();
-  auto traits = climate->get_traits();
-  // fixed32 key = 1;
-  buffer.encode_fixed32(1, climate->get_object_id_hash());
-  // ClimateMode mode = 2;
-  buffer.encode_uint32(2, static_cast<uint32_t>(climate->mode));
-  // float current_temperature = 3;
-  if (traits.get_supports_current_temperature()) {
-    buffer.encode_float(3, climate->current_temperature);
+  return this->send_state_message_(climate, climate_state_response(climate));
+}
+#endif
+
+bool APIConnection::send_state_payload_(Nameable *entity, APIMessageType type, const std::vector<uint8_t> &payload) {
+  if (this->send_payload_(type, payload))
+    return true;
+
+  if (this->pending_states_.size() - this->pending_sent_ >= MAX_PENDING_STATES) {
+    this->pending_dropped_++;
+    ESP_LOGV(TAG, "Dropping state of '%s' for %s, too many pending states", entity->get_name().c_str(),
+             this->client_info_.c_str());
+    return false;
   }
-  if (traits.get_supports_two_point_target_temperature()) {
-    // float target_temperature_low = 5;
-    buffer.encode_float(5, climate->target_temperature_low);
-    // float target_temperature_high = 6;
-    buffer.encode_float(6, climate->target_temperature_high);
-  } else {
-    // float target_temperature = 4;
-    buffer.encode_float(4, climate->target_temperature);
+  // the latest state is encoded again once there is space, only remember the entity
+  this->pending_states_.push_back(PendingState{
+      .entity = entity,
+      .type = type,
+  });
+  return true;
+}
+bool APIConnection::coalesce_pending_state_(Nameable *entity) {
+  for (size_t i = this->pending_sent_; i < this->pending_states_.size(); i++) {
+    if (this->pending_states_[i].entity == entity) {
+      this->pending_coalesced_++;
+      return true;
+    }
+  }
+  return false;
+}
+void APIConnection::send_pending_state_(Nameable *entity, APIMessageType type) {
+  switch (type) {
+#ifdef USE_BINARY_SENSOR
+    case APIMessageType::BINARY_SENSOR_STATE_RESPONSE: {
+      auto *binary_sensor = static_cast<binary_sensor::BinarySensor *>(entity);
+      this->send_binary_sensor_state(binary_sensor, binary_sensor->state);
+      break;
+    }
+#endif
+#ifdef USE_COVER
+    case APIMessageType::COVER_STATE_RESPONSE:
+      this->send_cover_state(static_cast<cover::Cover *>(entity));
+      break;
+#endif
+#ifdef USE_FAN
+    case APIMessageType::FAN_STATE_RESPONSE:
+      this->send_fan_state(static_cast<fan::FanState *>(entity));
+      break;
+#endif
+#ifdef USE_LIGHT
+    case APIMessageType::LIGHT_STATE_RESPONSE:
+      this->send_light_state(static_cast<light::LightState *>(entity));
+      break;
+#endif
+#ifdef USE_SENSOR
+    case APIMessageType::SENSOR_STATE_RESPONSE: {
+      auto *sensor = static_cast<sensor::Sensor *>(entity);
+      this->send_sensor_state(sensor, sensor->state);
+      break;
+    }
+#endif
+#ifdef USE_SWITCH
+    case APIMessageType::SWITCH_STATE_RESPONSE: {
+      auto *a_switch = static_cast<switch_::Switch *>(entity);
+      this->send_switch_state(a_switch, a_switch->state);
+      break;
+    }
+#endif
+#ifdef USE_TEXT_SENSOR
+    case APIMessageType::TEXT_SENSOR_STATE_RESPONSE: {
+      auto *text_sensor = static_cast<text_sensor::TextSensor *>(entity);
+      this->send_text_sensor_state(text_sensor, text_sensor->state);
+      break;
+    }
+#endif
+#ifdef USE_CLIMATE
+    case APIMessageType::CLIMATE_STATE_RESPONSE:
+      this->send_climate_state(static_cast<climate::Climate *>(entity));
+      break;
+#endif
+    default:
+      break;
+  }
+}
+void APIConnection::process_pending_states_() {
+  while (this->pending_sent_ < this->pending_states_.size()) {
+    const PendingState pending = this->pending_states_[this->pending_sent_++];
+    const size_t size = this->pending_states_.size();
+    this->send_pending_state_(pending.entity, pending.type);
+    if (this->pending_states_.size() != size)
+      // still no space, the entity was put back into the table
+      break;
   }
-  // bool away = 7;
-  if (traits.get_supports_away()) {
-    buffer.encode_bool(7, climate->away);
+  // the sent entries are removed at once rather than one by one from the front
+  this->pending_states_.erase(this->pending_states_.begin(), this->pending_states_.begin() + this->pending_sent_);
+  this->pending_sent_ = 0;
+}
+static StateEntityType state_entity_type(APIMessageType type) {
+  switch (type) {
+    case APIMessageType::BINARY_SENSOR_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_BINARY_SENSOR;
+    case APIMessageType::COVER_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_COVER;
+    case APIMessageType::FAN_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_FAN;
+    case APIMessageType::LIGHT_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_LIGHT;
+    case APIMessageType::SENSOR_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_SENSOR;
+    case APIMessageType::SWITCH_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_SWITCH;
+    case APIMessageType::TEXT_SENSOR_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_TEXT_SENSOR;
+    case APIMessageType::CLIMATE_STATE_RESPONSE:
+      return STATE_ENTITY_TYPE_CLIMATE;
+    default:
+      return STATE_ENTITY_TYPE_ALL;
   }
-  return this->send_buffer(APIMessageType::CLIMATE_STATE_RESPONSE);
 }
+/// The current numeric state of an entity for deadband checks, NAN if it has none.
+static float numeric_state(Nameable *entity, APIMessageType type) {
+#ifdef USE_SENSOR
+  if (type == APIMessageType::SENSOR_STATE_RESPONSE)
+    return static_cast<sensor::Sensor *>(entity)->state;
 #endif
+  return NAN;
+}
+APIConnection::EntityThrottle *APIConnection::get_entity_throttle_(Nameable *entity, APIMessageType type) {
+  for (auto &throttle : this->entity_throttles_) {
+    if (throttle.entity == entity)
+      return &throttle;
+  }
 
+  // first update of this entity: find the most specific rule (key, then entity type, then all)
+  const uint32_t key = entity->get_object_id_hash();
+  const StateEntityType entity_type = state_entity_type(type);
+  const SubscribeStatesThrottle *rule = nullptr;
+  uint8_t best = 0;
+  for (auto &it : this->throttle_rules_) {
+    uint8_t match = 0;
+    if (it.key != 0) {
+      match = it.key == key ? 3 : 0;
+    } else if (it.entity_type == entity_type) {
+      match = 2;
+    } else if (it.entity_type == STATE_ENTITY_TYPE_ALL) {
+      match = 1;
+    }
+    if (match > best) {
+      best = match;
+      rule = &it;
+    }
+  }
+  this->entity_throttles_.push_back(EntityThrottle{
+      .entity = entity,
+      .type = type,
+      .min_interval = rule != nullptr ? rule->min_interval : 0,
+      .deadband = rule != nullptr ? rule->deadband : 0.0f,
+      .last_sent = 0,
+      .last_value = NAN,
+      .sent = false,
+      .deferred = false,
+  });
+  return &this->entity_throttles_.back();
+}
+bool APIConnection::throttle_state_(Nameable *entity, APIMessageType type, float value) {
+  if (this->throttle_rules_.empty())
+    return false;
+
+  EntityThrottle *throttle = this->get_entity_throttle_(entity, type);
+  const uint32_t now = millis();
+  if (throttle->sent && throttle->min_interval != 0 && now - throttle->last_sent < throttle->min_interval) {
+    // sent from process_throttled_states_() with the then current state
+    throttle->deferred = true;
+    this->throttled_++;
+    return true;
+  }
+  if (throttle->deadband > 0.0f && !isnan(value) && !isnan(throttle->last_value) &&
+      fabsf(value - throttle->last_value) < throttle->deadband) {
+    this->throttled_++;
+    return true;
+  }
+
+  throttle->deferred = false;
+  throttle->sent = true;
+  throttle->last_sent = now;
+  throttle->last_value = value;
+  return false;
+}
+void APIConnection::process_throttled_states_() {
+  const uint32_t now = millis();
+  for (auto &throttle : this->entity_throttles_) {
+    if (!throttle.deferred || now - throttle.last_sent < throttle.min_interval)
+      continue;
+
+    throttle.deferred = false;
+    if (!this->throttle_state_(throttle.entity, throttle.type, numeric_state(throttle.entity, throttle.type)))
+      this->send_pending_state_(throttle.entity, throttle.type);
+  }
+}
 bool APIConnection::send_log_message(int level, const char *tag, const char *line) {
   if (this->log_subscription_ < level)
     return false;
@@ -1007,27 +1227,22 @@ bool APIConnection::send_log_message(int level, const char *tag, const char *lin
     return true;
   }
 }
-bool APIConnection::send_disconnect_request() {
-  DisconnectRequest req;
-  return this->send_message(req);
-}
+bool APIConnection::send_disconnect_request() { return this->send_message(DisconnectRequest()); }
 bool APIConnection::send_ping_request() {
   ESP_LOGVV(TAG, "Sending ping...");
-  PingRequest req;
-  return this->send_message(req);
+  return this->send_message(PingRequest());
 }
 
 #ifdef USE_COVER
 void APIConnection::on_cover_command_request_(const CoverCommandRequest &req) {
   ESP_LOGVV(TAG, "on_cover_command_request_");
-  cover::Cover *cover = App.get_cover_by_key(req.get_key());
+  cover::Cover *cover = App.get_cover_by_key(req.key);
   if (cover == nullptr)
     return;
 
   auto call = cover->make_call();
-  if (req.get_legacy_command().has_value()) {
-    auto cmd = *req.get_legacy_command();
-    switch (cmd) {
+  if (req.has_legacy_command) {
+    switch (req.legacy_command) {
       case LEGACY_COVER_COMMAND_OPEN:
         call.set_command_open();
         break;
@@ -1039,15 +1254,11 @@ void APIConnection::on_cover_command_request_(const CoverCommandRequest &req) {
         break;
     }
   }
-  if (req.get_position().has_value()) {
-    auto pos = *req.get_position();
-    call.set_position(pos);
-  }
-  if (req.get_tilt().has_value()) {
-    auto tilt = *req.get_tilt();
-    call.set_tilt(tilt);
-  }
-  if (req.get_stop()) {
+  if (req.has_position)
+    call.set_position(req.position);
+  if (req.has_tilt)
+    call.set_tilt(req.tilt);
+  if (req.stop) {
     call.set_command_stop();
   }
   call.perform();
@@ -1057,14 +1268,17 @@ void APIConnection::on_cover_command_request_(const CoverCommandRequest &req) {
 #ifdef USE_FAN
 void APIConnection::on_fan_command_request_(const FanCommandRequest &req) {
   ESP_LOGVV(TAG, "on_fan_command_request_");
-  fan::FanState *fan = App.get_fan_by_key(req.get_key());
+  fan::FanState *fan = App.get_fan_by_key(req.key);
   if (fan == nullptr)
     return;
 
   auto call = fan->make_call();
-  call.set_state(req.get_state());
-  call.set_oscillating(req.get_oscillating());
-  call.set_speed(req.get_speed());
+  if (req.has_state)
+    call.set_state(req.state);
+  if (req.has_oscillating)
+    call.set_oscillating(req.oscillating);
+  if (req.has_speed)
+    call.set_speed(static_cast<fan::FanSpeed>(req.speed));
   call.perform();
 }
 #endif
@@ -1072,21 +1286,30 @@ void APIConnection::on_fan_command_request_(const FanCommandRequest &req) {
 #ifdef USE_LIGHT
 void APIConnection::on_light_command_request_(const LightCommandRequest &req) {
   ESP_LOGVV(TAG, "on_light_command_request_");
-  light::LightState *light = App.get_light_by_key(req.get_key());
+  light::LightState *light = App.get_light_by_key(req.key);
   if (light == nullptr)
     return;
 
   auto call = light->make_call();
-  call.set_state(req.get_state());
-  call.set_brightness(req.get_brightness());
-  call.set_red(req.get_red());
-  call.set_green(req.get_green());
-  call.set_blue(req.get_blue());
-  call.set_white(req.get_white());
-  call.set_color_temperature(req.get_color_temperature());
-  call.set_transition_length(req.get_transition_length());
-  call.set_flash_length(req.get_flash_length());
-  call.set_effect(req.get_effect());
+  if (req.has_state)
+    call.set_state(req.state);
+  if (req.has_brightness)
+    call.set_brightness(req.brightness);
+  if (req.has_rgb) {
+    call.set_red(req.red);
+    call.set_green(req.green);
+    call.set_blue(req.blue);
+  }
+  if (req.has_white)
+    call.set_white(req.white);
+  if (req.has_color_temperature)
+    call.set_color_temperature(req.color_temperature);
+  if (req.has_transition_length)
+    call.set_transition_length(req.transition_length);
+  if (req.has_flash_length)
+    call.set_flash_length(req.flash_length);
+  if (req.has_effect)
+    call.set_effect(req.effect);
   call.perform();
 }
 #endif
@@ -1094,11 +1317,11 @@ void APIConnection::on_light_command_request_(const LightCommandRequest &req) {
 #ifdef USE_SWITCH
 void APIConnection::on_switch_command_request_(const SwitchCommandRequest &req) {
   ESP_LOGVV(TAG, "on_switch_command_request_");
-  switch_::Switch *a_switch = App.get_switch_by_key(req.get_key());
+  switch_::Switch *a_switch = App.get_switch_by_key(req.key);
   if (a_switch == nullptr || a_switch->is_internal())
     return;
 
-  if (req.get_state()) {
+  if (req.state) {
     a_switch->turn_on();
   } else {
     a_switch->turn_off();
@@ -1109,21 +1332,21 @@ void APIConnection::on_switch_command_request_(const SwitchCommandRequest &req)
 #ifdef USE_CLIMATE
 void APIConnection::on_climate_command_request_(const ClimateCommandRequest &req) {
   ESP_LOGVV(TAG, "on_climate_command_request_");
-  climate::Climate *climate = App.get_climate_by_key(req.get_key());
+  climate::Climate *climate = App.get_climate_by_key(req.key);
   if (climate == nullptr)
     return;
 
   auto call = climate->make_call();
-  if (req.get_mode().has_value())
-    call.set_mode(*req.get_mode());
-  if (req.get_target_temperature().has_value())
-    call.set_target_temperature(*req.get_target_temperature());
-  if (req.get_target_temperature_low().has_value())
-    call.set_target_temperature_low(*req.get_target_temperature_low());
-  if (req.get_target_temperature_high().has_value())
-    call.set_target_temperature_high(*req.get_target_temperature_high());
-  if (req.get_away().has_value())
-    call.set_away(*req.get_away());
+  if (req.has_mode)
+    call.set_mode(static_cast<climate::ClimateMode>(req.mode));
+  if (req.has_target_temperature)
+    call.set_target_temperature(req.target_temperature);
+  if (req.has_target_temperature_low)
+    call.set_target_temperature_low(req.target_temperature_low);
+  if (req.has_target_temperature_high)
+    call.set_target_temperature_high(req.target_temperature_high);
+  if (req.has_away)
+    call.set_away(req.away);
   call.perform();
 }
 #endif
@@ -1131,7 +1354,7 @@ void APIConnection::on_climate_command_request_(const ClimateCommandRequest &req
 void APIConnection::on_subscribe_service_calls_request_(const SubscribeServiceCallsRequest &req) {
   this->service_call_subscription_ = true;
 }
-void APIConnection::send_service_call(ServiceCallResponse &call) {
+void APIConnection::send_service_call(const ServiceCallResponse &call) {
   if (!this->service_call_subscription_)
     return;
 
@@ -1139,18 +1362,13 @@ void APIConnection::send_service_call(ServiceCallResponse &call) {
 }
 void APIConnection::on_subscribe_home_assistant_states_request_(const SubscribeHomeAssistantStatesRequest &req) {
   for (auto &it : this->parent_->get_state_subs()) {
-    auto buffer = this->get_buffer();
-    // string entity_id = 1;
-    buffer.encode_string(1, it.entity_id);
-    this->send_buffer(APIMessageType::SUBSCRIBE_HOME_ASSISTANT_STATE_RESPONSE);
+    SubscribeHomeAssistantStateResponse resp;
+    resp.entity_id = it.entity_id;
+    this->send_message(resp);
   }
 }
 void APIConnection::on_home_assistant_state_response_(const HomeAssistantStateResponse &req) {
-  for (auto &it : this->parent_->get_state_subs()) {
-    if (it.entity_id == req.get_entity_id()) {
-      it.callback(req.get_state());
-    }
-  }
+  this->parent_->on_home_assistant_state(req.entity_id, req.state);
 }
 void APIConnection::on_execute_service_(const ExecuteServiceRequest &req) {
   ESP_LOGVV(TAG, "on_execute_service_");
@@ -1171,16 +1389,54 @@ APIBuffer APIConnection::get_buffer() {
 }
 #ifdef USE_HOMEASSISTANT_TIME
 void APIConnection::send_time_request() { this->send_empty_message(APIMessageType::GET_TIME_REQUEST); }
+void APIConnection::on_get_time_response_(const GetTimeResponse &resp) {
+  if (homeassistant::global_homeassistant_time != nullptr)
+    homeassistant::global_homeassistant_time->set_epoch_time(resp.epoch_seconds);
+}
 #endif
 
 #ifdef USE_ESP32_CAMERA
 void APIConnection::send_camera_state(std::shared_ptr<esp32_camera::CameraImage> image) {
   if (!this->state_subscription_)
     return;
-  if (this->image_reader_.available())
+  // skip frames while this client is still behind with the previous one
+  if (this->image_reader_.available() || this->camera_data_in_flight_())
     return;
   this->image_reader_.set_image(image);
 }
+void APIConnection::send_camera_chunk_(uint32_t max_len) {
+  const uint32_t to_send = std::min<uint32_t>(max_len, this->image_reader_.available());
+  const bool done = this->image_reader_.available() == to_send;
+
+  // CameraImageResponse fields around the image data: fixed32 key = 1; bytes data = 2; bool done = 3;
+  auto buffer = this->get_buffer();
+  buffer.encode_fixed32(1, esp32_camera::global_esp32_camera->get_object_id_hash());
+  buffer.encode_field_raw(2, 2);
+  buffer.encode_varint_raw(to_send);
+  const size_t prefix_len = this->send_buffer_.size();
+  buffer.encode_bool(3, done);
+  const size_t suffix_len = this->send_buffer_.size() - prefix_len;
+
+  uint8_t header[20];
+  header[0] = 0x00;
+  uint8_t header_len = 1;
+  encode_varint(header + header_len, &header_len, prefix_len + to_send + suffix_len);
+  encode_varint(header + header_len, &header_len, static_cast<uint32_t>(APIMessageType::CAMERA_IMAGE_RESPONSE));
+
+  this->write_(header, header_len);
+  this->write_(this->send_buffer_.data(), prefix_len);
+  // no copy, the image is kept alive until this data has been acknowledged
+  this->write_(this->image_reader_.peek_data_buffer(), to_send, false);
+  this->image_release_at_ = this->tx_queued_;
+  this->write_(this->send_buffer_.data() + prefix_len, suffix_len);
+  this->client_->send();
+
+  this->image_reader_.consume_data(to_send);
+  if (done) {
+    this->image_in_flight_ = this->image_reader_.get_image();
+    this->image_reader_.return_image();
+  }
+}
 #endif
 
 #ifdef USE_ESP32_CAMERA
@@ -1188,15 +1444,140 @@ void APIConnection::on_camera_image_request_(const CameraImageRequest &req) {
   if (esp32_camera::global_esp32_camera == nullptr)
     return;
 
-  ESP_LOGV(TAG, "on_camera_image_request_ stream=%s single=%s", YESNO(req.get_stream()), YESNO(req.get_single()));
-  if (req.get_single()) {
+  ESP_LOGV(TAG, "on_camera_image_request_ stream=%s single=%s", YESNO(req.stream), YESNO(req.single));
+  if (req.single) {
     esp32_camera::global_esp32_camera->request_image();
   }
-  if (req.get_stream()) {
+  if (req.stream) {
     esp32_camera::global_esp32_camera->request_stream();
   }
 }
 #endif
+#ifdef USE_SENSOR_HISTORY
+/// Points per SensorHistoryResponse, a full message stays well below the TCP buffer size.
+static const uint32_t HISTORY_CHUNK_POINTS = 64;
+
+static void append_varint(std::string &out, uint32_t value) {
+  while (value >= 0x80) {
+    out += char(value | 0x80);
+    value >>= 7;
+  }
+  out += char(value);
+}
+static uint32_t zigzag(int32_t value) { return (uint32_t(value) << 1) ^ uint32_t(value >> 31); }
+
+void APIConnection::on_sensor_history_request_(const SensorHistoryRequest &req) {
+  ESP_LOGV(TAG, "on_sensor_history_request_ key=%u tier=%u max_age=%u", req.key, req.tier, req.max_age);
+  // a new request replaces one that is still being answered
+  HistoryQuery &query = this->history_query_;
+  sensor::Sensor *sensor = App.get_sensor_by_key(req.key);
+  query.key = req.key;
+  query.tier = req.tier;
+  query.history = sensor == nullptr ? nullptr : sensor->get_history();
+  query.request_time = sensor::SensorHistory::uptime();
+  query.max_age = req.max_age;
+  query.end_seq = 0;
+  query.time = 0;
+  query.active = true;
+  if (query.history == nullptr)
+    return;
+
+  switch (req.tier) {
+    case SENSOR_HISTORY_TIER_RAW:
+      query.end_seq = query.history->get_raw().end_seq();
+      query.time = query.history->get_raw_newest_time();
+      break;
+    case SENSOR_HISTORY_TIER_MINUTES:
+    case SENSOR_HISTORY_TIER_HOURS: {
+      const sensor::HistoryTier &tier =
+          req.tier == SENSOR_HISTORY_TIER_MINUTES ? query.history->get_minutes() : query.history->get_hours();
+      query.end_seq = tier.ring.end_seq();
+      // the ring ends where the period that is being accumulated starts
+      query.time = tier.current * tier.period;
+      break;
+    }
+    default:
+      break;
+  }
+}
+bool APIConnection::encode_history_raw_(HistoryQuery &query, const sensor::SensorHistory *history,
+                                        std::string &points) {
+  const sensor::HistoryRing<sensor::HistoryRawPoint> &ring = history->get_raw();
+  int32_t previous = 0;
+  uint32_t gap = 0;
+  for (uint32_t i = 0; i < HISTORY_CHUNK_POINTS; i++) {
+    // points that were overwritten since the request are gone
+    if (query.end_seq <= ring.begin_seq())
+      return true;
+    if (query.max_age != 0 && query.request_time - query.time > query.max_age)
+      return true;
+    const sensor::HistoryRawPoint &point = ring.at(query.end_seq - 1);
+    append_varint(points, gap);
+    append_varint(points, zigzag(point.value - previous));
+    previous = point.value;
+    gap = point.delta;
+    query.time -= gap;
+    query.end_seq--;
+  }
+  return query.end_seq <= ring.begin_seq();
+}
+bool APIConnection::encode_history_tier_(HistoryQuery &query, const sensor::HistoryTier &tier, std::string &points) {
+  int32_t previous = 0;
+  for (uint32_t i = 0; i < HISTORY_CHUNK_POINTS; i++) {
+    if (query.end_seq <= tier.ring.begin_seq())
+      return true;
+    if (query.max_age != 0 && query.request_time - query.time >= query.max_age)
+      return true;
+    const sensor::HistoryAggregate &aggregate = tier.ring.at(query.end_seq - 1);
+    if (aggregate.avg == sensor::HISTORY_NO_VALUE) {
+      append_varint(points, 0);
+    } else {
+      append_varint(points, zigzag(aggregate.avg - previous) + 1);
+      append_varint(points, std::max(aggregate.avg - aggregate.min, 0));
+      append_varint(points, std::max(aggregate.max - aggregate.avg, 0));
+      previous = aggregate.avg;
+    }
+    query.time -= tier.period;
+    query.end_seq--;
+  }
+  return query.end_seq <= tier.ring.begin_seq();
+}
+void APIConnection::process_history_query_() {
+  if (!this->history_query_.active)
+    return;
+
+  // only commit the progress once the message is out
+  HistoryQuery query = this->history_query_;
+  SensorHistoryResponse resp;
+  resp.key = query.key;
+  resp.tier = query.tier;
+  resp.done = true;
+  if (query.history != nullptr) {
+    resp.age = query.request_time - query.time;
+    resp.base = query.history->get_base();
+    resp.resolution = query.history->get_resolution();
+    switch (query.tier) {
+      case SENSOR_HISTORY_TIER_RAW:
+        resp.done = encode_history_raw_(query, query.history, resp.points);
+        break;
+      case SENSOR_HISTORY_TIER_MINUTES:
+        resp.period = query.history->get_minutes().period;
+        resp.done = encode_history_tier_(query, query.history->get_minutes(), resp.points);
+        break;
+      case SENSOR_HISTORY_TIER_HOURS:
+        resp.period = query.history->get_hours().period;
+        resp.done = encode_history_tier_(query, query.history->get_hours(), resp.points);
+        break;
+      default:
+        break;
+    }
+  }
+  if (!this->send_message(resp))
+    return;
+  query.active = !resp.done;
+  this->history_query_ = query;
+}
+#endif
 
 }  // namespace api
 }  // namespace esphome
@@ -5,12 +5,9 @@
 #include "esphome/core/defines.h"
 #include "esphome/core/log.h"
 #include "util.h"
-#include "api_message.h"
-#include "basic_messages.h"
+#include "api_pb2.h"
 #include "list_entities.h"
 #include "subscribe_state.h"
-#include "subscribe_logs.h"
-#include "command_messages.h"
 #include "service_call_message.h"
 #include "user_services.h"
 
@@ -33,8 +30,11 @@ class APIConnection {
 
   void disconnect_client();
   APIBuffer get_buffer();
-  bool send_buffer(APIMessageType type);
-  bool send_message(APIMessage &msg);
+  bool send_buffer(APIMessageType type) { return this->send_payload_(type, this->send_buffer_); }
+  template<typename T> bool send_message(const T &msg) {
+    this->encode_message_(msg);
+    return this->send_buffer(T::MESSAGE_TYPE);
+  }
   bool send_empty_message(APIMessageType type);
   void loop();
 
@@ -68,7 +68,7 @@ class APIConnection {
   bool send_log_message(int level, const char *tag, const char *line);
   bool send_disconnect_request();
   bool send_ping_request();
-  void send_service_call(ServiceCallResponse &call);
+  void send_service_call(const ServiceCallResponse &call);
 #ifdef USE_HOMEASSISTANT_TIME
   void send_time_request();
 #endif
@@ -80,10 +80,57 @@ class APIConnection {
   void on_disconnect_();
   void on_timeout_(uint32_t time);
   void on_data_(uint8_t *buf, size_t len);
+  void on_ack_(size_t len);
   void fatal_error_();
   bool valid_rx_message_type_(uint32_t msg_type);
-  void read_message_(uint32_t size, uint32_t type, uint8_t *msg);
+  void read_message_(uint32_t size, uint32_t type, const uint8_t *msg);
+
+  /// Dispatch table entry for a received message type, indexed by the type ID.
+  struct MessageHandler {
+    /// Decodes the message and calls the on_*_ method, nullptr for messages that are ignored.
+    void (*handle)(APIConnection *conn, const uint8_t *msg, uint32_t size);
+    /// Bitmask of the connection states (1 << ConnectionState) in which the message is accepted.
+    uint8_t allowed_states;
+  };
+  static const MessageHandler MESSAGE_HANDLERS[];
+  static MessageHandler get_message_handler_(uint32_t type);
+  template<typename T, void (APIConnection::*H)(const T &)>
+  static void handle_message_(APIConnection *conn, const uint8_t *msg, uint32_t size);
   void parse_recv_buffer_();
+  /// Handle the complete messages in recv_buffer_, returns the number of bytes taken out of it.
+  uint32_t parse_messages_();
+  /// Queue a message on the connection, returns false if the TCP buffer has no room for it.
+  bool send_payload_(APIMessageType type, const std::vector<uint8_t> &payload);
+  /// Queue data on the TCP connection. Without copy, data must stay valid until the peer acknowledged it.
+  void write_(const void *data, size_t len, bool copy = true);
+#ifdef USE_ESP32_CAMERA
+  /// Send the next chunk of the current camera image, referencing the frame buffer directly.
+  void send_camera_chunk_(uint32_t max_len);
+  /// Whether camera data queued without copying still waits for a TCP acknowledgement.
+  bool camera_data_in_flight_() const { return int32_t(this->tx_acked_ - this->image_release_at_) < 0; }
+#endif
+  /// Encode msg into send_buffer_, the buffer is sized exactly once up front.
+  template<typename T> void encode_message_(const T &msg) {
+    this->send_buffer_.clear();
+    this->send_buffer_.reserve(proto_size(msg));
+    APIBuffer buffer(&this->send_buffer_);
+    proto_encode(msg, buffer);
+  }
+  template<typename T> bool send_state_message_(Nameable *entity, const T &msg) {
+    this->encode_message_(msg);
+    return this->send_state_payload_(entity, T::MESSAGE_TYPE, this->send_buffer_);
+  }
+  /// Send an encoded state message, or remember the entity as pending if there's no TCP buffer space.
+  bool send_state_payload_(Nameable *entity, APIMessageType type, const std::vector<uint8_t> &payload);
+  /// Whether a state message for this entity is still waiting for TCP buffer space (and coalesce it if so).
+  bool coalesce_pending_state_(Nameable *entity);
+  void send_pending_state_(Nameable *entity, APIMessageType type);
+  void process_pending_states_();
+  struct EntityThrottle;
+  EntityThrottle *get_entity_throttle_(Nameable *entity, APIMessageType type);
+  /// Whether the client's throttle rules hold back this state update, held back updates are sent from loop().
+  bool throttle_state_(Nameable *entity, APIMessageType type, float value);
+  void process_throttled_states_();
 
   // request types
   void on_hello_request_(const HelloRequest &req);
@@ -95,6 +142,8 @@ class APIConnection {
   void on_device_info_request_(const DeviceInfoRequest &req);
   void on_list_entities_request_(const ListEntitiesRequest &req);
   void on_subscribe_states_request_(const SubscribeStatesRequest &req);
+  /// Send as many complete messages of the entity catalog as fit into the TCP buffer.
+  void process_list_entities_();
   void on_subscribe_logs_request_(const SubscribeLogsRequest &req);
 #ifdef USE_COVER
   void on_cover_command_request_(const CoverCommandRequest &req);
@@ -115,9 +164,22 @@ class APIConnection {
   void on_subscribe_home_assistant_states_request_(const SubscribeHomeAssistantStatesRequest &req);
   void on_home_assistant_state_response_(const HomeAssistantStateResponse &req);
   void on_execute_service_(const ExecuteServiceRequest &req);
+#ifdef USE_HOMEASSISTANT_TIME
+  void on_get_time_response_(const GetTimeResponse &resp);
+#endif
 #ifdef USE_ESP32_CAMERA
   void on_camera_image_request_(const CameraImageRequest &req);
 #endif
+#ifdef USE_SENSOR_HISTORY
+  void on_sensor_history_request_(const SensorHistoryRequest &req);
+  struct HistoryQuery;
+  /// Send the next chunk of the sensor history query, if there's TCP buffer space.
+  void process_history_query_();
+  /// Append the next raw points of the query to points, returns true once all are encoded.
+  static bool encode_history_raw_(HistoryQuery &query, const sensor::SensorHistory *history, std::string &points);
+  /// Append the next periods of an aggregate tier to points, returns true once all are encoded.
+  static bool encode_history_tier_(HistoryQuery &query, const sensor::HistoryTier &tier, std::string &points);
+#endif
 
   enum class ConnectionState {
     WAITING_FOR_HELLO,
@@ -127,12 +189,53 @@ class APIConnection {
 
   bool remove_{false};
 
+  /// A state message that could not be sent because of TCP buffer space.
+  struct PendingState {
+    Nameable *entity;
+    APIMessageType type;
+  };
+  /// Entities with unsent state, at most one entry per entity. Drained from loop() with the entity's latest state.
+  std::vector<PendingState> pending_states_;
+  /// Number of entries at the front of pending_states_ already sent by the running process_pending_states_().
+  size_t pending_sent_{0};
+  uint32_t pending_coalesced_{0};
+  uint32_t pending_dropped_{0};
+
+  /// Throttle settings and state of an entity, resolved from the client's rules on its first update.
+  struct EntityThrottle {
+    Nameable *entity;
+    APIMessageType type;
+    uint32_t min_interval;
+    float deadband;
+    uint32_t last_sent;
+    float last_value;
+    bool sent;
+    /// An update was held back by min_interval and is still due.
+    bool deferred;
+  };
+  std::vector<SubscribeStatesThrottle> throttle_rules_;
+  std::vector<EntityThrottle> entity_throttles_;
+  uint32_t throttled_{0};
+
   std::vector<uint8_t> send_buffer_;
-  std::vector<uint8_t> recv_buffer_;
+  APIRecvBuffer recv_buffer_;
+  /// Messages that wrap around the end of recv_buffer_, or that are being assembled because they don't fit into it.
+  std::vector<uint8_t> recv_scratch_;
+  /// Bytes still missing of the message that is assembled in recv_scratch_, 0 if there is none.
+  uint32_t large_message_remaining_{0};
+  uint32_t large_message_type_{0};
+  bool recv_overflow_{false};
 
   std::string client_info_;
+  /// Total bytes queued on / acknowledged by the TCP connection (wrapping).
+  uint32_t tx_queued_{0};
+  volatile uint32_t tx_acked_{0};
 #ifdef USE_ESP32_CAMERA
   esp32_camera::CameraImageReader image_reader_;
+  /// Fully queued image, kept alive until its data has been acknowledged.
+  std::shared_ptr<esp32_camera::CameraImage> image_in_flight_;
+  /// Value of tx_queued_ after the last queued camera data.
+  uint32_t image_release_at_{0};
 #endif
 
   bool state_subscription_{false};
@@ -143,7 +246,26 @@ class APIConnection {
   AsyncClient *client_;
   APIServer *parent_;
   InitialStateIterator initial_state_iterator_;
-  ListEntitiesIterator list_entities_iterator_;
+  bool listing_entities_{false};
+  /// Bytes of the entity catalog sent so far.
+  size_t list_entities_sent_{0};
+#ifdef USE_SENSOR_HISTORY
+  /// The sensor history request that is being answered, its points are sent newest first from loop().
+  struct HistoryQuery {
+    uint32_t key;
+    SensorHistoryTier tier;
+    /// nullptr if the sensor doesn't exist or doesn't keep a history.
+    const sensor::SensorHistory *history;
+    /// Uptime in seconds when the request arrived, ages are relative to it.
+    uint32_t request_time;
+    uint32_t max_age;
+    /// Sequence number one past the next point to send, counts down.
+    uint32_t end_seq;
+    /// Uptime of the next point, for the aggregate tiers the end of its period.
+    uint32_t time;
+    bool active;
+  } history_query_{};
+#endif
 };
 
 template<typename... Ts> class HomeAssistantServiceCallAction;
@@ -187,7 +309,7 @@ class APIServer : public Component, public Controller {
 #ifdef USE_CLIMATE
   void on_climate_update(climate::Climate *obj) override;
 #endif
-  void send_service_call(ServiceCallResponse &call);
+  void send_service_call(const ServiceCallResponse &call);
   void register_user_service(UserServiceDescriptor *descriptor) { this->user_services_.push_back(descriptor); }
 #ifdef USE_HOMEASSISTANT_TIME
   void request_time();
@@ -197,14 +319,42 @@ class APIServer : public Component, public Controller {
 
   struct HomeAssistantStateSubscription {
     std::string entity_id;
+    uint32_t entity_id_hash;
     std::function<void(std::string)> callback;
   };
 
   void subscribe_home_assistant_state(std::string entity_id, std::function<void(std::string)> f);
+  /// Get the subscriptions, sorted by entity_id_hash.
   const std::vector<HomeAssistantStateSubscription> &get_state_subs() const;
+  /// Pass a state received from Home Assistant to the subscribers of entity_id.
+  void on_home_assistant_state(const std::string &entity_id, const std::string &state);
   const std::vector<UserServiceDescriptor *> &get_user_services() const { return this->user_services_; }
+  /// Get the serialized ListEntities response stream, built on first use.
+  const std::vector<uint8_t> &get_list_entities_catalog();
 
  protected:
+  /** Send a state update to all subscribed clients.
+   *
+   * The message is encoded only once (and only if some client takes it), every client then copies the same
+   * payload into its TCP buffer. value is the numeric state for deadband throttling, NAN if there is none.
+   */
+  template<typename T> void broadcast_state_message_(Nameable *entity, const T &msg, float value = NAN) {
+    bool encoded = false;
+    for (auto *c : this->clients_) {
+      if (!c->state_subscription_ || c->coalesce_pending_state_(entity) ||
+          c->throttle_state_(entity, T::MESSAGE_TYPE, value))
+        continue;
+      if (!encoded) {
+        this->state_buffer_.clear();
+        this->state_buffer_.reserve(proto_size(msg));
+        APIBuffer buffer(&this->state_buffer_);
+        proto_encode(msg, buffer);
+        encoded = true;
+      }
+      c->send_state_payload_(entity, T::MESSAGE_TYPE, this->state_buffer_);
+    }
+  }
+
   AsyncServer server_{0};
   uint16_t port_{6053};
   uint32_t reboot_timeout_{300000};
@@ -213,6 +363,9 @@ class APIServer : public Component, public Controller {
   std::string password_;
   std::vector<HomeAssistantStateSubscription> state_subs_;
   std::vector<UserServiceDescriptor *> user_services_;
+  /// Shared encode buffer for broadcast_state_message_().
+  std::vector<uint8_t> state_buffer_;
+  std::vector<uint8_t> list_entities_catalog_;
 };
 
 extern APIServer *global_api_server;
@@ -220,17 +373,28 @@ extern APIServer *global_api_server;
 template<typename... Ts> class HomeAssistantServiceCallAction : public Action<Ts...> {
  public:
   explicit HomeAssistantServiceCallAction(APIServer *parent) : parent_(parent) {}
-  void set_service(const std::string &service) { this->resp_.set_service(service); }
-  void set_data(const std::vector<KeyValuePair> &data) { this->resp_.set_data(data); }
-  void set_data_template(const std::vector<KeyValuePair> &data_template) {
-    this->resp_.set_data_template(data_template);
+  void set_service(const std::string &service) { this->service_ = service; }
+  void set_data(const std::vector<KeyValuePair> &data) { this->data_ = data; }
+  void set_data_template(const std::vector<KeyValuePair> &data_template) { this->data_template_ = data_template; }
+  void set_variables(const std::vector<TemplatableKeyValuePair> &variables) { this->variables_ = variables; }
+  void play(Ts... x) override {
+    ServiceCallResponse resp;
+    resp.service = this->service_;
+    for (auto &it : this->data_)
+      resp.data.push_back(ServiceCallMap{.key = it.key, .value = it.value});
+    for (auto &it : this->data_template_)
+      resp.data_template.push_back(ServiceCallMap{.key = it.key, .value = it.value});
+    for (auto &it : this->variables_)
+      resp.variables.push_back(ServiceCallMap{.key = it.key, .value = it.value()});
+    this->parent_->send_service_call(resp);
   }
-  void set_variables(const std::vector<TemplatableKeyValuePair> &variables) { this->resp_.set_variables(variables); }
-  void play(Ts... x) override { this->parent_->send_service_call(this->resp_); }
 
  protected:
   APIServer *parent_;
-  ServiceCallResponse resp_;
+  std::string service_;
+  std::vector<KeyValuePair> data_;
+  std::vector<KeyValuePair> data_template_;
+  std::vector<TemplatableKeyValuePair> variables_;
 };
 
 template<typename... Ts> class APIConnectedCondition : public Condition<Ts...> {
@@ -9,182 +9,148 @@ namespace api {
 std::string get_default_unique_id(const std::string &component_type, Nameable *nameable) {
   return App.get_name() + component_type + nameable->get_object_id();
 }
+template<typename T> void fill_nameable(T &msg, Nameable *nameable) {
+  msg.object_id = nameable->get_object_id();
+  msg.key = nameable->get_object_id_hash();
+  msg.name = nameable->get_name();
+}
+template<typename T> bool ListEntitiesIterator::append_(const T &msg) {
+  // same framing as APIConnection::send_buffer(): preamble, payload size, message type
+  APIBuffer buffer(this->catalog_);
+  buffer.write(0x00);
+  buffer.encode_varint_raw(proto_size(msg));
+  buffer.encode_varint_raw(static_cast<uint32_t>(T::MESSAGE_TYPE));
+  proto_encode(msg, buffer);
+  return true;
+}
 
 #ifdef USE_BINARY_SENSOR
 bool ListEntitiesIterator::on_binary_sensor(binary_sensor::BinarySensor *binary_sensor) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(binary_sensor);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("binary_sensor", binary_sensor));
-  // string device_class = 5;
-  buffer.encode_string(5, binary_sensor->get_device_class());
-  // bool is_status_binary_sensor = 6;
-  buffer.encode_bool(6, binary_sensor->is_status_binary_sensor());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_BINARY_SENSOR_RESPONSE);
+  ListEntitiesBinarySensorResponse msg;
+  fill_nameable(msg, binary_sensor);
+  msg.unique_id = get_default_unique_id("binary_sensor", binary_sensor);
+  msg.device_class = binary_sensor->get_device_class();
+  msg.is_status_binary_sensor = binary_sensor->is_status_binary_sensor();
+  return this->append_(msg);
 }
 #endif
 #ifdef USE_COVER
 bool ListEntitiesIterator::on_cover(cover::Cover *cover) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(cover);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("cover", cover));
+  ListEntitiesCoverResponse msg;
+  fill_nameable(msg, cover);
+  msg.unique_id = get_default_unique_id("cover", cover);
   auto traits = cover->get_traits();
-
-  // bool assumed_state = 5;
-  buffer.encode_bool(5, traits.get_is_assumed_state());
-  // bool supports_position = 6;
-  buffer.encode_bool(6, traits.get_supports_position());
-  // bool supports_tilt = 7;
-  buffer.encode_bool(7, traits.get_supports_tilt());
-  // string device_class = 8;
-  buffer.encode_string(8, cover->get_device_class());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_COVER_RESPONSE);
+  msg.assumed_state = traits.get_is_assumed_state();
+  msg.supports_position = traits.get_supports_position();
+  msg.supports_tilt = traits.get_supports_tilt();
+  msg.device_class = cover->get_device_class();
+  return this->append_(msg);
 }
 #endif
 #ifdef USE_FAN
 bool ListEntitiesIterator::on_fan(fan::FanState *fan) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(fan);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("fan", fan));
-  // bool supports_oscillation = 5;
-  buffer.encode_bool(5, fan->get_traits().supports_oscillation());
-  // bool supports_speed = 6;
-  buffer.encode_bool(6, fan->get_traits().supports_speed());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_FAN_RESPONSE);
+  ListEntitiesFanResponse msg;
+  fill_nameable(msg, fan);
+  msg.unique_id = get_default_unique_id("fan", fan);
+  msg.supports_oscillation = fan->get_traits().supports_oscillation();
+  msg.supports_speed = fan->get_traits().supports_speed();
+  return this->append_(msg);
 }
 #endif
 #ifdef USE_LIGHT
 bool ListEntitiesIterator::on_light(light::LightState *light) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(light);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("light", light));
-  // bool supports_brightness = 5;
+  ListEntitiesLightResponse msg;
+  fill_nameable(msg, light);
+  msg.unique_id = get_default_unique_id("light", light);
   auto traits = light->get_traits();
-  buffer.encode_bool(5, traits.get_supports_brightness());
-  // bool supports_rgb = 6;
-  buffer.encode_bool(6, traits.get_supports_rgb());
-  // bool supports_white_value = 7;
-  buffer.encode_bool(7, traits.get_supports_rgb_white_value());
-  // bool supports_color_temperature = 8;
-  buffer.encode_bool(8, traits.get_supports_color_temperature());
+  msg.supports_brightness = traits.get_supports_brightness();
+  msg.supports_rgb = traits.get_supports_rgb();
+  msg.supports_white_value = traits.get_supports_rgb_white_value();
+  msg.supports_color_temperature = traits.get_supports_color_temperature();
   if (traits.get_supports_color_temperature()) {
-    // float min_mireds = 9;
-    buffer.encode_float(9, traits.get_min_mireds());
-    // float max_mireds = 10;
-    buffer.encode_float(10, traits.get_max_mireds());
+    msg.min_mireds = traits.get_min_mireds();
+    msg.max_mireds = traits.get_max_mireds();
   }
-  // repeated string effects = 11;
   if (light->supports_effects()) {
-    buffer.encode_string(11, "None");
-    for (auto *effect : light->get_effects()) {
-      buffer.encode_string(11, effect->get_name());
-    }
+    msg.effects.push_back("None");
+    for (auto *effect : light->get_effects())
+      msg.effects.push_back(effect->get_name());
   }
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_LIGHT_RESPONSE);
+  return this->append_(msg);
 }
 #endif
 #ifdef USE_SENSOR
 bool ListEntitiesIterator::on_sensor(sensor::Sensor *sensor) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(sensor);
-  // string unique_id = 4;
-  std::string unique_id = sensor->unique_id();
-  if (unique_id.empty())
-    unique_id = get_default_unique_id("sensor", sensor);
-  buffer.encode_string(4, unique_id);
-  // string icon = 5;
-  buffer.encode_string(5, sensor->get_icon());
-  // string unit_of_measurement = 6;
-  buffer.encode_string(6, sensor->get_unit_of_measurement());
-  // int32 accuracy_decimals = 7;
-  buffer.encode_int32(7, sensor->get_accuracy_decimals());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_SENSOR_RESPONSE);
+  ListEntitiesSensorResponse msg;
+  fill_nameable(msg, sensor);
+  msg.unique_id = sensor->unique_id();
+  if (msg.unique_id.empty())
+    msg.unique_id = get_default_unique_id("sensor", sensor);
+  msg.icon = sensor->get_icon();
+  msg.unit_of_measurement = sensor->get_unit_of_measurement();
+  msg.accuracy_decimals = sensor->get_accuracy_decimals();
+  return this->append_(msg);
 }
 #endif
 #ifdef USE_SWITCH
 bool ListEntitiesIterator::on_switch(switch_::Switch *a_switch) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(a_switch);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("switch", a_switch));
-  // string icon = 5;
-  buffer.encode_string(5, a_switch->get_icon());
-  // bool assumed_state = 6;
-  buffer.encode_bool(6, a_switch->assumed_state());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_SWITCH_RESPONSE);
+  ListEntitiesSwitchResponse msg;
+  fill_nameable(msg, a_switch);
+  msg.unique_id = get_default_unique_id("switch", a_switch);
+  msg.icon = a_switch->get_icon();
+  msg.assumed_state = a_switch->assumed_state();
+  return this->append_(msg);
 }
 #endif
 #ifdef USE_TEXT_SENSOR
 bool ListEntitiesIterator::on_text_sensor(text_sensor::TextSensor *text_sensor) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(text_sensor);
-  // string unique_id = 4;
-  std::string unique_id = text_sensor->unique_id();
-  if (unique_id.empty())
-    unique_id = get_default_unique_id("text_sensor", text_sensor);
-  buffer.encode_string(4, unique_id);
-  // string icon = 5;
-  buffer.encode_string(5, text_sensor->get_icon());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_TEXT_SENSOR_RESPONSE);
+  ListEntitiesTextSensorResponse msg;
+  fill_nameable(msg, text_sensor);
+  msg.unique_id = text_sensor->unique_id();
+  if (msg.unique_id.empty())
+    msg.unique_id = get_default_unique_id("text_sensor", text_sensor);
+  msg.icon = text_sensor->get_icon();
+  return this->append_(msg);
 }
 #endif
 
-bool ListEntitiesIterator::on_end() {
-  return this->client_->send_empty_message(APIMessageType::LIST_ENTITIES_DONE_RESPONSE);
-}
-ListEntitiesIterator::ListEntitiesIterator(APIServer *server, APIConnection *client)
-    : ComponentIterator(server), client_(client) {}
+bool ListEntitiesIterator::on_end() { return this->append_(ListEntitiesDoneResponse()); }
+ListEntitiesIterator::ListEntitiesIterator(APIServer *server, std::vector<uint8_t> *catalog)
+    : ComponentIterator(server), catalog_(catalog) {}
 bool ListEntitiesIterator::on_service(UserServiceDescriptor *service) {
-  auto buffer = this->client_->get_buffer();
-  service->encode_list_service_response(buffer);
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_SERVICE_RESPONSE);
+  return this->append_(service->encode_list_service_response());
 }
 
 #ifdef USE_ESP32_CAMERA
 bool ListEntitiesIterator::on_camera(esp32_camera::ESP32Camera *camera) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(camera);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("camera", camera));
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_CAMERA_RESPONSE);
+  ListEntitiesCameraResponse msg;
+  fill_nameable(msg, camera);
+  msg.unique_id = get_default_unique_id("camera", camera);
+  return this->append_(msg);
 }
 #endif
 
 #ifdef USE_CLIMATE
 bool ListEntitiesIterator::on_climate(climate::Climate *climate) {
-  auto buffer = this->client_->get_buffer();
-  buffer.encode_nameable(climate);
-  // string unique_id = 4;
-  buffer.encode_string(4, get_default_unique_id("climate", climate));
+  ListEntitiesClimateResponse msg;
+  fill_nameable(msg, climate);
+  msg.unique_id = get_default_unique_id("climate", climate);
 
   auto traits = climate->get_traits();
-  // bool supports_current_temperature = 5;
-  buffer.encode_bool(5, traits.get_supports_current_temperature());
-  // bool supports_two_point_target_temperature = 6;
-  buffer.encode_bool(6, traits.get_supports_two_point_target_temperature());
-  // repeated ClimateMode supported_modes = 7;
+  msg.supports_current_temperature = traits.get_supports_current_temperature();
+  msg.supports_two_point_target_temperature = traits.get_supports_two_point_target_temperature();
   for (auto mode : {climate::CLIMATE_MODE_AUTO, climate::CLIMATE_MODE_OFF, climate::CLIMATE_MODE_COOL,
                     climate::CLIMATE_MODE_HEAT}) {
     if (traits.supports_mode(mode))
-      buffer.encode_uint32(7, mode, true);
+      msg.supported_modes.push_back(static_cast<ClimateMode>(mode));
   }
-
-  // float visual_min_temperature = 8;
-  buffer.encode_float(8, traits.get_visual_min_temperature());
-  // float visual_max_temperature = 9;
-  buffer.encode_float(9, traits.get_visual_max_temperature());
-  // float visual_temperature_step = 10;
-  buffer.encode_float(10, traits.get_visual_temperature_step());
-  // bool supports_away = 11;
-  buffer.encode_bool(11, traits.get_supports_away());
-  return this->client_->send_buffer(APIMessageType::LIST_ENTITIES_CLIMATE_RESPONSE);
+  msg.visual_min_temperature = traits.get_visual_min_temperature();
+  msg.visual_max_temperature = traits.get_visual_max_temperature();
+  msg.visual_temperature_step = traits.get_visual_temperature_step();
+  msg.supports_away = traits.get_supports_away();
+  return this->append_(msg);
 }
 #endif
 
-APIMessageType ListEntitiesRequest::message_type() const { return APIMessageType::LIST_ENTITIES_REQUEST; }
-
 }  // namespace api
 }  // namespace esphome
@@ -2,21 +2,19 @@
 
 #include "esphome/core/component.h"
 #include "esphome/core/defines.h"
-#include "api_message.h"
+#include "api_pb2.h"
 
 namespace esphome {
 namespace api {
 
-class ListEntitiesRequest : public APIMessage {
- public:
-  APIMessageType message_type() const override;
-};
-
-class APIConnection;
-
+/** Serializes the ListEntities response stream (framed messages, ending with ListEntitiesDoneResponse).
+ *
+ * Entities don't change after setup, so APIServer runs this only once and replays the result to every
+ * client that sends a ListEntitiesRequest.
+ */
 class ListEntitiesIterator : public ComponentIterator {
  public:
-  ListEntitiesIterator(APIServer *server, APIConnection *client);
+  ListEntitiesIterator(APIServer *server, std::vector<uint8_t> *catalog);
 #ifdef USE_BINARY_SENSOR
   bool on_binary_sensor(binary_sensor::BinarySensor *binary_sensor) override;
 #endif
@@ -48,7 +46,9 @@ class ListEntitiesIterator : public ComponentIterator {
   bool on_end() override;
 
  protected:
-  APIConnection *client_;
+  template<typename T> bool append_(const T &msg);
+
+  std::vector<uint8_t> *catalog_;
 };
 
 }  // namespace api
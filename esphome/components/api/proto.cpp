@@ -0,0 +1,239 @@
+#include "proto.h"
+
+namespace esphome {
+namespace api {
+
+static const uint8_t PROTO_WIRE_VARINT = 0;
+static const uint8_t PROTO_WIRE_LENGTH_DELIMITED = 2;
+static const uint8_t PROTO_WIRE_FIXED32 = 5;
+
+static ProtoMessageInfo read_info(const ProtoMessageInfo *info) {
+  ProtoMessageInfo ret;
+  memcpy_P(&ret, info, sizeof(ProtoMessageInfo));
+  return ret;
+}
+static ProtoField read_field(const ProtoMessageInfo &info, uint32_t index) {
+  ProtoField ret;
+  memcpy_P(&ret, &info.fields[index], sizeof(ProtoField));
+  return ret;
+}
+static uint8_t wire_type(ProtoFieldType type) {
+  switch (type) {
+    case PROTO_TYPE_FIXED32:
+    case PROTO_TYPE_FLOAT:
+      return PROTO_WIRE_FIXED32;
+    case PROTO_TYPE_STRING:
+    case PROTO_TYPE_MESSAGE:
+      return PROTO_WIRE_LENGTH_DELIMITED;
+    default:
+      return PROTO_WIRE_VARINT;
+  }
+}
+
+/// Read a varint, keeping the lower 32 bits (negative int32 values are sent as 10 byte varints by most encoders).
+static bool read_varint(const uint8_t *&buf, const uint8_t *end, uint32_t *value) {
+  uint32_t result = 0;
+  for (uint8_t i = 0; i < 10 && buf < end; i++) {
+    const uint8_t val = *buf++;
+    if (i < 5)
+      result |= uint32_t(val & 0x7F) << (i * 7);
+    if ((val & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+static bool skip_field(const uint8_t *&buf, const uint8_t *end, uint8_t wire) {
+  uint32_t len;
+  switch (wire) {
+    case PROTO_WIRE_VARINT:
+      return read_varint(buf, end, &len);
+    case 1:  // 64-bit
+      len = 8;
+      break;
+    case PROTO_WIRE_LENGTH_DELIMITED:
+      if (!read_varint(buf, end, &len))
+        return false;
+      break;
+    case PROTO_WIRE_FIXED32:
+      len = 4;
+      break;
+    default:
+      return false;
+  }
+  if (len > size_t(end - buf))
+    return false;
+  buf += len;
+  return true;
+}
+
+bool proto_decode(const ProtoMessageInfo *info_p, void *msg, const uint8_t *buf, size_t len) {
+  const ProtoMessageInfo info = read_info(info_p);
+  const uint8_t *end = buf + len;
+  while (buf < end) {
+    uint32_t tag;
+    if (!read_varint(buf, end, &tag))
+      return false;
+    const uint32_t field_id = tag >> 3;
+    const uint8_t wire = tag & 0b111;
+
+    if (field_id == 0 || field_id > info.field_count) {
+      if (!skip_field(buf, end, wire))
+        return false;
+      continue;
+    }
+    const ProtoField field = read_field(info, field_id - 1);
+    if (field.type == PROTO_TYPE_NONE || wire != wire_type(field.type)) {
+      if (!skip_field(buf, end, wire))
+        return false;
+      continue;
+    }
+
+    void *member = static_cast<uint8_t *>(msg) + field.offset;
+    void *target = field.repeated ? field.repeated_ops->add(member) : member;
+    uint32_t value;
+    switch (wire) {
+      case PROTO_WIRE_VARINT:
+        if (!read_varint(buf, end, &value))
+          return false;
+        if (field.type == PROTO_TYPE_BOOL)
+          *static_cast<bool *>(target) = value != 0;
+        else
+          memcpy(target, &value, sizeof(uint32_t));
+        break;
+      case PROTO_WIRE_FIXED32:
+        if (end - buf < 4)
+          return false;
+        value = uint32_t(buf[0]) | (uint32_t(buf[1]) << 8) | (uint32_t(buf[2]) << 16) | (uint32_t(buf[3]) << 24);
+        memcpy(target, &value, sizeof(uint32_t));
+        buf += 4;
+        break;
+      default:
+        if (!read_varint(buf, end, &value) || value > size_t(end - buf))
+          return false;
+        if (field.type == PROTO_TYPE_STRING) {
+          static_cast<std::string *>(target)->assign(reinterpret_cast<const char *>(buf), value);
+        } else if (!proto_decode(field.message, target, buf, value)) {
+          return false;
+        }
+        buf += value;
+        break;
+    }
+  }
+  return true;
+}
+
+static size_t varint_size(uint32_t value) {
+  size_t ret = 1;
+  while (value > 0x7F) {
+    value >>= 7;
+    ret++;
+  }
+  return ret;
+}
+static bool is_default(ProtoFieldType type, const void *value) {
+  switch (type) {
+    case PROTO_TYPE_BOOL:
+      return !*static_cast<const bool *>(value);
+    case PROTO_TYPE_FLOAT:
+      return *static_cast<const float *>(value) == 0.0f;
+    case PROTO_TYPE_STRING:
+      return static_cast<const std::string *>(value)->empty();
+    case PROTO_TYPE_MESSAGE:
+      return false;
+    default:
+      return *static_cast<const uint32_t *>(value) == 0;
+  }
+}
+/// Size of the value of a single field element, without the tag.
+static size_t value_size(const ProtoField &field, const void *value) {
+  switch (field.type) {
+    case PROTO_TYPE_BOOL:
+      return 1;
+    case PROTO_TYPE_FIXED32:
+    case PROTO_TYPE_FLOAT:
+      return 4;
+    case PROTO_TYPE_STRING: {
+      const size_t len = static_cast<const std::string *>(value)->size();
+      return varint_size(len) + len;
+    }
+    case PROTO_TYPE_MESSAGE: {
+      const size_t len = proto_size(field.message, value);
+      return varint_size(len) + len;
+    }
+    default:
+      return varint_size(*static_cast<const uint32_t *>(value));
+  }
+}
+static void encode_value(const ProtoField &field, uint32_t field_id, const void *value, APIBuffer &buffer) {
+  buffer.encode_field_raw(field_id, wire_type(field.type));
+  switch (field.type) {
+    case PROTO_TYPE_BOOL:
+      buffer.write(*static_cast<const bool *>(value) ? 0x01 : 0x00);
+      break;
+    case PROTO_TYPE_FIXED32:
+    case PROTO_TYPE_FLOAT: {
+      uint32_t raw;
+      memcpy(&raw, value, sizeof(uint32_t));
+      buffer.write((raw >> 0) & 0xFF);
+      buffer.write((raw >> 8) & 0xFF);
+      buffer.write((raw >> 16) & 0xFF);
+      buffer.write((raw >> 24) & 0xFF);
+      break;
+    }
+    case PROTO_TYPE_STRING: {
+      const auto *str = static_cast<const std::string *>(value);
+      buffer.encode_varint_raw(str->size());
+      buffer.write(reinterpret_cast<const uint8_t *>(str->data()), str->size());
+      break;
+    }
+    case PROTO_TYPE_MESSAGE:
+      buffer.encode_varint_raw(proto_size(field.message, value));
+      proto_encode(field.message, value, buffer);
+      break;
+    default:
+      buffer.encode_varint_raw(*static_cast<const uint32_t *>(value));
+      break;
+  }
+}
+
+size_t proto_size(const ProtoMessageInfo *info_p, const void *msg) {
+  const ProtoMessageInfo info = read_info(info_p);
+  size_t ret = 0;
+  for (uint32_t i = 0; i < info.field_count; i++) {
+    const ProtoField field = read_field(info, i);
+    if (field.type == PROTO_TYPE_NONE)
+      continue;
+    const size_t tag_size = varint_size((i + 1) << 3);
+    const void *member = static_cast<const uint8_t *>(msg) + field.offset;
+    if (field.repeated) {
+      const size_t count = field.repeated_ops->size(member);
+      for (size_t j = 0; j < count; j++)
+        ret += tag_size + value_size(field, field.repeated_ops->get(member, j));
+    } else if (!is_default(field.type, member)) {
+      ret += tag_size + value_size(field, member);
+    }
+  }
+  return ret;
+}
+
+void proto_encode(const ProtoMessageInfo *info_p, const void *msg, APIBuffer &buffer) {
+  const ProtoMessageInfo info = read_info(info_p);
+  for (uint32_t i = 0; i < info.field_count; i++) {
+    const ProtoField field = read_field(info, i);
+    if (field.type == PROTO_TYPE_NONE)
+      continue;
+    const void *member = static_cast<const uint8_t *>(msg) + field.offset;
+    if (field.repeated) {
+      const size_t count = field.repeated_ops->size(member);
+      for (size_t j = 0; j < count; j++)
+        encode_value(field, i + 1, field.repeated_ops->get(member, j), buffer);
+    } else if (!is_default(field.type, member)) {
+      encode_value(field, i + 1, member, buffer);
+    }
+  }
+}
+
+}  // namespace api
+}  // namespace esphome
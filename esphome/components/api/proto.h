@@ -0,0 +1,83 @@
+#pragma once
+
+#include "util.h"
+
+namespace esphome {
+namespace api {
+
+enum ProtoFieldType : uint8_t {
+  PROTO_TYPE_NONE = 0,  ///< Unused slot in a field table (gap in the field numbers).
+  PROTO_TYPE_BOOL,
+  PROTO_TYPE_UINT32,
+  PROTO_TYPE_INT32,
+  PROTO_TYPE_ENUM,
+  PROTO_TYPE_FIXED32,
+  PROTO_TYPE_FLOAT,
+  PROTO_TYPE_STRING,
+  PROTO_TYPE_MESSAGE,
+};
+
+/// Type-erased access to the std::vector behind a repeated field.
+struct ProtoRepeatedOps {
+  size_t (*size)(const void *vec);
+  const void *(*get)(const void *vec, size_t index);
+  void *(*add)(void *vec);
+};
+
+template<typename T> struct ProtoRepeated {
+  static size_t size(const void *vec) { return static_cast<const std::vector<T> *>(vec)->size(); }
+  static const void *get(const void *vec, size_t index) { return &(*static_cast<const std::vector<T> *>(vec))[index]; }
+  static void *add(void *vec) {
+    auto *v = static_cast<std::vector<T> *>(vec);
+    v->emplace_back();
+    return &v->back();
+  }
+  static const ProtoRepeatedOps OPS;
+};
+template<typename T>
+const ProtoRepeatedOps ProtoRepeated<T>::OPS = {
+    .size = ProtoRepeated<T>::size,
+    .get = ProtoRepeated<T>::get,
+    .add = ProtoRepeated<T>::add,
+};
+
+struct ProtoMessageInfo;
+
+/// One entry of a message's field table, the table is indexed by field number - 1.
+struct ProtoField {
+  ProtoFieldType type;
+  bool repeated;
+  /// Offset of the struct member (a std::vector for repeated fields).
+  uint16_t offset;
+  /// Field table of the nested message type for PROTO_TYPE_MESSAGE, nullptr otherwise.
+  const ProtoMessageInfo *message;
+  /// Vector accessors for repeated fields, nullptr otherwise.
+  const ProtoRepeatedOps *repeated_ops;
+};
+
+/// Field table of a generated message struct, lives in flash (PROGMEM) on the ESP8266.
+struct ProtoMessageInfo {
+  const ProtoField *fields;
+  uint8_t field_count;
+};
+
+/** Decode a protobuf message into a generated message struct.
+ *
+ * Unknown fields and fields with an unexpected wire type are skipped.
+ *
+ * @return false if the data is malformed, the struct may be partially filled in that case.
+ */
+bool proto_decode(const ProtoMessageInfo *info, void *msg, const uint8_t *buf, size_t len);
+/// Get the exact encoded size of a generated message struct.
+size_t proto_size(const ProtoMessageInfo *info, const void *msg);
+/// Encode a generated message struct. Scalar fields with their default value are omitted.
+void proto_encode(const ProtoMessageInfo *info, const void *msg, APIBuffer &buffer);
+
+template<typename T> bool proto_decode(T &msg, const uint8_t *buf, size_t len) {
+  return proto_decode(&T::INFO, &msg, buf, len);
+}
+template<typename T> size_t proto_size(const T &msg) { return proto_size(&T::INFO, &msg); }
+template<typename T> void proto_encode(const T &msg, APIBuffer &buffer) { proto_encode(&T::INFO, &msg, buffer); }
+
+}  // namespace api
+}  // namespace esphome
@@ -2,18 +2,11 @@
 
 #include "esphome/core/component.h"
 #include "esphome/core/automation.h"
-#include "api_message.h"
+#include "api_pb2.h"
 
 namespace esphome {
 namespace api {
 
-enum ServiceArgType {
-  SERVICE_ARG_TYPE_BOOL = 0,
-  SERVICE_ARG_TYPE_INT = 1,
-  SERVICE_ARG_TYPE_FLOAT = 2,
-  SERVICE_ARG_TYPE_STRING = 3,
-};
-
 class ServiceTypeArgument {
  public:
   ServiceTypeArgument(const std::string &name, ServiceArgType type);
@@ -25,39 +18,11 @@ class ServiceTypeArgument {
   ServiceArgType type_;
 };
 
-class ExecuteServiceArgument : public APIMessage {
- public:
-  APIMessageType message_type() const override;
-  template<typename T> T get_value();
-
-  bool decode_varint(uint32_t field_id, uint32_t value) override;
-  bool decode_length_delimited(uint32_t field_id, const uint8_t *value, size_t len) override;
-  bool decode_32bit(uint32_t field_id, uint32_t value) override;
-
- protected:
-  bool value_bool_{false};
-  int value_int_{0};
-  float value_float_{0.0f};
-  std::string value_string_{};
-};
-
-class ExecuteServiceRequest : public APIMessage {
- public:
-  bool decode_length_delimited(uint32_t field_id, const uint8_t *value, size_t len) override;
-  bool decode_32bit(uint32_t field_id, uint32_t value) override;
-  APIMessageType message_type() const override;
-
-  uint32_t get_key() const;
-  const std::vector<ExecuteServiceArgument> &get_args() const;
-
- protected:
-  uint32_t key_;
-  std::vector<ExecuteServiceArgument> args_;
-};
+template<typename T> T get_execute_arg_value(const ExecuteServiceArgument &arg);
 
 class UserServiceDescriptor {
  public:
-  virtual void encode_list_service_response(APIBuffer &buffer) = 0;
+  virtual ListEntitiesServicesResponse encode_list_service_response() = 0;
 
   virtual bool execute_service(const ExecuteServiceRequest &req) = 0;
 };
@@ -66,12 +31,12 @@ template<typename... Ts> class UserService : public UserServiceDescriptor, publi
  public:
   UserService(const std::string &name, const std::array<ServiceTypeArgument, sizeof...(Ts)> &args);
 
-  void encode_list_service_response(APIBuffer &buffer) override;
+  ListEntitiesServicesResponse encode_list_service_response() override;
 
   bool execute_service(const ExecuteServiceRequest &req) override;
 
  protected:
-  template<int... S> void execute_(std::vector<ExecuteServiceArgument> args, seq<S...>);
+  template<int... S> void execute_(const std::vector<ExecuteServiceArgument> &args, seq<S...>);
 
   std::string name_;
   uint32_t key_{0};
@@ -80,34 +45,30 @@ template<typename... Ts> class UserService : public UserServiceDescriptor, publi
 
 template<typename... Ts>
 template<int... S>
-void UserService<Ts...>::execute_(std::vector<ExecuteServiceArgument> args, seq<S...>) {
-  this->trigger((args[S].get_value<Ts>())...);
+void UserService<Ts...>::execute_(const std::vector<ExecuteServiceArgument> &args, seq<S...>) {
+  this->trigger((get_execute_arg_value<Ts>(args[S]))...);
 }
-template<typename... Ts> void UserService<Ts...>::encode_list_service_response(APIBuffer &buffer) {
-  // string name = 1;
-  buffer.encode_string(1, this->name_);
-  // fixed32 key = 2;
-  buffer.encode_fixed32(2, this->key_);
-
-  // repeated ListServicesArgument args = 3;
+template<typename... Ts> ListEntitiesServicesResponse UserService<Ts...>::encode_list_service_response() {
+  ListEntitiesServicesResponse resp;
+  resp.name = this->name_;
+  resp.key = this->key_;
   for (auto &arg : this->args_) {
-    auto nested = buffer.begin_nested(3);
-    // string name = 1;
-    buffer.encode_string(1, arg.get_name());
-    // Type type = 2;
-    buffer.encode_int32(2, arg.get_type());
-    buffer.end_nested(nested);
+    ListEntitiesServicesArgument service_arg;
+    service_arg.name = arg.get_name();
+    service_arg.type = arg.get_type();
+    resp.args.push_back(service_arg);
   }
+  return resp;
 }
 template<typename... Ts> bool UserService<Ts...>::execute_service(const ExecuteServiceRequest &req) {
-  if (req.get_key() != this->key_)
+  if (req.key != this->key_)
     return false;
 
-  if (req.get_args().size() != this->args_.size()) {
+  if (req.args.size() != this->args_.size()) {
     return false;
   }
 
-  this->execute_(req.get_args(), typename gens<sizeof...(Ts)>::type());
+  this->execute_(req.args, typename gens<sizeof...(Ts)>::type());
   return true;
 }
 template<typename... Ts>
@@ -116,10 +77,10 @@ UserService<Ts...>::UserService(const std::string &name, const std::array<Servic
   this->key_ = fnv1_hash(this->name_);
 }
 
-template<> bool ExecuteServiceArgument::get_value<bool>();
-template<> int ExecuteServiceArgument::get_value<int>();
-template<> float ExecuteServiceArgument::get_value<float>();
-template<> std::string ExecuteServiceArgument::get_value<std::string>();
+template<> bool get_execute_arg_value<bool>(const ExecuteServiceArgument &arg);
+template<> int get_execute_arg_value<int>(const ExecuteServiceArgument &arg);
+template<> float get_execute_arg_value<float>(const ExecuteServiceArgument &arg);
+template<> std::string get_execute_arg_value<std::string>(const ExecuteServiceArgument &arg);
 
 }  // namespace api
 }  // namespace esphome
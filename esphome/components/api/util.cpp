@@ -10,6 +10,9 @@ namespace api {
 APIBuffer::APIBuffer(std::vector<uint8_t> *buffer) : buffer_(buffer) {}
 size_t APIBuffer::get_length() const { return this->buffer_->size(); }
 void APIBuffer::write(uint8_t value) { this->buffer_->push_back(value); }
+void APIBuffer::write(const uint8_t *data, size_t len) {
+  this->buffer_->insert(this->buffer_->end(), data, data + len);
+}
 void APIBuffer::encode_uint32(uint32_t field, uint32_t value, bool force) {
   if (value == 0 && !force)
     return;
@@ -39,10 +42,7 @@ void APIBuffer::encode_string(uint32_t field, const char *string, size_t len) {
 
   this->encode_field_raw(field, 2);
   this->encode_varint_raw(len);
-  const uint8_t *data = reinterpret_cast<const uint8_t *>(string);
-  for (size_t i = 0; i < len; i++) {
-    this->write(data[i]);
-  }
+  this->write(reinterpret_cast<const uint8_t *>(string), len);
 }
 void APIBuffer::encode_fixed32(uint32_t field, uint32_t value, bool force) {
   if (value == 0 && !force)
@@ -91,37 +91,35 @@ void APIBuffer::encode_sint32(uint32_t field, int32_t value, bool force) {
   else
     this->encode_uint32(field, uint32_t(value) << 1, force);
 }
-void APIBuffer::encode_nameable(Nameable *nameable) {
-  // string object_id = 1;
-  this->encode_string(1, nameable->get_object_id());
-  // fixed32 key = 2;
-  this->encode_fixed32(2, nameable->get_object_id_hash());
-  // string name = 3;
-  this->encode_string(3, nameable->get_name());
+
+bool APIRecvBuffer::write(const uint8_t *data, size_t len) {
+  if (len > API_RECV_BUFFER_SIZE - this->size())
+    return false;
+
+  const uint32_t start = this->head_ & (API_RECV_BUFFER_SIZE - 1);
+  const uint32_t first = std::min<uint32_t>(len, API_RECV_BUFFER_SIZE - start);
+  memcpy(&this->data_[start], data, first);
+  memcpy(&this->data_[0], data + first, len - first);
+  this->head_ += len;
+  return true;
 }
-size_t APIBuffer::begin_nested(uint32_t field) {
-  this->encode_field_raw(field, 2);
-  return this->buffer_->size();
+const uint8_t *APIRecvBuffer::peek_contiguous(uint32_t offset, uint32_t len, std::vector<uint8_t> &scratch) const {
+  const uint32_t start = (this->tail_ + offset) & (API_RECV_BUFFER_SIZE - 1);
+  if (start + len <= API_RECV_BUFFER_SIZE)
+    return &this->data_[start];
+
+  const uint32_t first = API_RECV_BUFFER_SIZE - start;
+  scratch.resize(len);
+  memcpy(scratch.data(), &this->data_[start], first);
+  memcpy(scratch.data() + first, &this->data_[0], len - first);
+  return scratch.data();
 }
-void APIBuffer::end_nested(size_t begin_index) {
-  const uint32_t nested_length = this->buffer_->size() - begin_index;
-  // add varint
-  std::vector<uint8_t> var;
-  uint32_t val = nested_length;
-  if (val <= 0x7F) {
-    var.push_back(val);
-  } else {
-    while (val) {
-      uint8_t temp = val & 0x7F;
-      val >>= 7;
-      if (val) {
-        var.push_back(temp | 0x80);
-      } else {
-        var.push_back(temp);
-      }
-    }
-  }
-  this->buffer_->insert(this->buffer_->begin() + begin_index, var.begin(), var.end());
+void APIRecvBuffer::read(uint32_t len, uint8_t *dest) {
+  const uint32_t start = this->tail_ & (API_RECV_BUFFER_SIZE - 1);
+  const uint32_t first = std::min<uint32_t>(len, API_RECV_BUFFER_SIZE - start);
+  memcpy(dest, &this->data_[start], first);
+  memcpy(dest + first, &this->data_[0], len - first);
+  this->tail_ += len;
 }
 
 optional<uint32_t> proto_decode_varuint32(const uint8_t *buf, size_t len, uint32_t *consumed) {
@@ -3,6 +3,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/component.h"
 #include "esphome/core/controller.h"
+#include <lwip/opt.h>
 #ifdef USE_ESP32_CAMERA
 #include "esphome/components/esp32_camera/esp32_camera.h"
 #endif
@@ -16,6 +17,7 @@ class APIBuffer {
 
   size_t get_length() const;
   void write(uint8_t value);
+  void write(const uint8_t *data, size_t len);
 
   void encode_int32(uint32_t field, int32_t value, bool force = false);
   void encode_uint32(uint32_t field, uint32_t value, bool force = false);
@@ -26,10 +28,6 @@ class APIBuffer {
   void encode_bytes(uint32_t field, const uint8_t *data, size_t len);
   void encode_fixed32(uint32_t field, uint32_t value, bool force = false);
   void encode_float(uint32_t field, float value, bool force = false);
-  void encode_nameable(Nameable *nameable);
-
-  size_t begin_nested(uint32_t field);
-  void end_nested(size_t begin_index);
 
   void encode_field_raw(uint32_t field, uint32_t type);
   void encode_varint_raw(uint32_t value);
@@ -38,6 +36,50 @@ class APIBuffer {
   std::vector<uint8_t> *buffer_;
 };
 
+/// The smallest power of two that is at least value.
+constexpr uint32_t api_next_power_of_two(uint32_t value, uint32_t result = 1) {
+  return result >= value ? result : api_next_power_of_two(value, result * 2);
+}
+/** Size of the per-connection receive ring buffer, a power of two.
+ *
+ * Received data is only acknowledged to TCP once it has been parsed, so the peer can't send more than the TCP
+ * window ahead and the ring never overflows. Messages larger than the ring are assembled on the heap.
+ */
+static const uint32_t API_RECV_BUFFER_SIZE = api_next_power_of_two(TCP_WND);
+/// Largest message accepted from a client, enough for an ExecuteServiceRequest. Larger ones close the connection.
+static const uint32_t API_MAX_MESSAGE_SIZE = 8192;
+
+/** Fixed-size ring buffer for incoming API data.
+ *
+ * Filled from the TCP data callback and consumed in-place from the main loop, so consuming a message never
+ * has to move the remaining data. Head and tail are free-running counters, the buffer size being a power
+ * of two makes the index wraparound a simple mask.
+ */
+class APIRecvBuffer {
+ public:
+  /// Append data, returns false (and appends nothing) if it doesn't fit.
+  bool write(const uint8_t *data, size_t len);
+  size_t size() const { return this->head_ - this->tail_; }
+  bool empty() const { return this->head_ == this->tail_; }
+  /// Get the byte at offset from the read position.
+  uint8_t peek(uint32_t offset) const { return this->data_[(this->tail_ + offset) & (API_RECV_BUFFER_SIZE - 1)]; }
+  /** Get a contiguous view of len bytes starting at offset from the read position.
+   *
+   * Points directly into the ring unless the region wraps around the end, in that case the bytes are
+   * copied into scratch first.
+   */
+  const uint8_t *peek_contiguous(uint32_t offset, uint32_t len, std::vector<uint8_t> &scratch) const;
+  /// Drop len bytes from the read position.
+  void consume(uint32_t len) { this->tail_ += len; }
+  /// Copy len bytes from the read position to dest and drop them.
+  void read(uint32_t len, uint8_t *dest);
+
+ protected:
+  uint8_t data_[API_RECV_BUFFER_SIZE];
+  volatile uint32_t head_{0};
+  volatile uint32_t tail_{0};
+};
+
 optional<uint32_t> proto_decode_varuint32(const uint8_t *buf, size_t len, uint32_t *consumed = nullptr);
 
 std::string as_string(const uint8_t *value, size_t len);
@@ -53,6 +95,8 @@ class ComponentIterator {
 
   void begin();
   void advance();
+  /// Whether the iteration has finished (or was never started).
+  bool completed() const { return this->state_ == IteratorState::NONE; }
   virtual bool on_begin();
 #ifdef USE_BINARY_SENSOR
   virtual bool on_binary_sensor(binary_sensor::BinarySensor *binary_sensor) = 0;
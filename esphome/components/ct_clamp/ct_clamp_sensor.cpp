@@ -1,6 +1,7 @@
 #include "ct_clamp_sensor.h"
 
 #include "esphome/core/log.h"
+#include "esphome/components/voltage_sampler/block_kernels.h"
 #include <cmath>
 
 namespace esphome {
@@ -8,22 +9,36 @@ namespace ct_clamp {
 
 static const char *TAG = "ct_clamp";
 
+void CTClampSensor::setup() {
+  this->continuous_ = this->source_->add_on_sample_block_callback([this](const float *samples, size_t count) {
+    if (this->is_sampling_)
+      this->process_block_(samples, count);
+  });
+}
+
 void CTClampSensor::dump_config() {
   LOG_SENSOR("", "CT Clamp Sensor", this);
   ESP_LOGCONFIG(TAG, "  Sample Duration: %.2fs", this->sample_duration_ / 1e3f);
+  if (this->continuous_)
+    ESP_LOGCONFIG(TAG, "  Continuous Sampling: YES");
   LOG_UPDATE_INTERVAL(this);
 }
 
 void CTClampSensor::update() {
-  // Update only starts the sampling phase, in loop() the actual sampling is happening.
+  // Update only starts the sampling phase, the samples arrive in blocks from a continuous source or are taken
+  // in loop().
 
   // Request a high loop() execution interval during sampling phase.
-  this->high_freq_.start();
+  if (!this->continuous_)
+    this->high_freq_.start();
 
   // Set timeout for ending sampling phase
   this->set_timeout("read", this->sample_duration_, [this]() {
     this->is_sampling_ = false;
-    this->high_freq_.stop();
+    if (!this->continuous_) {
+      this->high_freq_.stop();
+      this->process_block_(this->block_, this->block_size_);
+    }
 
     if (this->num_samples_ == 0) {
       // Shouldn't happen, but let's not crash if it does.
@@ -31,36 +46,44 @@ void CTClampSensor::update() {
       return;
     }
 
-    float raw = this->sample_sum_ / this->num_samples_;
-    float irms = std::sqrt(raw);
-    ESP_LOGD(TAG, "'%s' - Raw Value: %.2fA", this->name_.c_str(), irms);
+    float irms = std::sqrt(this->m2_ / this->num_samples_);
+    ESP_LOGD(TAG, "'%s' - Raw Value: %.2fA from %u samples", this->name_.c_str(), irms, this->num_samples_);
     this->publish_state(irms);
   });
 
   // Set sampling values
   this->is_sampling_ = true;
   this->num_samples_ = 0;
-  this->sample_sum_ = 0.0f;
+  this->mean_ = 0.0f;
+  this->m2_ = 0.0f;
+  this->block_size_ = 0;
 }
 
 void CTClampSensor::loop() {
-  if (!this->is_sampling_)
+  if (!this->is_sampling_ || this->continuous_)
     return;
 
   // Perform a single sample
-  float value = this->source_->sample();
-
-  // Adjust DC offset via low pass filter (exponential moving average)
-  const float alpha = 0.001f;
-  this->offset_ = this->offset_ * (1 - alpha) + value * alpha;
-
-  // Filtered value centered around the mid-point (0V)
-  float filtered = value - this->offset_;
+  this->block_[this->block_size_++] = this->source_->sample();
+  if (this->block_size_ == CT_CLAMP_BLOCK_SIZE) {
+    this->process_block_(this->block_, this->block_size_);
+    this->block_size_ = 0;
+  }
+}
 
-  // IRMS is sqrt(∑v_i²)
-  float sq = filtered * filtered;
-  this->sample_sum_ += sq;
-  this->num_samples_++;
+void CTClampSensor::process_block_(const float *samples, size_t count) {
+  if (count == 0)
+    return;
+  const float block_mean = voltage_sampler::block_mean(samples, count);
+  const float block_m2 = voltage_sampler::block_sum_of_squares(samples, count, block_mean);
+
+  // Merge with the statistics of the earlier blocks (Chan et al.), IRMS is the standard deviation around
+  // the DC offset of the whole sampling phase
+  const uint32_t total = this->num_samples_ + count;
+  const float delta = block_mean - this->mean_;
+  this->mean_ += delta * count / total;
+  this->m2_ += block_m2 + delta * delta * (float(this->num_samples_) * count / total);
+  this->num_samples_ = total;
 }
 
 }  // namespace ct_clamp
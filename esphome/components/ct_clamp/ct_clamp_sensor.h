@@ -8,8 +8,12 @@
 namespace esphome {
 namespace ct_clamp {
 
+/// Number of samples that are collected in loop() before they're processed, if the source doesn't provide blocks.
+static const size_t CT_CLAMP_BLOCK_SIZE = 32;
+
 class CTClampSensor : public sensor::Sensor, public PollingComponent {
  public:
+  void setup() override;
   void update() override;
   void loop() override;
   void dump_config() override;
@@ -27,17 +31,21 @@ class CTClampSensor : public sensor::Sensor, public PollingComponent {
   /// The sampling source to read values from.
   voltage_sampler::VoltageSampler *source_;
 
-  /** The DC offset of the circuit.
+  /// Add a block of samples to the running mean and sum of squared deviations of the sampling phase.
+  void process_block_(const float *samples, size_t count);
+
+  /// Whether the source delivers sample blocks by itself, otherwise loop() samples it.
+  bool continuous_{false};
+  float block_[CT_CLAMP_BLOCK_SIZE];
+  size_t block_size_{0};
+
+  /** The DC offset of the circuit is the mean of the sampling phase.
    *
    * Diagram: https://learn.openenergymonitor.org/electricity-monitoring/ct-sensors/interface-with-arduino
-   *
-   * This is automatically calculated with an exponential moving average/digital low pass filter.
-   *
-   * 0.5 is a good initial approximation to start with for most ESP8266 setups.
    */
-  float offset_ = 0.5f;
-
-  float sample_sum_ = 0.0f;
+  float mean_ = 0.0f;
+  /// The sum of the squared deviations from mean_, the RMS current is sqrt(m2_ / num_samples_).
+  float m2_ = 0.0f;
   uint32_t num_samples_ = 0;
   bool is_sampling_ = false;
 };
@@ -1,5 +1,6 @@
 #include "debug_component.h"
 #include "esphome/core/log.h"
+#include "esphome/core/application.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/version.h"
@@ -204,6 +205,18 @@ void DebugComponent::loop() {
     ESP_LOGD(TAG, "Free Heap Size: %u bytes", this->free_heap_);
     this->status_momentary_warning("heap", 1000);
   }
+
+  // checked from loop() instead of an interval, which would be a wake-up of its own
+  const uint32_t now = millis();
+  if (now - this->last_scheduler_report_ >= 60000) {
+    const uint32_t wakeups = App.scheduler.get_wakeups();
+    const uint32_t active_time = App.scheduler.get_active_time();
+    ESP_LOGD(TAG, "Scheduler: %u wake-ups, %u ms running timeouts and intervals in the last minute",
+             wakeups - this->last_wakeups_, (active_time - this->last_active_time_) / 1000);
+    this->last_scheduler_report_ = now;
+    this->last_wakeups_ = wakeups;
+    this->last_active_time_ = active_time;
+  }
 }
 float DebugComponent::get_setup_priority() const { return setup_priority::LATE; }
 
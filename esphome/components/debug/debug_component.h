@@ -13,6 +13,9 @@ class DebugComponent : public Component {
 
  protected:
   uint32_t free_heap_{};
+  uint32_t last_scheduler_report_{0};
+  uint32_t last_wakeups_{0};
+  uint32_t last_active_time_{0};
 };
 
 }  // namespace debug
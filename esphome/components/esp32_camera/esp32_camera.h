@@ -25,6 +25,7 @@ class CameraImage {
 class CameraImageReader {
  public:
   void set_image(std::shared_ptr<CameraImage> image);
+  std::shared_ptr<CameraImage> get_image() const { return this->image_; }
   size_t available() const;
   uint8_t *peek_data_buffer();
   void consume_data(size_t consumed);
@@ -0,0 +1,142 @@
+#include "json_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace esphome {
+namespace json {
+
+static const char *HEX_CHARS = "0123456789abcdef";
+
+void JsonWriter::begin_(char c) {
+  this->separator_();
+  this->write_char_(c);
+  this->has_elements_ &= ~(1UL << this->depth_);
+  this->depth_++;
+}
+void JsonWriter::end_(char c) {
+  this->depth_--;
+  this->write_char_(c);
+}
+void JsonWriter::separator_() {
+  if (this->after_key_) {
+    this->after_key_ = false;
+    return;
+  }
+  if (this->depth_ == 0)
+    return;
+  const uint32_t bit = 1UL << (this->depth_ - 1);
+  if (this->has_elements_ & bit)
+    this->write_char_(',');
+  this->has_elements_ |= bit;
+}
+void JsonWriter::key(const char *key) {
+  this->begin_string();
+  this->append_string(key, strlen(key));
+  this->write_("\":", 2);
+  this->after_key_ = true;
+}
+void JsonWriter::value(const char *value, size_t len) {
+  this->begin_string();
+  this->append_string(value, len);
+  this->end_string();
+}
+void JsonWriter::value(bool value) {
+  this->separator_();
+  if (value)
+    this->write_("true", 4);
+  else
+    this->write_("false", 5);
+}
+void JsonWriter::value(int32_t value) {
+  char buf[12];
+  int len = snprintf(buf, sizeof(buf), "%ld", long(value));
+  this->write_number_(buf, len);
+}
+void JsonWriter::value(uint32_t value) {
+  char buf[12];
+  int len = snprintf(buf, sizeof(buf), "%lu", static_cast<unsigned long>(value));
+  this->write_number_(buf, len);
+}
+void JsonWriter::value(float value) {
+  if (!std::isfinite(value)) {
+    this->null_value();
+    return;
+  }
+  // six significant digits are all a float reliably holds, more would print 21.46 as 21.459999
+  const int int_digits = value == 0.0f ? 1 : int(floorf(log10f(fabsf(value)))) + 1;
+  const int decimals = std::min(std::max(6 - int_digits, 0), 9);
+  // large enough for the 39 integer digits of FLT_MAX
+  char buf[48];
+  dtostrf(value, 0, decimals, buf);
+  size_t len = strlen(buf);
+  // trailing zeros of the fraction carry no information, the ones of an integer do
+  if (memchr(buf, '.', len) != nullptr) {
+    while (buf[len - 1] == '0')
+      len--;
+    if (buf[len - 1] == '.')
+      len--;
+  }
+  this->write_number_(buf, len);
+}
+void JsonWriter::value(float value, int8_t accuracy_decimals) {
+  if (!std::isfinite(value)) {
+    this->null_value();
+    return;
+  }
+  char buf[VALUE_ACCURACY_BUF_SIZE];
+  size_t len = value_accuracy_to_buf(buf, value, accuracy_decimals);
+  this->write_number_(buf, len);
+}
+void JsonWriter::null_value() {
+  this->separator_();
+  this->write_("null", 4);
+}
+void JsonWriter::write_number_(const char *buf, size_t len) {
+  this->separator_();
+  this->write_(buf, len);
+}
+void JsonWriter::begin_string() {
+  this->separator_();
+  this->write_char_('"');
+}
+void JsonWriter::append_string(const char *str, size_t len) {
+  // write the runs of characters that don't need escaping in one go
+  size_t start = 0;
+  for (size_t i = 0; i < len; i++) {
+    const auto c = static_cast<uint8_t>(str[i]);
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+    this->write_(str + start, i - start);
+    start = i + 1;
+    char escaped[6] = {'\\', char(c), 0, 0, 0, 0};
+    size_t escaped_len = 2;
+    switch (c) {
+      case '"':
+      case '\\':
+        break;
+      case '\n':
+        escaped[1] = 'n';
+        break;
+      case '\r':
+        escaped[1] = 'r';
+        break;
+      case '\t':
+        escaped[1] = 't';
+        break;
+      default:
+        escaped[1] = 'u';
+        escaped[2] = '0';
+        escaped[3] = '0';
+        escaped[4] = HEX_CHARS[c >> 4];
+        escaped[5] = HEX_CHARS[c & 0x0F];
+        escaped_len = 6;
+        break;
+    }
+    this->write_(escaped, escaped_len);
+  }
+  this->write_(str + start, len - start);
+}
+
+}  // namespace json
+}  // namespace esphome
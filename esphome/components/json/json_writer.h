@@ -0,0 +1,115 @@
+#pragma once
+
+#include "esphome/core/helpers.h"
+#include <Print.h>
+#include <cstring>
+
+namespace esphome {
+namespace json {
+
+/** Streaming JSON serializer that writes the document to its sink while it's being built.
+ *
+ * Unlike build_json() there's no intermediate document: every call emits its characters right away, so
+ * the memory needed doesn't depend on the size of the document. The caller is responsible for the
+ * structure (matching begin/end calls, a key before every value of an object), at most 32 levels of
+ * nesting are supported. Subclasses implement write_() to decide where the output goes.
+ */
+class JsonWriter {
+ public:
+  void begin_object() { this->begin_('{'); }
+  void end_object() { this->end_('}'); }
+  void begin_array() { this->begin_('['); }
+  void end_array() { this->end_(']'); }
+
+  /// Write the key of the next member of the current object.
+  void key(const char *key);
+
+  void value(const char *value) { this->value(value, strlen(value)); }
+  void value(const char *value, size_t len);
+  void value(const std::string &value) { this->value(value.data(), value.size()); }
+  void value(bool value);
+  void value(int32_t value);
+  void value(uint32_t value);
+  /// Write a float with six significant digits, NaN and infinity are written as null.
+  void value(float value);
+  /// Write a float rounded to accuracy_decimals, NaN and infinity are written as null.
+  void value(float value, int8_t accuracy_decimals);
+  void null_value();
+
+  /// Write a key and its value.
+  template<typename T> void add(const char *key, const T &value) {
+    this->key(key);
+    this->value(value);
+  }
+
+  /// Start a string value that is written in several pieces with append_string().
+  void begin_string();
+  void append_string(const char *str, size_t len);
+  void append_string(const std::string &str) { this->append_string(str.data(), str.size()); }
+  void end_string() { this->write_char_('"'); }
+
+ protected:
+  virtual void write_(const char *data, size_t len) = 0;
+
+  void write_char_(char c) { this->write_(&c, 1); }
+  void begin_(char c);
+  void end_(char c);
+  /// Write the comma between the elements of a container, unless a key was just written.
+  void separator_();
+  void write_number_(const char *buf, size_t len);
+
+  /// Bit n is set once the container at depth n + 1 has its first element.
+  uint32_t has_elements_{0};
+  uint8_t depth_{0};
+  bool after_key_{false};
+};
+
+/// JsonWriter for Print objects, for example an AsyncResponseStream.
+class JsonPrintWriter : public JsonWriter {
+ public:
+  explicit JsonPrintWriter(Print &print) : print_(print) {}
+
+ protected:
+  void write_(const char *data, size_t len) override {
+    this->print_.write(reinterpret_cast<const uint8_t *>(data), len);
+  }
+
+  Print &print_;
+};
+
+/** JsonWriter into a buffer of N bytes, meant to be placed on the stack.
+ *
+ * Documents that don't fit are moved to a heap allocated string, so the output is never truncated.
+ */
+template<size_t N> class StaticJsonWriter : public JsonWriter {
+ public:
+  /// The NUL-terminated document.
+  const char *c_str() {
+    if (!this->overflow_.empty())
+      return this->overflow_.c_str();
+    this->buffer_[this->length_] = '\0';
+    return this->buffer_;
+  }
+  size_t size() const { return this->overflow_.empty() ? this->length_ : this->overflow_.size(); }
+
+ protected:
+  void write_(const char *data, size_t len) override {
+    if (this->overflow_.empty() && this->length_ + len < N) {
+      memcpy(this->buffer_ + this->length_, data, len);
+      this->length_ += len;
+      return;
+    }
+    if (this->overflow_.empty()) {
+      this->overflow_.reserve(N * 2);
+      this->overflow_.assign(this->buffer_, this->length_);
+    }
+    this->overflow_.append(data, len);
+  }
+
+  char buffer_[N];
+  size_t length_{0};
+  std::string overflow_;
+};
+
+}  // namespace json
+}  // namespace esphome
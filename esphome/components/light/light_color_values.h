@@ -5,7 +5,7 @@
 #include "light_traits.h"
 
 #ifdef USE_JSON
-#include "esphome/components/json/json_util.h"
+#include "esphome/components/json/json_writer.h"
 #endif
 
 namespace esphome {
@@ -105,25 +105,28 @@ class LightColorValues {
   }
 
 #ifdef USE_JSON
-  /** Dump this color into a JsonObject. Only dumps values if the corresponding traits are marked supported by traits.
+  /** Dump this color into the current JSON object. Only dumps values if the corresponding traits are marked
+   * supported by traits.
    *
-   * @param root The json root object.
+   * @param writer The json writer, inside the object to add the members to.
    * @param traits The traits object used for determining whether to include certain attributes.
    */
-  void dump_json(JsonObject &root, const LightTraits &traits) const {
-    root["state"] = (this->get_state() != 0.0f) ? "ON" : "OFF";
+  void dump_json(json::JsonWriter &writer, const LightTraits &traits) const {
+    writer.add("state", (this->get_state() != 0.0f) ? "ON" : "OFF");
     if (traits.get_supports_brightness())
-      root["brightness"] = uint8_t(this->get_brightness() * 255);
+      writer.add("brightness", uint32_t(uint8_t(this->get_brightness() * 255)));
     if (traits.get_supports_rgb()) {
-      JsonObject &color = root.createNestedObject("color");
-      color["r"] = uint8_t(this->get_red() * 255);
-      color["g"] = uint8_t(this->get_green() * 255);
-      color["b"] = uint8_t(this->get_blue() * 255);
+      writer.key("color");
+      writer.begin_object();
+      writer.add("r", uint32_t(uint8_t(this->get_red() * 255)));
+      writer.add("g", uint32_t(uint8_t(this->get_green() * 255)));
+      writer.add("b", uint32_t(uint8_t(this->get_blue() * 255)));
+      writer.end_object();
     }
     if (traits.get_supports_rgb_white_value())
-      root["white_value"] = uint8_t(this->get_white() * 255);
+      writer.add("white_value", uint32_t(uint8_t(this->get_white() * 255)));
     if (traits.get_supports_color_temperature())
-      root["color_temp"] = uint32_t(this->get_color_temperature());
+      writer.add("color_temp", uint32_t(this->get_color_temperature()));
   }
 #endif
 
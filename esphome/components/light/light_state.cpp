@@ -72,10 +72,10 @@ void LightState::set_default_transition_length(uint32_t default_transition_lengt
   this->default_transition_length_ = default_transition_length;
 }
 #ifdef USE_JSON
-void LightState::dump_json(JsonObject &root) {
+void LightState::dump_json(json::JsonWriter &writer) {
   if (this->supports_effects())
-    root["effect"] = this->get_effect_name();
-  this->remote_values.dump_json(root, this->output_->get_traits());
+    writer.add("effect", this->get_effect_name());
+  this->remote_values.dump_json(writer, this->output_->get_traits());
 }
 #endif
 
@@ -8,6 +8,10 @@
 #include "light_traits.h"
 #include "light_transformer.h"
 
+#ifdef USE_JSON
+#include "esphome/components/json/json_util.h"
+#endif
+
 namespace esphome {
 namespace light {
 
@@ -246,8 +250,8 @@ class LightState : public Nameable, public Component {
   bool supports_effects();
 
 #ifdef USE_JSON
-  /// Dump the state of this light as JSON.
-  void dump_json(JsonObject &root);
+  /// Dump the state of this light as members of the current JSON object.
+  void dump_json(json::JsonWriter &writer);
 #endif
 
   /// Set the default transition length, i.e. the transition length when no transition is provided.
@@ -17,6 +17,9 @@ from esphome.core import coroutine_with_priority, coroutine, CORE
 DEPENDENCIES = ['network']
 AUTO_LOAD = ['json']
 
+CONF_PUBLISH_QUEUE_SIZE = 'publish_queue_size'
+CONF_PROTOCOL_VERSION = 'protocol_version'
+
 
 def validate_message_just_topic(value):
     value = cv.publish_topic(value)
@@ -89,6 +92,9 @@ def validate_config(value):
             CONF_QOS: 0,
             CONF_RETAIN: True,
         }
+    if value[CONF_PROTOCOL_VERSION] == '5' and CONF_SSL_FINGERPRINTS in value:
+        raise cv.Invalid("SSL fingerprints are only supported with protocol_version 3.1.1",
+                         path=[CONF_SSL_FINGERPRINTS])
     return out
 
 
@@ -106,6 +112,7 @@ CONFIG_SCHEMA = cv.All(cv.Schema({
     cv.Optional(CONF_USERNAME, default=''): cv.string,
     cv.Optional(CONF_PASSWORD, default=''): cv.string,
     cv.Optional(CONF_CLIENT_ID): cv.string,
+    cv.Optional(CONF_PROTOCOL_VERSION, default='3.1.1'): cv.All(cv.string, cv.one_of('3.1.1', '5')),
     cv.Optional(CONF_DISCOVERY, default=True): cv.Any(cv.boolean, cv.one_of("CLEAN", upper=True)),
     cv.Optional(CONF_DISCOVERY_RETAIN, default=True): cv.boolean,
     cv.Optional(CONF_DISCOVERY_PREFIX, default="homeassistant"): cv.publish_topic,
@@ -122,6 +129,7 @@ CONFIG_SCHEMA = cv.All(cv.Schema({
                                                cv.ensure_list(validate_fingerprint)),
     cv.Optional(CONF_KEEPALIVE, default='15s'): cv.positive_time_period_seconds,
     cv.Optional(CONF_REBOOT_TIMEOUT, default='5min'): cv.positive_time_period_milliseconds,
+    cv.SplitDefault(CONF_PUBLISH_QUEUE_SIZE, esp32='8kB', esp8266='2kB'): cv.validate_bytes,
     cv.Optional(CONF_ON_MESSAGE): automation.validate_automation({
         cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(MQTTMessageTrigger),
         cv.Required(CONF_TOPIC): cv.subscribe_topic,
@@ -154,7 +162,14 @@ def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     yield cg.register_component(var, config)
 
-    cg.add_library('AsyncMqttClient', '0.8.2')
+    if config[CONF_PROTOCOL_VERSION] == '5':
+        cg.add_define('USE_MQTT5')
+        if CORE.is_esp32:
+            cg.add_library('AsyncTCP', '1.0.3')
+        elif CORE.is_esp8266:
+            cg.add_library('ESPAsyncTCP', '1.2.0')
+    else:
+        cg.add_library('AsyncMqttClient', '0.8.2')
     cg.add_define('USE_MQTT')
     cg.add_global(mqtt_ns.using)
 
@@ -212,6 +227,7 @@ def to_code(config):
     cg.add(var.set_keep_alive(config[CONF_KEEPALIVE]))
 
     cg.add(var.set_reboot_timeout(config[CONF_REBOOT_TIMEOUT]))
+    cg.add(var.set_publish_queue_size(config[CONF_PUBLISH_QUEUE_SIZE]))
 
     for conf in config.get(CONF_ON_MESSAGE, []):
         trig = cg.new_Pvariable(conf[CONF_TRIGGER_ID], conf[CONF_TOPIC])
@@ -0,0 +1,688 @@
+#include "mqtt5_client.h"
+
+#ifdef USE_MQTT5
+
+#include <algorithm>
+#include <cstring>
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace mqtt {
+
+static const char *TAG = "mqtt5";
+
+static const uint8_t MQTT5_CONNECT = 0x10;
+static const uint8_t MQTT5_PUBLISH = 0x30;
+static const uint8_t MQTT5_PUBACK = 0x40;
+static const uint8_t MQTT5_PUBREC = 0x50;
+static const uint8_t MQTT5_PUBREL = 0x62;
+static const uint8_t MQTT5_PUBCOMP = 0x70;
+static const uint8_t MQTT5_SUBSCRIBE = 0x82;
+static const uint8_t MQTT5_PINGREQ = 0xC0;
+static const uint8_t MQTT5_DISCONNECT = 0xE0;
+
+static const uint8_t MQTT5_PROPERTY_SERVER_KEEP_ALIVE = 0x13;
+static const uint8_t MQTT5_PROPERTY_RECEIVE_MAXIMUM = 0x21;
+static const uint8_t MQTT5_PROPERTY_TOPIC_ALIAS_MAXIMUM = 0x22;
+static const uint8_t MQTT5_PROPERTY_TOPIC_ALIAS = 0x23;
+static const uint8_t MQTT5_PROPERTY_MAXIMUM_QOS = 0x24;
+static const uint8_t MQTT5_PROPERTY_RETAIN_AVAILABLE = 0x25;
+static const uint8_t MQTT5_PROPERTY_MAXIMUM_PACKET_SIZE = 0x27;
+
+// MQTT5RecvBuffer
+
+bool MQTT5RecvBuffer::write(const uint8_t *data, size_t len) {
+  if (len > MQTT5_RECV_BUFFER_SIZE - this->size())
+    return false;
+
+  const uint32_t start = this->head_ & (MQTT5_RECV_BUFFER_SIZE - 1);
+  const uint32_t first = std::min<uint32_t>(len, MQTT5_RECV_BUFFER_SIZE - start);
+  memcpy(&this->data_[start], data, first);
+  memcpy(&this->data_[0], data + first, len - first);
+  this->head_ += len;
+  return true;
+}
+uint8_t *MQTT5RecvBuffer::peek_contiguous(uint32_t offset, uint32_t len, std::vector<uint8_t> &scratch) {
+  const uint32_t start = (this->tail_ + offset) & (MQTT5_RECV_BUFFER_SIZE - 1);
+  if (start + len <= MQTT5_RECV_BUFFER_SIZE)
+    return &this->data_[start];
+
+  const uint32_t first = MQTT5_RECV_BUFFER_SIZE - start;
+  scratch.resize(len);
+  memcpy(scratch.data(), &this->data_[start], first);
+  memcpy(scratch.data() + first, &this->data_[0], len - first);
+  return scratch.data();
+}
+
+// Decoding helpers, all of them check the bounds and return false on malformed data.
+
+static bool read_u16(const uint8_t *&buf, const uint8_t *end, uint16_t *value) {
+  if (end - buf < 2)
+    return false;
+  *value = (uint16_t(buf[0]) << 8) | buf[1];
+  buf += 2;
+  return true;
+}
+static bool read_varint(const uint8_t *&buf, const uint8_t *end, uint32_t *value) {
+  uint32_t result = 0;
+  for (uint8_t shift = 0; shift < 28 && buf < end; shift += 7) {
+    const uint8_t val = *buf++;
+    result |= uint32_t(val & 0x7F) << shift;
+    if ((val & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+/// Read one property, the value of integer properties is stored in value, other properties are skipped.
+static bool read_property(const uint8_t *&buf, const uint8_t *end, uint8_t *id, uint32_t *value) {
+  if (buf >= end)
+    return false;
+  *id = *buf++;
+  *value = 0;
+  size_t skip;
+  switch (*id) {
+    case 0x01:  // payload format indicator
+    case 0x17:  // request problem information
+    case 0x19:  // request response information
+    case MQTT5_PROPERTY_MAXIMUM_QOS:
+    case MQTT5_PROPERTY_RETAIN_AVAILABLE:
+    case 0x28:  // wildcard subscription available
+    case 0x29:  // subscription identifiers available
+    case 0x2A:  // shared subscription available
+      if (buf >= end)
+        return false;
+      *value = *buf++;
+      return true;
+    case MQTT5_PROPERTY_SERVER_KEEP_ALIVE:
+    case MQTT5_PROPERTY_RECEIVE_MAXIMUM:
+    case MQTT5_PROPERTY_TOPIC_ALIAS_MAXIMUM:
+    case MQTT5_PROPERTY_TOPIC_ALIAS: {
+      uint16_t val;
+      if (!read_u16(buf, end, &val))
+        return false;
+      *value = val;
+      return true;
+    }
+    case 0x02:  // message expiry interval
+    case 0x11:  // session expiry interval
+    case 0x18:  // will delay interval
+    case MQTT5_PROPERTY_MAXIMUM_PACKET_SIZE:
+      if (end - buf < 4)
+        return false;
+      *value = (uint32_t(buf[0]) << 24) | (uint32_t(buf[1]) << 16) | (uint32_t(buf[2]) << 8) | buf[3];
+      buf += 4;
+      return true;
+    case 0x0B:  // subscription identifier
+      return read_varint(buf, end, value);
+    case 0x26: {  // user property, a pair of strings
+      uint16_t len;
+      if (!read_u16(buf, end, &len) || end - buf < len)
+        return false;
+      buf += len;
+      if (!read_u16(buf, end, &len))
+        return false;
+      skip = len;
+      break;
+    }
+    case 0x03:  // content type
+    case 0x08:  // response topic
+    case 0x09:  // correlation data
+    case 0x12:  // assigned client identifier
+    case 0x15:  // authentication method
+    case 0x16:  // authentication data
+    case 0x1A:  // response information
+    case 0x1C:  // server reference
+    case 0x1F: {  // reason string
+      uint16_t len;
+      if (!read_u16(buf, end, &len))
+        return false;
+      skip = len;
+      break;
+    }
+    default:
+      return false;
+  }
+  if (size_t(end - buf) < skip)
+    return false;
+  buf += skip;
+  return true;
+}
+/// Get the end of the property block at buf, nullptr if malformed.
+static const uint8_t *read_properties_length(const uint8_t *&buf, const uint8_t *end) {
+  uint32_t len;
+  if (!read_varint(buf, end, &len) || len > size_t(end - buf))
+    return nullptr;
+  return buf + len;
+}
+
+static MQTT5DisconnectReason disconnect_reason(uint8_t reason_code) {
+  switch (reason_code) {
+    case 0x84:  // unsupported protocol version
+      return MQTT5DisconnectReason::MQTT_UNACCEPTABLE_PROTOCOL_VERSION;
+    case 0x85:  // client identifier not valid
+      return MQTT5DisconnectReason::MQTT_IDENTIFIER_REJECTED;
+    case 0x86:  // bad user name or password
+      return MQTT5DisconnectReason::MQTT_MALFORMED_CREDENTIALS;
+    case 0x87:  // not authorized
+    case 0x8A:  // banned
+      return MQTT5DisconnectReason::MQTT_NOT_AUTHORIZED;
+    case 0x88:  // server unavailable
+    case 0x89:  // server busy
+    case 0x8B:  // server shutting down
+    case 0x9C:  // use another server
+    case 0x9D:  // server moved
+      return MQTT5DisconnectReason::MQTT_SERVER_UNAVAILABLE;
+    default:
+      return MQTT5DisconnectReason::TCP_DISCONNECTED;
+  }
+}
+
+// MQTT5Client
+
+MQTT5Client::MQTT5Client() {
+  this->client_.onConnect(
+      [](void *arg, AsyncClient *client) { static_cast<MQTT5Client *>(arg)->tcp_connected_ = true; }, this);
+  this->client_.onDisconnect(
+      [](void *arg, AsyncClient *client) { static_cast<MQTT5Client *>(arg)->tcp_disconnected_ = true; }, this);
+  this->client_.onData(
+      [](void *arg, AsyncClient *client, void *data, size_t len) {
+        auto *a_this = static_cast<MQTT5Client *>(arg);
+        // acknowledged from loop(), which keeps the broker from sending more than fits into the buffer
+        client->ackLater();
+        a_this->recv_received_ += len;
+        // can't drop bytes from a stream, the connection is closed from loop()
+        if (!a_this->recv_buffer_.write(static_cast<uint8_t *>(data), len))
+          a_this->recv_overflow_ = true;
+      },
+      this);
+}
+
+void MQTT5Client::setCredentials(const char *username, const char *password) {
+  this->username_ = username;
+  this->password_ = password;
+}
+void MQTT5Client::setServer(IPAddress ip, uint16_t port) {
+  this->ip_ = ip;
+  this->port_ = port;
+}
+void MQTT5Client::setWill(const char *topic, uint8_t qos, bool retain, const char *payload, size_t length) {
+  this->will_topic_ = topic;
+  this->will_qos_ = qos;
+  this->will_retain_ = retain;
+  this->will_payload_ = payload;
+  this->will_length_ = length == 0 && payload != nullptr ? strlen(payload) : length;
+}
+
+void MQTT5Client::connect() {
+  if (this->state_ != STATE_DISCONNECTED)
+    return;
+
+  this->tcp_connected_ = false;
+  this->tcp_disconnected_ = false;
+  this->recv_overflow_ = false;
+  this->recv_received_ = 0;
+  this->recv_acked_ = 0;
+  this->recv_buffer_.clear();
+  this->effective_keep_alive_ = this->keep_alive_;
+  this->send_buffer_.clear();
+  this->ping_outstanding_ = false;
+  this->in_flight_ = 0;
+  this->topic_aliases_.clear();
+  this->receive_maximum_ = 65535;
+  this->topic_alias_maximum_ = 0;
+  this->maximum_packet_size_ = 0;
+  this->maximum_qos_ = 2;
+  this->retain_available_ = true;
+
+  this->state_ = STATE_TCP_CONNECTING;
+  if (!this->client_.connect(this->ip_, this->port_))
+    this->tcp_disconnected_ = true;
+}
+void MQTT5Client::disconnect(bool force) {
+  if (this->state_ == STATE_DISCONNECTED)
+    return;
+
+  if (this->state_ == STATE_CONNECTED && !force) {
+    this->write_byte_(MQTT5_DISCONNECT);
+    this->write_byte_(0x00);
+  }
+  this->flush_();
+  this->state_ = STATE_DISCONNECTED;
+  this->client_.close(force);
+}
+void MQTT5Client::close_(MQTT5DisconnectReason reason) {
+  this->state_ = STATE_DISCONNECTED;
+  this->client_.close(true);
+  if (this->on_disconnect_)
+    this->on_disconnect_(reason);
+}
+
+void MQTT5Client::loop() {
+  if (this->state_ == STATE_DISCONNECTED)
+    return;
+
+  if (this->state_ == STATE_TCP_CONNECTING && this->tcp_connected_) {
+    // batching is done here, no need to wait for more data
+    this->client_.setNoDelay(true);
+    this->send_connect_();
+    this->state_ = STATE_CONNECTING;
+  }
+
+  // parse first, a DISCONNECT packet from the broker arrives before the connection is closed
+  this->parse_recv_buffer_();
+  if (this->state_ == STATE_DISCONNECTED)
+    return;
+  if (this->tcp_disconnected_) {
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+  this->ack_received_();
+
+  if (this->state_ == STATE_CONNECTED && this->effective_keep_alive_ != 0) {
+    const uint32_t now = millis();
+    const uint32_t keep_alive_ms = this->effective_keep_alive_ * 1000UL;
+    if (this->ping_outstanding_) {
+      if (now - this->ping_sent_ > keep_alive_ms) {
+        ESP_LOGW(TAG, "No ping response from the broker.");
+        this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+        return;
+      }
+    } else if (now - this->last_send_ >= keep_alive_ms) {
+      this->write_byte_(MQTT5_PINGREQ);
+      this->write_byte_(0x00);
+      this->ping_outstanding_ = true;
+      this->ping_sent_ = now;
+    }
+  }
+
+  this->flush_();
+}
+
+void MQTT5Client::parse_recv_buffer_() {
+  if (this->recv_overflow_) {
+    ESP_LOGW(TAG, "Receive buffer overflow");
+    this->close_(MQTT5DisconnectReason::ESP8266_NOT_ENOUGH_SPACE);
+    return;
+  }
+
+  while (this->state_ != STATE_DISCONNECTED && !this->recv_buffer_.empty()) {
+    const uint32_t size = this->recv_buffer_.size();
+    uint32_t len = 0;
+    uint32_t i = 1;
+    bool len_done = false;
+    for (uint8_t shift = 0; i < size && shift < 28; shift += 7) {
+      const uint8_t dat = this->recv_buffer_.peek(i++);
+      len |= uint32_t(dat & 0x7F) << shift;
+      if ((dat & 0x80) == 0) {
+        len_done = true;
+        break;
+      }
+    }
+    if (!len_done) {
+      if (i == 5) {
+        ESP_LOGW(TAG, "Malformed packet length");
+        this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+      }
+      // not enough data there yet
+      return;
+    }
+    if (len > MQTT5_RECV_BUFFER_SIZE - i) {
+      ESP_LOGW(TAG, "Packet too large: %u bytes", len);
+      this->close_(MQTT5DisconnectReason::ESP8266_NOT_ENOUGH_SPACE);
+      return;
+    }
+    if (size - i < len)
+      // packet not fully received
+      return;
+
+    uint8_t *data = this->recv_buffer_.peek_contiguous(i, len, this->recv_scratch_);
+    this->handle_packet_(this->recv_buffer_.peek(0), data, len);
+    this->recv_buffer_.consume(i + len);
+  }
+}
+
+void MQTT5Client::ack_received_() {
+  const uint32_t unacked = this->recv_received_ - this->recv_acked_;
+  if (unacked == 0)
+    return;
+  // after acknowledging len bytes, the broker may send TCP_WND - (unacked - len) more
+  const uint32_t room = MQTT5_RECV_BUFFER_SIZE - this->recv_buffer_.size();
+  if (room + unacked <= TCP_WND)
+    return;
+  const uint32_t len = std::min(unacked, room + unacked - TCP_WND);
+  this->client_.ack(len);
+  this->recv_acked_ += len;
+}
+
+void MQTT5Client::handle_packet_(uint8_t header, uint8_t *data, uint32_t len) {
+  const uint8_t type = header >> 4;
+  if (this->state_ == STATE_CONNECTING && type != 2) {
+    ESP_LOGW(TAG, "Expected CONNACK, got packet type %u", type);
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+
+  const uint8_t *buf = data;
+  const uint8_t *end = data + len;
+  uint16_t packet_id = 0;
+  switch (type) {
+    case 2:  // CONNACK
+      this->handle_connack_(data, len);
+      return;
+    case 3:  // PUBLISH
+      this->handle_publish_(header & 0x0F, data, len);
+      return;
+    case 4:  // PUBACK
+    case 7:  // PUBCOMP
+      if (this->in_flight_ > 0)
+        this->in_flight_--;
+      return;
+    case 5:  // PUBREC
+      if (!read_u16(buf, end, &packet_id))
+        break;
+      if (buf < end && *buf >= 0x80) {
+        // rejected, the exchange ends here
+        if (this->in_flight_ > 0)
+          this->in_flight_--;
+      } else {
+        this->send_ack_(MQTT5_PUBREL, packet_id);
+      }
+      return;
+    case 6:  // PUBREL
+      if (!read_u16(buf, end, &packet_id))
+        break;
+      this->send_ack_(MQTT5_PUBCOMP, packet_id);
+      return;
+    case 9: {  // SUBACK
+      if (!read_u16(buf, end, &packet_id))
+        break;
+      buf = read_properties_length(buf, end);
+      if (buf == nullptr)
+        break;
+      for (; buf < end; buf++) {
+        if (*buf >= 0x80)
+          ESP_LOGW(TAG, "Subscription %u rejected: reason 0x%02X", packet_id, *buf);
+      }
+      return;
+    }
+    case 11:  // UNSUBACK
+      return;
+    case 13:  // PINGRESP
+      this->ping_outstanding_ = false;
+      return;
+    case 14: {  // DISCONNECT
+      const uint8_t reason = len > 0 ? data[0] : 0;
+      ESP_LOGW(TAG, "Disconnected by the broker: reason 0x%02X", reason);
+      this->close_(disconnect_reason(reason));
+      return;
+    }
+    default:
+      break;
+  }
+
+  ESP_LOGW(TAG, "Malformed or unexpected packet of type %u", type);
+  this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+}
+
+void MQTT5Client::handle_connack_(const uint8_t *data, uint32_t len) {
+  if (this->state_ != STATE_CONNECTING || len < 2) {
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+  if (data[1] >= 0x80) {
+    ESP_LOGW(TAG, "Connection refused: reason 0x%02X", data[1]);
+    this->close_(disconnect_reason(data[1]));
+    return;
+  }
+
+  const uint8_t *buf = data + 2;
+  const uint8_t *end = read_properties_length(buf, data + len);
+  if (end == nullptr) {
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+  while (buf < end) {
+    uint8_t id;
+    uint32_t value;
+    if (!read_property(buf, end, &id, &value)) {
+      this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+      return;
+    }
+    switch (id) {
+      case MQTT5_PROPERTY_SERVER_KEEP_ALIVE:
+        this->effective_keep_alive_ = value;
+        break;
+      case MQTT5_PROPERTY_RECEIVE_MAXIMUM:
+        this->receive_maximum_ = value;
+        break;
+      case MQTT5_PROPERTY_TOPIC_ALIAS_MAXIMUM:
+        this->topic_alias_maximum_ = value;
+        break;
+      case MQTT5_PROPERTY_MAXIMUM_QOS:
+        this->maximum_qos_ = value;
+        break;
+      case MQTT5_PROPERTY_RETAIN_AVAILABLE:
+        this->retain_available_ = value != 0;
+        break;
+      case MQTT5_PROPERTY_MAXIMUM_PACKET_SIZE:
+        this->maximum_packet_size_ = value;
+        break;
+      default:
+        break;
+    }
+  }
+
+  ESP_LOGD(TAG, "Connected: receive maximum %u, topic alias maximum %u", this->receive_maximum_,
+           this->topic_alias_maximum_);
+  this->state_ = STATE_CONNECTED;
+}
+
+void MQTT5Client::handle_publish_(uint8_t flags, uint8_t *data, uint32_t len) {
+  const uint8_t qos = (flags >> 1) & 0x03;
+  const uint8_t *buf = data;
+  const uint8_t *end = data + len;
+  uint16_t topic_len;
+  uint16_t packet_id = 0;
+  if (qos == 3 || !read_u16(buf, end, &topic_len) || topic_len == 0 || end - buf < topic_len) {
+    // topic aliases from the broker aren't enabled, so the topic must be set
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+  this->recv_topic_.assign(reinterpret_cast<const char *>(buf), topic_len);
+  buf += topic_len;
+  if (qos > 0 && !read_u16(buf, end, &packet_id)) {
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+  buf = read_properties_length(buf, end);
+  if (buf == nullptr) {
+    this->close_(MQTT5DisconnectReason::TCP_DISCONNECTED);
+    return;
+  }
+
+  if (this->on_message_) {
+    MQTT5MessageProperties properties{
+        .qos = qos,
+        .dup = (flags & 0x08) != 0,
+        .retain = (flags & 0x01) != 0,
+    };
+    const size_t payload_len = end - buf;
+    this->on_message_(&this->recv_topic_[0], reinterpret_cast<char *>(data + (buf - data)), properties, payload_len,
+                      0, payload_len);
+  }
+
+  if (qos == 1)
+    this->send_ack_(MQTT5_PUBACK, packet_id);
+  else if (qos == 2)
+    this->send_ack_(MQTT5_PUBREC, packet_id);
+}
+
+void MQTT5Client::send_connect_() {
+  const size_t client_id_len = strlen(this->client_id_);
+  // protocol name, version, flags, keep alive, properties (maximum packet size) and client id
+  uint32_t len = 6 + 1 + 1 + 2 + 6 + 2 + client_id_len;
+  uint8_t flags = 0x02;  // clean start
+  if (this->will_topic_ != nullptr) {
+    flags |= 0x04 | (this->will_qos_ << 3) | (this->will_retain_ ? 0x20 : 0x00);
+    len += 1 + 2 + strlen(this->will_topic_) + 2 + this->will_length_;
+  }
+  if (this->username_ != nullptr) {
+    flags |= 0x80;
+    len += 2 + strlen(this->username_);
+  }
+  if (this->password_ != nullptr) {
+    flags |= 0x40;
+    len += 2 + strlen(this->password_);
+  }
+
+  this->write_byte_(MQTT5_CONNECT);
+  this->write_varint_(len);
+  this->write_string_("MQTT", 4);
+  this->write_byte_(5);
+  this->write_byte_(flags);
+  this->write_u16_(this->keep_alive_);
+  this->write_byte_(5);
+  this->write_byte_(MQTT5_PROPERTY_MAXIMUM_PACKET_SIZE);
+  this->write_u16_(MQTT5_RECV_BUFFER_SIZE >> 16);
+  this->write_u16_(MQTT5_RECV_BUFFER_SIZE & 0xFFFF);
+  this->write_string_(this->client_id_, client_id_len);
+  if (this->will_topic_ != nullptr) {
+    this->write_byte_(0);  // will properties
+    this->write_string_(this->will_topic_, strlen(this->will_topic_));
+    this->write_string_(this->will_payload_, this->will_length_);
+  }
+  if (this->username_ != nullptr)
+    this->write_string_(this->username_, strlen(this->username_));
+  if (this->password_ != nullptr)
+    this->write_string_(this->password_, strlen(this->password_));
+  this->flush_();
+}
+
+void MQTT5Client::send_ack_(uint8_t header, uint16_t packet_id) {
+  // reason code success is implied by the short form
+  this->write_byte_(header);
+  this->write_byte_(0x02);
+  this->write_u16_(packet_id);
+}
+
+uint16_t MQTT5Client::next_packet_id_() {
+  if (++this->last_packet_id_ == 0)
+    this->last_packet_id_ = 1;
+  return this->last_packet_id_;
+}
+
+uint16_t MQTT5Client::subscribe(const char *topic, uint8_t qos) {
+  if (!this->connected())
+    return 0;
+
+  const size_t topic_len = strlen(topic);
+  const uint16_t packet_id = this->next_packet_id_();
+  this->write_byte_(MQTT5_SUBSCRIBE);
+  this->write_varint_(2 + 1 + 2 + topic_len + 1);
+  this->write_u16_(packet_id);
+  this->write_byte_(0);  // properties
+  this->write_string_(topic, topic_len);
+  this->write_byte_(std::min(qos, this->maximum_qos_));
+  return packet_id;
+}
+
+uint16_t MQTT5Client::find_topic_alias_(const char *topic, size_t len) const {
+  for (size_t i = 0; i < this->topic_aliases_.size(); i++) {
+    const std::string &alias_topic = this->topic_aliases_[i];
+    if (alias_topic.size() == len && memcmp(alias_topic.data(), topic, len) == 0)
+      return i + 1;
+  }
+  return 0;
+}
+
+uint16_t MQTT5Client::publish(const char *topic, uint8_t qos, bool retain, const char *payload, size_t length,
+                              bool dup, uint16_t message_id) {
+  if (!this->connected())
+    return 0;
+
+  qos = std::min(qos, this->maximum_qos_);
+  retain = retain && this->retain_available_;
+  if (qos > 0 && this->in_flight_ >= this->receive_maximum_)
+    // flow control, the message stays in the client's queue
+    return 0;
+
+  const size_t topic_len = strlen(topic);
+  uint16_t alias = this->find_topic_alias_(topic, topic_len);
+  const bool send_topic = alias == 0;
+  const bool new_alias = alias == 0 && this->topic_aliases_.size() < this->topic_alias_maximum_;
+  if (new_alias)
+    alias = this->topic_aliases_.size() + 1;
+
+  const uint32_t properties_len = alias != 0 ? 3 : 0;
+  const uint32_t len = 2 + (send_topic ? topic_len : 0) + (qos > 0 ? 2 : 0) + 1 + properties_len + length;
+  const uint32_t total = 1 + (len < 128 ? 1 : len < 16384 ? 2 : 3) + len;
+  if (this->maximum_packet_size_ != 0 && total > this->maximum_packet_size_) {
+    ESP_LOGW(TAG, "Message for '%s' exceeds the broker's maximum packet size", topic);
+    return 0;
+  }
+  if (!this->send_buffer_.empty() && this->send_buffer_.size() + total > MQTT5_SEND_BUFFER_SIZE) {
+    this->flush_();
+    if (!this->send_buffer_.empty())
+      // the connection doesn't take more data right now
+      return 0;
+  }
+
+  if (new_alias)
+    this->topic_aliases_.emplace_back(topic, topic_len);
+  const uint16_t packet_id = qos > 0 ? (message_id != 0 ? message_id : this->next_packet_id_()) : 1;
+  this->write_byte_(MQTT5_PUBLISH | (dup ? 0x08 : 0x00) | (qos << 1) | (retain ? 0x01 : 0x00));
+  this->write_varint_(len);
+  this->write_string_(topic, send_topic ? topic_len : 0);
+  if (qos > 0) {
+    this->write_u16_(packet_id);
+    this->in_flight_++;
+  }
+  this->write_byte_(properties_len);
+  if (alias != 0) {
+    this->write_byte_(MQTT5_PROPERTY_TOPIC_ALIAS);
+    this->write_u16_(alias);
+  }
+  this->send_buffer_.insert(this->send_buffer_.end(), payload, payload + length);
+
+  if (this->send_buffer_.size() >= MQTT5_SEND_BUFFER_SIZE)
+    this->flush_();
+  return packet_id;
+}
+
+void MQTT5Client::write_u16_(uint16_t value) {
+  this->write_byte_(value >> 8);
+  this->write_byte_(value & 0xFF);
+}
+void MQTT5Client::write_varint_(uint32_t value) {
+  while (value > 0x7F) {
+    this->write_byte_((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  this->write_byte_(value);
+}
+void MQTT5Client::write_string_(const char *str, size_t len) {
+  this->write_u16_(len);
+  this->send_buffer_.insert(this->send_buffer_.end(), str, str + len);
+}
+
+void MQTT5Client::flush_() {
+  if (this->send_buffer_.empty() || !this->client_.connected())
+    return;
+
+  const size_t len = std::min(this->client_.space(), this->send_buffer_.size());
+  if (len == 0)
+    return;
+  const size_t written = this->client_.add(reinterpret_cast<const char *>(this->send_buffer_.data()), len);
+  if (written == 0)
+    return;
+  this->client_.send();
+  this->send_buffer_.erase(this->send_buffer_.begin(), this->send_buffer_.begin() + written);
+  this->last_send_ = millis();
+}
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT5
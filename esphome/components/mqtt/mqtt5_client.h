@@ -0,0 +1,195 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_MQTT5
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <IPAddress.h>
+#include <lwip/opt.h>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <AsyncTCP.h>
+#endif
+#ifdef ARDUINO_ARCH_ESP8266
+#include <ESPAsyncTCP.h>
+#endif
+
+namespace esphome {
+namespace mqtt {
+
+/// The smallest power of two that is at least value.
+constexpr uint32_t mqtt5_next_power_of_two(uint32_t value, uint32_t result = 1) {
+  return result >= value ? result : mqtt5_next_power_of_two(value, result * 2);
+}
+/** Size of the receive buffer, also announced to the broker as the maximum packet size.
+ *
+ * At least the TCP window, received data is only acknowledged to TCP while the buffer has room for everything
+ * the broker may send after the acknowledgement.
+ */
+static const uint32_t MQTT5_RECV_BUFFER_SIZE = mqtt5_next_power_of_two(TCP_WND > 2048 ? TCP_WND : 2048);
+/// Outgoing packets are collected up to this size before being written to the TCP connection.
+static const size_t MQTT5_SEND_BUFFER_SIZE = 1460;
+
+/// Same values as AsyncMqttClientDisconnectReason.
+enum class MQTT5DisconnectReason : int8_t {
+  TCP_DISCONNECTED = 0,
+  MQTT_UNACCEPTABLE_PROTOCOL_VERSION = 1,
+  MQTT_IDENTIFIER_REJECTED = 2,
+  MQTT_SERVER_UNAVAILABLE = 3,
+  MQTT_MALFORMED_CREDENTIALS = 4,
+  MQTT_NOT_AUTHORIZED = 5,
+  ESP8266_NOT_ENOUGH_SPACE = 6,
+  TLS_BAD_FINGERPRINT = 7,
+};
+
+struct MQTT5MessageProperties {
+  uint8_t qos;
+  bool dup;
+  bool retain;
+};
+
+/** Single producer/single consumer byte ring, filled from the TCP callbacks and parsed in loop().
+ *
+ * Head and tail are free-running counters, MQTT5_RECV_BUFFER_SIZE is a power of two.
+ */
+class MQTT5RecvBuffer {
+ public:
+  /// Append data, returns false (and appends nothing) if it doesn't fit.
+  bool write(const uint8_t *data, size_t len);
+  size_t size() const { return this->head_ - this->tail_; }
+  bool empty() const { return this->head_ == this->tail_; }
+  uint8_t peek(uint32_t offset) const { return this->data_[(this->tail_ + offset) & (MQTT5_RECV_BUFFER_SIZE - 1)]; }
+  /// Get len contiguous bytes starting at offset, copied into scratch if they wrap around the end.
+  uint8_t *peek_contiguous(uint32_t offset, uint32_t len, std::vector<uint8_t> &scratch);
+  void consume(uint32_t len) { this->tail_ += len; }
+  void clear() { this->tail_ = this->head_; }
+
+ protected:
+  uint8_t data_[MQTT5_RECV_BUFFER_SIZE];
+  volatile uint32_t head_{0};
+  volatile uint32_t tail_{0};
+};
+
+/** Minimal MQTT 5 client, an alternative to AsyncMqttClient (MQTT 3.1.1) with less traffic per message.
+ *
+ *  - Topic aliases: once the broker allows it, every topic is sent in full only for its first message, later
+ *    messages use a two byte alias.
+ *  - Batching: PUBLISH packets created within one loop iteration are written to the connection together.
+ *  - Flow control: at most as many QoS 1/2 messages as the broker's receive maximum are in flight, publish()
+ *    fails beyond that so the message stays in the client's publish queue.
+ *
+ * The interface mirrors the part of AsyncMqttClient used by MQTTClientComponent, so either can be selected
+ * at compile time. All packets are parsed and sent from loop(), the TCP callbacks only buffer data and set
+ * flags. Sessions always start clean, unacknowledged messages are not retransmitted after a reconnect.
+ */
+class MQTT5Client {
+ public:
+  using OnMessageCallback = std::function<void(char *topic, char *payload, MQTT5MessageProperties properties,
+                                               size_t len, size_t index, size_t total)>;
+  using OnDisconnectCallback = std::function<void(MQTT5DisconnectReason reason)>;
+
+  MQTT5Client();
+
+  /// Process received packets, keep the connection alive and write the packets collected since the last call.
+  void loop();
+
+  void onMessage(OnMessageCallback callback) { this->on_message_ = std::move(callback); }
+  void onDisconnect(OnDisconnectCallback callback) { this->on_disconnect_ = std::move(callback); }
+  void setClientId(const char *client_id) { this->client_id_ = client_id; }
+  void setCredentials(const char *username, const char *password);
+  void setServer(IPAddress ip, uint16_t port);
+  void setWill(const char *topic, uint8_t qos, bool retain, const char *payload, size_t length);
+  void setKeepAlive(uint16_t keep_alive) { this->keep_alive_ = keep_alive; }
+
+  void connect();
+  void disconnect(bool force = false);
+  bool connected() const { return this->state_ == STATE_CONNECTED; }
+
+  /// @return The packet identifier, 1 for QoS 0 messages or 0 if the subscription couldn't be sent.
+  uint16_t subscribe(const char *topic, uint8_t qos);
+  /// @return The packet identifier, 1 for QoS 0 messages or 0 if the message couldn't be sent.
+  uint16_t publish(const char *topic, uint8_t qos, bool retain, const char *payload = nullptr, size_t length = 0,
+                   bool dup = false, uint16_t message_id = 0);
+
+ protected:
+  enum State {
+    STATE_DISCONNECTED,
+    STATE_TCP_CONNECTING,
+    STATE_CONNECTING,
+    STATE_CONNECTED,
+  };
+
+  void parse_recv_buffer_();
+  void handle_packet_(uint8_t header, uint8_t *data, uint32_t len);
+  void handle_connack_(const uint8_t *data, uint32_t len);
+  void handle_publish_(uint8_t flags, uint8_t *data, uint32_t len);
+  void send_connect_();
+  /// Send a PUBACK, PUBREC, PUBREL or PUBCOMP packet.
+  void send_ack_(uint8_t header, uint16_t packet_id);
+  uint16_t next_packet_id_();
+  /// Find the alias assigned to a topic, 0 if there's none.
+  uint16_t find_topic_alias_(const char *topic, size_t len) const;
+  void write_byte_(uint8_t value) { this->send_buffer_.push_back(value); }
+  void write_u16_(uint16_t value);
+  void write_varint_(uint32_t value);
+  void write_string_(const char *str, size_t len);
+  /// Write as much of the send buffer to the connection as it accepts.
+  void flush_();
+  /// Acknowledge received data to TCP as far as the receive buffer has room for what the broker may send next.
+  void ack_received_();
+  /// Close the connection after a protocol error or a broker reject.
+  void close_(MQTT5DisconnectReason reason);
+
+  AsyncClient client_;
+  State state_{STATE_DISCONNECTED};
+  OnMessageCallback on_message_;
+  OnDisconnectCallback on_disconnect_;
+  IPAddress ip_;
+  uint16_t port_{1883};
+  const char *client_id_{""};
+  const char *username_{nullptr};
+  const char *password_{nullptr};
+  const char *will_topic_{nullptr};
+  const char *will_payload_{nullptr};
+  size_t will_length_{0};
+  uint8_t will_qos_{0};
+  bool will_retain_{false};
+  uint16_t keep_alive_{15};
+  /// The configured keep alive or the one the broker assigned in the CONNACK.
+  uint16_t effective_keep_alive_{15};
+
+  // set from the TCP callbacks, handled in loop()
+  volatile bool tcp_connected_{false};
+  volatile bool tcp_disconnected_{false};
+  volatile bool recv_overflow_{false};
+  /// Bytes received from / acknowledged to TCP (wrapping), the difference is the part of the window in use.
+  volatile uint32_t recv_received_{0};
+  uint32_t recv_acked_{0};
+  MQTT5RecvBuffer recv_buffer_;
+  std::vector<uint8_t> recv_scratch_;
+  std::string recv_topic_;
+  std::vector<uint8_t> send_buffer_;
+  uint32_t last_send_{0};
+  uint32_t ping_sent_{0};
+  bool ping_outstanding_{false};
+  uint16_t last_packet_id_{0};
+
+  // limits of the broker from the CONNACK
+  uint16_t receive_maximum_{65535};
+  uint16_t topic_alias_maximum_{0};
+  uint32_t maximum_packet_size_{0};
+  uint8_t maximum_qos_{2};
+  bool retain_available_{true};
+  /// QoS 1/2 messages sent but not acknowledged yet.
+  uint16_t in_flight_{0};
+  /// Topics by alias - 1.
+  std::vector<std::string> topic_aliases_;
+};
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT5
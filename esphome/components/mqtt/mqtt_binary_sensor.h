@@ -22,7 +22,7 @@ class MQTTBinarySensorComponent : public mqtt::MQTTComponent {
 
   void dump_config() override;
 
-  void send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) override;
+  void send_discovery(json::JsonWriter &writer, mqtt::SendDiscoveryConfig &config) override;
 
   void set_is_status(bool status);
 
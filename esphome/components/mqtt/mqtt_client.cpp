@@ -14,6 +14,22 @@ namespace esphome {
 namespace mqtt {
 
 static const char *TAG = "mqtt";
+/// Discovery payload bytes sent per loop iteration, at least one payload is always sent.
+static const int32_t MQTT_DISCOVERY_BUDGET = 1024;
+/// Queued messages sent per loop iteration.
+static const uint8_t MQTT_PUBLISH_QUEUE_DRAIN = 4;
+/// Time after connecting for the broker to send the retained discovery configs, discovery is held back until then.
+static const uint32_t MQTT_RETAINED_DISCOVERY_WAIT = 1000;
+
+/// FNV-1 hash of a discovery payload, 0 is reserved for "nothing retained".
+static uint32_t discovery_payload_hash(const char *data, size_t len) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < len; i++) {
+    hash *= 16777619UL;
+    hash ^= data[i];
+  }
+  return hash == 0 ? 1 : hash;
+}
 
 MQTTClientComponent::MQTTClientComponent() {
   global_mqtt_client = this;
@@ -23,16 +39,24 @@ MQTTClientComponent::MQTTClientComponent() {
 // Connection
 void MQTTClientComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up MQTT...");
-  this->mqtt_client_.onMessage([this](char *topic, char *payload, AsyncMqttClientMessageProperties properties,
+  this->mqtt_client_.onMessage([this](char *topic, char *payload, MQTTMessageProperties properties,
                                       size_t len, size_t index, size_t total) {
     std::string payload_s(payload, len);
     std::string topic_s(topic);
     this->on_message(topic_s, payload_s);
   });
-  this->mqtt_client_.onDisconnect([this](AsyncMqttClientDisconnectReason reason) {
+  this->mqtt_client_.onDisconnect([this](MQTTDisconnectReason reason) {
     this->state_ = MQTT_CLIENT_DISCONNECTED;
     this->disconnect_reason_ = reason;
   });
+  if (this->checks_retained_discovery_()) {
+    // the broker sends the configs it retains right after subscribing, unchanged ones aren't sent again
+    const std::string node = sanitize_string_whitelist(App.get_name(), HOSTNAME_CHARACTER_WHITELIST);
+    this->subscribe(this->discovery_info_.prefix + "/+/" + node + "/+/config",
+                    [this](const std::string &topic, const std::string &payload) {
+                      this->on_retained_discovery_(topic, payload);
+                    });
+  }
 #ifdef USE_LOGGER
   if (this->is_log_message_enabled() && logger::global_logger != nullptr) {
     logger::global_logger->add_on_log_callback([this](int level, const char *tag, const char *message) {
@@ -53,6 +77,9 @@ void MQTTClientComponent::dump_config() {
                 this->ip_.toString().c_str());
   ESP_LOGCONFIG(TAG, "  Username: " LOG_SECRET("'%s'"), this->credentials_.username.c_str());
   ESP_LOGCONFIG(TAG, "  Client ID: " LOG_SECRET("'%s'"), this->credentials_.client_id.c_str());
+#ifdef USE_MQTT5
+  ESP_LOGCONFIG(TAG, "  Protocol: MQTT 5");
+#endif
   if (!this->discovery_info_.prefix.empty()) {
     ESP_LOGCONFIG(TAG, "  Discovery prefix: '%s'", this->discovery_info_.prefix.c_str());
     ESP_LOGCONFIG(TAG, "  Discovery retain: %s", YESNO(this->discovery_info_.retain));
@@ -64,6 +91,7 @@ void MQTTClientComponent::dump_config() {
   if (!this->availability_.topic.empty()) {
     ESP_LOGCONFIG(TAG, "  Availability: '%s'", this->availability_.topic.c_str());
   }
+  ESP_LOGCONFIG(TAG, "  Publish Queue Size: %u bytes", this->publish_queue_.get_max_size());  // NOLINT
 }
 bool MQTTClientComponent::can_proceed() { return this->is_connected(); }
 
@@ -202,6 +230,9 @@ void MQTTClientComponent::check_connected() {
   ESP_LOGI(TAG, "MQTT Connected!");
   // MQTT Client needs some time to be fully set up.
   delay(100);
+  // possibly a different or restarted broker, only what it sends from now on counts
+  this->retained_discovery_.clear();
+  this->connected_time_ = millis();
 
   this->resubscribe_subscriptions_();
 
@@ -210,31 +241,37 @@ void MQTTClientComponent::check_connected() {
 }
 
 void MQTTClientComponent::loop() {
+  this->discovery_budget_ = MQTT_DISCOVERY_BUDGET;
+#ifdef USE_MQTT5
+  // also sends the packets published since the last iteration as one batch
+  this->mqtt_client_.loop();
+#endif
+
   if (this->disconnect_reason_.has_value()) {
     const char *reason_s = nullptr;
     switch (*this->disconnect_reason_) {
-      case AsyncMqttClientDisconnectReason::TCP_DISCONNECTED:
+      case MQTTDisconnectReason::TCP_DISCONNECTED:
         reason_s = "TCP disconnected";
         break;
-      case AsyncMqttClientDisconnectReason::MQTT_UNACCEPTABLE_PROTOCOL_VERSION:
+      case MQTTDisconnectReason::MQTT_UNACCEPTABLE_PROTOCOL_VERSION:
         reason_s = "Unacceptable Protocol Version";
         break;
-      case AsyncMqttClientDisconnectReason::MQTT_IDENTIFIER_REJECTED:
+      case MQTTDisconnectReason::MQTT_IDENTIFIER_REJECTED:
         reason_s = "Identifier Rejected";
         break;
-      case AsyncMqttClientDisconnectReason::MQTT_SERVER_UNAVAILABLE:
+      case MQTTDisconnectReason::MQTT_SERVER_UNAVAILABLE:
         reason_s = "Server Unavailable";
         break;
-      case AsyncMqttClientDisconnectReason::MQTT_MALFORMED_CREDENTIALS:
+      case MQTTDisconnectReason::MQTT_MALFORMED_CREDENTIALS:
         reason_s = "Malformed Credentials";
         break;
-      case AsyncMqttClientDisconnectReason::MQTT_NOT_AUTHORIZED:
+      case MQTTDisconnectReason::MQTT_NOT_AUTHORIZED:
         reason_s = "Not Authorized";
         break;
-      case AsyncMqttClientDisconnectReason::ESP8266_NOT_ENOUGH_SPACE:
+      case MQTTDisconnectReason::ESP8266_NOT_ENOUGH_SPACE:
         reason_s = "Not Enough Space";
         break;
-      case AsyncMqttClientDisconnectReason::TLS_BAD_FINGERPRINT:
+      case MQTTDisconnectReason::TLS_BAD_FINGERPRINT:
         reason_s = "TLS Bad Fingerprint";
         break;
       default:
@@ -269,11 +306,16 @@ void MQTTClientComponent::loop() {
         this->start_dnslookup_();
       } else {
         if (!this->birth_message_.topic.empty() && !this->sent_birth_message_) {
-          this->sent_birth_message_ = this->publish(this->birth_message_);
+          // ahead of the messages queued while disconnected
+          this->sent_birth_message_ =
+              this->publish_direct(this->birth_message_.topic, this->birth_message_.payload.data(),
+                                   this->birth_message_.payload.size(), this->birth_message_.qos,
+                                   this->birth_message_.retain);
         }
 
         this->last_connected_ = now;
         this->resubscribe_subscriptions_();
+        this->drain_publish_queue_();
       }
       break;
   }
@@ -329,6 +371,7 @@ void MQTTClientComponent::subscribe(const std::string &topic, mqtt_callback_t ca
       .resubscribe_timeout = 0,
   };
   this->resubscribe_subscription_(&subscription);
+  this->subscription_trie_.insert(topic, this->subscriptions_.size());
   this->subscriptions_.push_back(subscription);
 }
 
@@ -344,6 +387,7 @@ void MQTTClientComponent::subscribe_json(const std::string &topic, mqtt_json_cal
       .resubscribe_timeout = 0,
   };
   this->resubscribe_subscription_(&subscription);
+  this->subscription_trie_.insert(topic, this->subscriptions_.size());
   this->subscriptions_.push_back(subscription);
 }
 
@@ -354,29 +398,52 @@ bool MQTTClientComponent::publish(const std::string &topic, const std::string &p
 
 bool MQTTClientComponent::publish(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
                                   bool retain) {
-  if (!this->is_connected()) {
-    // critical components will re-transmit their messages
+  // the log callback passes log_message_.topic itself, no need to compare the strings
+  if (&topic == &this->log_message_.topic) {
+    // log messages are not queued, and logging about them would recurse
+    return this->is_connected() &&
+           this->mqtt_client_.publish(topic.c_str(), qos, retain, payload, payload_length) != 0;
+  }
+
+  if (this->publish_queue_.empty() && this->publish_direct(topic, payload, payload_length, qos, retain))
+    return true;
+
+  // keep the order of the messages, queued ones are sent from loop()
+  if (!this->publish_queue_.push(topic, payload, payload_length, qos, retain)) {
+    ESP_LOGV(TAG, "Publish failed for topic='%s' (len=%u), not queued.", topic.c_str(),
+             payload_length);  // NOLINT
     return false;
   }
-  bool logging_topic = topic == this->log_message_.topic;
-  uint16_t ret = this->mqtt_client_.publish(topic.c_str(), qos, retain, payload, payload_length);
-  delay(0);
-  if (ret == 0 && !logging_topic && this->is_connected()) {
-    delay(0);
-    ret = this->mqtt_client_.publish(topic.c_str(), qos, retain, payload, payload_length);
-    delay(0);
+  return true;
+}
+
+bool MQTTClientComponent::publish_direct(const std::string &topic, const char *payload, size_t payload_length,
+                                         uint8_t qos, bool retain) {
+  if (!this->is_connected())
+    return false;
+  if (this->mqtt_client_.publish(topic.c_str(), qos, retain, payload, payload_length) == 0) {
+    // TCP buffer full, retried from loop()
+    this->status_momentary_warning("publish", 1000);
+    return false;
   }
+  ESP_LOGV(TAG, "Publish(topic='%s' payload='%.*s' retain=%d)", topic.c_str(), static_cast<int>(payload_length),
+           payload, retain);
+  return true;
+}
 
-  if (!logging_topic) {
-    if (ret != 0) {
-      ESP_LOGV(TAG, "Publish(topic='%s' payload='%s' retain=%d)", topic.c_str(), payload, retain);
-    } else {
-      ESP_LOGV(TAG, "Publish failed for topic='%s' (len=%u). will retry later..", topic.c_str(),
-               payload_length);  // NOLINT
-      this->status_momentary_warning("publish", 1000);
+void MQTTClientComponent::drain_publish_queue_() {
+  for (uint8_t i = 0; i < MQTT_PUBLISH_QUEUE_DRAIN && !this->publish_queue_.empty(); i++) {
+    const MQTTQueuedMessage &message = this->publish_queue_.front();
+    if (!this->publish_direct(message.topic, message.payload.data(), message.payload.size(), message.qos,
+                              message.retain))
+      return;
+    this->publish_queue_.pop();
+    if (this->publish_queue_.empty()) {
+      ESP_LOGD(TAG, "Sent all queued messages (queued %u, coalesced %u, dropped %u in total).",
+               this->publish_queue_.get_queued_count(), this->publish_queue_.get_coalesced_count(),
+               this->publish_queue_.get_dropped_count());
     }
   }
-  return ret != 0;
 }
 
 bool MQTTClientComponent::publish(const MQTTMessage &message) {
@@ -389,72 +456,18 @@ bool MQTTClientComponent::publish_json(const std::string &topic, const json::jso
   return this->publish(topic, message, len, qos, retain);
 }
 
-/** Check if the message topic matches the given subscription topic
- *
- * INFO: MQTT spec mandates that topics must not be empty and must be valid NULL-terminated UTF-8 strings.
- *
- * @param message The message topic that was received from the MQTT server. Note: this must not contain
- *                wildcard characters as mandated by the MQTT spec.
- * @param subscription The subscription topic we are matching against.
- * @param is_normal Is this a "normal" topic - Does the message topic not begin with a "$".
- * @param past_separator Are we past the first '/' topic separator.
- * @return true if the subscription topic matches the message topic, false otherwise.
- */
-static bool topic_match(const char *message, const char *subscription, bool is_normal, bool past_separator) {
-  // Reached end of both strings at the same time, this means we have a successful match
-  if (*message == '\0' && *subscription == '\0')
-    return true;
-
-  // Either the message or the subscribe are at the end. This means they don't match.
-  if (*message == '\0' || *subscription == '\0')
-    return false;
-
-  bool do_wildcards = is_normal || past_separator;
-
-  if (*subscription == '+' && do_wildcards) {
-    // single level wildcard
-    // consume + from subscription
-    subscription++;
-    // consume everything from message until '/' found or end of string
-    while (*message != '\0' && *message != '/') {
-      message++;
-    }
-    // after this, both pointers will point to a '/' or to the end of the string
-
-    return topic_match(message, subscription, is_normal, true);
-  }
-
-  if (*subscription == '#' && do_wildcards) {
-    // multilevel wildcard - MQTT mandates that this must be at end of subscribe topic
-    return true;
-  }
-
-  // this handles '/' and normal characters at the same time.
-  if (*message != *subscription)
-    return false;
-
-  past_separator = past_separator || *subscription == '/';
-
-  // consume characters
-  subscription++;
-  message++;
-
-  return topic_match(message, subscription, is_normal, past_separator);
-}
-
-static bool topic_match(const char *message, const char *subscription) {
-  return topic_match(message, subscription, *message != '\0' && *message != '$', false);
-}
-
 void MQTTClientComponent::on_message(const std::string &topic, const std::string &payload) {
 #ifdef ARDUINO_ARCH_ESP8266
   // on ESP8266, this is called in LWiP thread; some components do not like running
   // in an ISR.
   this->defer([this, topic, payload]() {
 #endif
-    for (auto &subscription : this->subscriptions_)
-      if (topic_match(topic.c_str(), subscription.topic.c_str()))
-        subscription.callback(topic, payload);
+    this->matched_subscriptions_.clear();
+    this->subscription_trie_.match(topic.c_str(), this->matched_subscriptions_);
+    // call the callbacks in subscription order
+    std::sort(this->matched_subscriptions_.begin(), this->matched_subscriptions_.end());
+    for (uint16_t index : this->matched_subscriptions_)
+      this->subscriptions_[index].callback(topic, payload);
 #ifdef ARDUINO_ARCH_ESP8266
   });
 #endif
@@ -469,6 +482,35 @@ void MQTTClientComponent::set_log_level(int level) { this->log_level_ = level; }
 void MQTTClientComponent::set_keep_alive(uint16_t keep_alive_s) { this->mqtt_client_.setKeepAlive(keep_alive_s); }
 void MQTTClientComponent::set_log_message_template(MQTTMessage &&message) { this->log_message_ = std::move(message); }
 const MQTTDiscoveryInfo &MQTTClientComponent::get_discovery_info() const { return this->discovery_info_; }
+bool MQTTClientComponent::has_discovery_budget() const {
+  if (this->checks_retained_discovery_() && millis() - this->connected_time_ < MQTT_RETAINED_DISCOVERY_WAIT)
+    return false;
+  return this->discovery_budget_ > 0;
+}
+bool MQTTClientComponent::checks_retained_discovery_() const {
+  return this->is_discovery_enabled() && this->discovery_info_.retain && !this->discovery_info_.clean;
+}
+void MQTTClientComponent::on_retained_discovery_(const std::string &topic, const std::string &payload) {
+  const uint32_t topic_hash = fnv1_hash(topic);
+  // an empty payload deletes the retained config
+  const uint32_t payload_hash = payload.empty() ? 0 : discovery_payload_hash(payload.data(), payload.size());
+  for (auto &retained : this->retained_discovery_) {
+    if (retained.topic_hash == topic_hash) {
+      retained.payload_hash = payload_hash;
+      return;
+    }
+  }
+  this->retained_discovery_.push_back(MQTTRetainedDiscovery{.topic_hash = topic_hash, .payload_hash = payload_hash});
+}
+bool MQTTClientComponent::is_discovery_retained(const std::string &topic, const char *payload, size_t len) const {
+  const uint32_t topic_hash = fnv1_hash(topic);
+  for (const auto &retained : this->retained_discovery_) {
+    if (retained.topic_hash == topic_hash)
+      return retained.payload_hash == discovery_payload_hash(payload, len);
+  }
+  return false;
+}
+void MQTTClientComponent::consume_discovery_budget(size_t bytes) { this->discovery_budget_ -= bytes; }
 void MQTTClientComponent::set_topic_prefix(std::string topic_prefix) { this->topic_prefix_ = std::move(topic_prefix); }
 const std::string &MQTTClientComponent::get_topic_prefix() const { return this->topic_prefix_; }
 void MQTTClientComponent::disable_birth_message() {
@@ -517,7 +559,9 @@ void MQTTClientComponent::disable_discovery() {
 void MQTTClientComponent::on_shutdown() {
   if (!this->shutdown_message_.topic.empty()) {
     yield();
-    this->publish(this->shutdown_message_);
+    this->publish_direct(this->shutdown_message_.topic, this->shutdown_message_.payload.data(),
+                         this->shutdown_message_.payload.size(), this->shutdown_message_.qos,
+                         this->shutdown_message_.retain);
     yield();
   }
   this->mqtt_client_.disconnect(true);
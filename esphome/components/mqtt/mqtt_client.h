@@ -5,12 +5,27 @@
 #include "esphome/core/automation.h"
 #include "esphome/core/log.h"
 #include "esphome/components/json/json_util.h"
+#include "mqtt_publish_queue.h"
+#include "mqtt_topic_trie.h"
+#include "mqtt5_client.h"
+#ifndef USE_MQTT5
 #include <AsyncMqttClient.h>
+#endif
 #include "lwip/ip_addr.h"
 
 namespace esphome {
 namespace mqtt {
 
+#ifdef USE_MQTT5
+using MQTTBackendClient = MQTT5Client;
+using MQTTDisconnectReason = MQTT5DisconnectReason;
+using MQTTMessageProperties = MQTT5MessageProperties;
+#else
+using MQTTBackendClient = AsyncMqttClient;
+using MQTTDisconnectReason = AsyncMqttClientDisconnectReason;
+using MQTTMessageProperties = AsyncMqttClientMessageProperties;
+#endif
+
 /** Callback for MQTT subscriptions.
  *
  * First parameter is the topic, the second one is the payload.
@@ -26,6 +41,12 @@ struct MQTTMessage {
   bool retain;
 };
 
+/// A discovery config retained by the broker, by the FNV-1 hashes of its topic and payload.
+struct MQTTRetainedDiscovery {
+  uint32_t topic_hash;
+  uint32_t payload_hash;
+};
+
 /// internal struct for MQTT subscriptions.
 struct MQTTSubscription {
   std::string topic;
@@ -166,16 +187,28 @@ class MQTTClientComponent : public Component {
   bool publish(const MQTTMessage &message);
 
   /** Publish a MQTT message
+   *
+   * If the message can't be sent right now (not connected, TCP buffer full or older messages still waiting),
+   * it is put in the publish queue and sent from loop() once possible.
    *
    * @param topic The topic.
    * @param payload The payload.
-   * @param retain Whether to retain the message.
+   * @param retain Whether to retain the message. Retained messages in the queue are replaced by newer ones.
+   * @return false if the message could neither be sent nor queued.
    */
   bool publish(const std::string &topic, const std::string &payload, uint8_t qos = 0, bool retain = false);
 
   bool publish(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos = 0,
                bool retain = false);
 
+  /** Publish a message only if it can be written to the connection right now, without going through the
+   * publish queue.
+   *
+   * @return true once the message has been handed to the connection, false if it wasn't sent.
+   */
+  bool publish_direct(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
+                      bool retain);
+
   /** Construct and send a JSON MQTT message.
    *
    * @param topic The topic.
@@ -202,6 +235,18 @@ class MQTTClientComponent : public Component {
 
   void register_mqtt_component(MQTTComponent *component);
 
+  /** Whether components may still send discovery messages in this loop iteration.
+   *
+   * Discovery payloads are spread over several loop iterations so that a (re)connect doesn't build and
+   * queue the configs of all components at once. The budget is reset at the start of every loop(). With
+   * retained discovery, there's no budget until the broker had time to send the configs it retains.
+   */
+  bool has_discovery_budget() const;
+  /// Whether the broker sent back exactly this discovery payload as retained since connecting.
+  bool is_discovery_retained(const std::string &topic, const char *payload, size_t len) const;
+  /// Account for a discovery payload of the given size against this loop iteration's budget.
+  void consume_discovery_budget(size_t bytes);
+
   bool is_connected();
 
   void on_shutdown() override;
@@ -211,6 +256,9 @@ class MQTTClientComponent : public Component {
   void set_username(const std::string &username) { this->credentials_.username = username; }
   void set_password(const std::string &password) { this->credentials_.password = password; }
   void set_client_id(const std::string &client_id) { this->credentials_.client_id = client_id; }
+  /// Set the memory budget of the publish queue in bytes, 0 disables queueing.
+  void set_publish_queue_size(size_t size) { this->publish_queue_.set_max_size(size); }
+  const MQTTPublishQueue &get_publish_queue() const { return this->publish_queue_; }
 
  protected:
   /// Reconnect to the MQTT broker if not already connected.
@@ -225,6 +273,13 @@ class MQTTClientComponent : public Component {
 
   /// Re-calculate the availability property.
   void recalculate_availability_();
+  /// Whether the discovery configs retained by the broker are checked before sending discovery.
+  bool checks_retained_discovery_() const;
+  /// Record a discovery config of this node that the broker sent.
+  void on_retained_discovery_(const std::string &topic, const std::string &payload);
+
+  /// Send queued messages, at a limited rate so the TCP buffer isn't flooded after a reconnect.
+  void drain_publish_queue_();
 
   bool subscribe_(const char *topic, uint8_t qos);
   void resubscribe_subscription_(MQTTSubscription *sub);
@@ -248,12 +303,23 @@ class MQTTClientComponent : public Component {
       .retain = true,
       .clean = false,
   };
+  /// Discovery payload bytes that may still be sent in this loop iteration.
+  int32_t discovery_budget_{0};
+  /// The discovery configs of this node that the broker sent since connecting.
+  std::vector<MQTTRetainedDiscovery> retained_discovery_;
+  /// Time of the last connect, discovery waits for the retained configs after it.
+  uint32_t connected_time_{0};
   std::string topic_prefix_{};
   MQTTMessage log_message_;
   int log_level_{ESPHOME_LOG_LEVEL};
 
+  MQTTPublishQueue publish_queue_;
   std::vector<MQTTSubscription> subscriptions_;
-  AsyncMqttClient mqtt_client_;
+  /// Index of subscriptions_ by topic.
+  MQTTTopicTrie subscription_trie_;
+  /// Scratch buffer for on_message().
+  std::vector<uint16_t> matched_subscriptions_;
+  MQTTBackendClient mqtt_client_;
   MQTTClientState state_{MQTT_CLIENT_DISCONNECTED};
   IPAddress ip_;
   bool dns_resolved_{false};
@@ -262,7 +328,7 @@ class MQTTClientComponent : public Component {
   uint32_t reboot_timeout_{300000};
   uint32_t connect_begin_;
   uint32_t last_connected_{0};
-  optional<AsyncMqttClientDisconnectReason> disconnect_reason_{};
+  optional<MQTTDisconnectReason> disconnect_reason_{};
 };
 
 extern MQTTClientComponent *global_mqtt_client;
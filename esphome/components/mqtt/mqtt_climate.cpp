@@ -10,55 +10,57 @@ static const char *TAG = "mqtt.climate";
 
 using namespace esphome::climate;
 
-void MQTTClimateComponent::send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) {
+void MQTTClimateComponent::send_discovery(json::JsonWriter &writer, mqtt::SendDiscoveryConfig &config) {
   auto traits = this->device_->get_traits();
   // current_temperature_topic
   if (traits.get_supports_current_temperature()) {
-    root["current_temperature_topic"] = this->get_current_temperature_state_topic();
+    writer.add("current_temperature_topic", this->get_current_temperature_state_topic());
   }
   // mode_command_topic
-  root["mode_command_topic"] = this->get_mode_command_topic();
+  writer.add("mode_command_topic", this->get_mode_command_topic());
   // mode_state_topic
-  root["mode_state_topic"] = this->get_mode_state_topic();
+  writer.add("mode_state_topic", this->get_mode_state_topic());
   // modes
-  JsonArray &modes = root.createNestedArray("modes");
+  writer.key("modes");
+  writer.begin_array();
   // sort array for nice UI in HA
   if (traits.supports_mode(CLIMATE_MODE_AUTO))
-    modes.add("auto");
-  modes.add("off");
+    writer.value("auto");
+  writer.value("off");
   if (traits.supports_mode(CLIMATE_MODE_COOL))
-    modes.add("cool");
+    writer.value("cool");
   if (traits.supports_mode(CLIMATE_MODE_HEAT))
-    modes.add("heat");
+    writer.value("heat");
+  writer.end_array();
 
   if (traits.get_supports_two_point_target_temperature()) {
     // temperature_low_command_topic
-    root["temperature_low_command_topic"] = this->get_target_temperature_low_command_topic();
+    writer.add("temperature_low_command_topic", this->get_target_temperature_low_command_topic());
     // temperature_low_state_topic
-    root["temperature_low_state_topic"] = this->get_target_temperature_low_state_topic();
+    writer.add("temperature_low_state_topic", this->get_target_temperature_low_state_topic());
     // temperature_high_command_topic
-    root["temperature_high_command_topic"] = this->get_target_temperature_high_command_topic();
+    writer.add("temperature_high_command_topic", this->get_target_temperature_high_command_topic());
     // temperature_high_state_topic
-    root["temperature_high_state_topic"] = this->get_target_temperature_high_state_topic();
+    writer.add("temperature_high_state_topic", this->get_target_temperature_high_state_topic());
   } else {
     // temperature_command_topic
-    root["temperature_command_topic"] = this->get_target_temperature_command_topic();
+    writer.add("temperature_command_topic", this->get_target_temperature_command_topic());
     // temperature_state_topic
-    root["temperature_state_topic"] = this->get_target_temperature_state_topic();
+    writer.add("temperature_state_topic", this->get_target_temperature_state_topic());
   }
 
   // min_temp
-  root["min_temp"] = traits.get_visual_min_temperature();
+  writer.add("min_temp", traits.get_visual_min_temperature());
   // max_temp
-  root["max_temp"] = traits.get_visual_max_temperature();
+  writer.add("max_temp", traits.get_visual_max_temperature());
   // temp_step
-  root["temp_step"] = traits.get_visual_temperature_step();
+  writer.add("temp_step", traits.get_visual_temperature_step());
 
   if (traits.get_supports_away()) {
     // away_mode_command_topic
-    root["away_mode_command_topic"] = this->get_away_command_topic();
+    writer.add("away_mode_command_topic", this->get_away_command_topic());
     // away_mode_state_topic
-    root["away_mode_state_topic"] = this->get_away_state_topic();
+    writer.add("away_mode_state_topic", this->get_away_state_topic());
   }
   config.state_topic = false;
   config.command_topic = false;
@@ -146,27 +148,27 @@ bool MQTTClimateComponent::publish_state_() {
   if (!this->publish(this->get_mode_state_topic(), mode_s))
     success = false;
   int8_t accuracy = traits.get_temperature_accuracy_decimals();
+  char payload[VALUE_ACCURACY_BUF_SIZE];
   if (traits.get_supports_current_temperature() && !isnan(this->device_->current_temperature)) {
-    std::string payload = value_accuracy_to_string(this->device_->current_temperature, accuracy);
+    value_accuracy_to_buf(payload, this->device_->current_temperature, accuracy);
     if (!this->publish(this->get_current_temperature_state_topic(), payload))
       success = false;
   }
   if (traits.get_supports_two_point_target_temperature()) {
-    std::string payload = value_accuracy_to_string(this->device_->target_temperature_low, accuracy);
+    value_accuracy_to_buf(payload, this->device_->target_temperature_low, accuracy);
     if (!this->publish(this->get_target_temperature_low_state_topic(), payload))
       success = false;
-    payload = value_accuracy_to_string(this->device_->target_temperature_high, accuracy);
+    value_accuracy_to_buf(payload, this->device_->target_temperature_high, accuracy);
     if (!this->publish(this->get_target_temperature_high_state_topic(), payload))
       success = false;
   } else {
-    std::string payload = value_accuracy_to_string(this->device_->target_temperature, accuracy);
+    value_accuracy_to_buf(payload, this->device_->target_temperature, accuracy);
     if (!this->publish(this->get_target_temperature_state_topic(), payload))
       success = false;
   }
 
   if (traits.get_supports_away()) {
-    std::string payload = ONOFF(this->device_->away);
-    if (!this->publish(this->get_away_state_topic(), payload))
+    if (!this->publish(this->get_away_state_topic(), ONOFF(this->device_->away)))
       success = false;
   }
 
@@ -13,7 +13,7 @@ namespace mqtt {
 class MQTTClimateComponent : public mqtt::MQTTComponent {
  public:
   MQTTClimateComponent(climate::Climate *device);
-  void send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) override;
+  void send_discovery(json::JsonWriter &writer, mqtt::SendDiscoveryConfig &config) override;
   bool send_initial_state() override;
   bool is_internal() override;
   std::string component_type() const override;
@@ -9,6 +9,9 @@ namespace mqtt {
 
 static const char *TAG = "mqtt.component";
 
+/// Stack buffer for the discovery payload, enough for all but the largest (e.g. lights with many effects).
+static const size_t MQTT_DISCOVERY_BUFFER_SIZE = 512;
+
 void MQTTComponent::set_retain(bool retain) { this->retain_ = retain; }
 
 std::string MQTTComponent::get_discovery_topic_(const MQTTDiscoveryInfo &discovery_info) const {
@@ -22,22 +25,28 @@ std::string MQTTComponent::get_default_topic_for_(const std::string &suffix) con
          "/" + suffix;
 }
 
-const std::string MQTTComponent::get_state_topic_() const {
-  if (this->custom_state_topic_.empty())
-    return this->get_default_topic_for_("state");
-  return this->custom_state_topic_;
+const std::string &MQTTComponent::get_state_topic_() const {
+  if (this->state_topic_.empty())
+    this->state_topic_ = this->get_default_topic_for_("state");
+  return this->state_topic_;
 }
 
-const std::string MQTTComponent::get_command_topic_() const {
-  if (this->custom_command_topic_.empty())
-    return this->get_default_topic_for_("command");
-  return this->custom_command_topic_;
+const std::string &MQTTComponent::get_command_topic_() const {
+  if (this->command_topic_.empty())
+    this->command_topic_ = this->get_default_topic_for_("command");
+  return this->command_topic_;
 }
 
 bool MQTTComponent::publish(const std::string &topic, const std::string &payload) {
+  return this->publish(topic, payload.data(), payload.size());
+}
+bool MQTTComponent::publish(const std::string &topic, const char *payload, size_t payload_length) {
   if (topic.empty())
     return false;
-  return global_mqtt_client->publish(topic, payload, 0, this->retain_);
+  return global_mqtt_client->publish(topic, payload, payload_length, 0, this->retain_);
+}
+bool MQTTComponent::publish(const std::string &topic, const char *payload) {
+  return this->publish(topic, payload, strlen(payload));
 }
 
 bool MQTTComponent::publish_json(const std::string &topic, const json::json_build_t &f) {
@@ -49,65 +58,80 @@ bool MQTTComponent::publish_json(const std::string &topic, const json::json_buil
 bool MQTTComponent::send_discovery_() {
   const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
 
+  const std::string topic = this->get_discovery_topic_(discovery_info);
   if (discovery_info.clean) {
     ESP_LOGV(TAG, "'%s': Cleaning discovery...", this->friendly_name().c_str());
-    return global_mqtt_client->publish(this->get_discovery_topic_(discovery_info), "", 0, 0, true);
+    return global_mqtt_client->publish_direct(topic, "", 0, 0, true);
   }
 
-  ESP_LOGV(TAG, "'%s': Sending discovery...", this->friendly_name().c_str());
+  // serialized right into the payload buffer, without building a JSON document first
+  json::StaticJsonWriter<MQTT_DISCOVERY_BUFFER_SIZE> writer;
+  writer.begin_object();
+  SendDiscoveryConfig config;
+  config.state_topic = true;
+  config.command_topic = true;
+
+  this->send_discovery(writer, config);
+
+  writer.add("name", this->friendly_name());
+  if (config.state_topic)
+    writer.add("state_topic", this->get_state_topic_());
+  if (config.command_topic)
+    writer.add("command_topic", this->get_command_topic_());
+
+  const Availability *availability = this->availability_;
+  if (availability == nullptr)
+    availability = &global_mqtt_client->get_availability();
+  if (!availability->topic.empty()) {
+    writer.add("availability_topic", availability->topic);
+    if (availability->payload_available != "online")
+      writer.add("payload_available", availability->payload_available);
+    if (availability->payload_not_available != "offline")
+      writer.add("payload_not_available", availability->payload_not_available);
+  }
 
-  return global_mqtt_client->publish_json(
-      this->get_discovery_topic_(discovery_info),
-      [this](JsonObject &root) {
-        SendDiscoveryConfig config;
-        config.state_topic = true;
-        config.command_topic = true;
-
-        this->send_discovery(root, config);
-
-        std::string name = this->friendly_name();
-        root["name"] = name;
-        if (config.state_topic)
-          root["state_topic"] = this->get_state_topic_();
-        if (config.command_topic)
-          root["command_topic"] = this->get_command_topic_();
-
-        if (this->availability_ == nullptr) {
-          if (!global_mqtt_client->get_availability().topic.empty()) {
-            root["availability_topic"] = global_mqtt_client->get_availability().topic;
-            if (global_mqtt_client->get_availability().payload_available != "online")
-              root["payload_available"] = global_mqtt_client->get_availability().payload_available;
-            if (global_mqtt_client->get_availability().payload_not_available != "offline")
-              root["payload_not_available"] = global_mqtt_client->get_availability().payload_not_available;
-          }
-        } else if (!this->availability_->topic.empty()) {
-          root["availability_topic"] = this->availability_->topic;
-          if (this->availability_->payload_available != "online")
-            root["payload_available"] = this->availability_->payload_available;
-          if (this->availability_->payload_not_available != "offline")
-            root["payload_not_available"] = this->availability_->payload_not_available;
-        }
-
-        const std::string &node_name = App.get_name();
-        std::string unique_id = this->unique_id();
-        if (!unique_id.empty()) {
-          root["unique_id"] = unique_id;
-        } else {
-          // default to almost-unique ID. It's a hack but the only way to get that
-          // gorgeous device registry view.
-          root["unique_id"] = "ESP" + this->component_type() + this->get_default_object_id_();
-        }
-
-        JsonObject &device_info = root.createNestedObject("device");
-        device_info["identifiers"] = get_mac_address();
-        device_info["name"] = node_name;
-        device_info["sw_version"] = "esphome v" ESPHOME_VERSION " " + App.get_compilation_time();
+  std::string unique_id = this->unique_id();
+  if (!unique_id.empty()) {
+    writer.add("unique_id", unique_id);
+  } else {
+    // default to almost-unique ID. It's a hack but the only way to get that
+    // gorgeous device registry view.
+    writer.key("unique_id");
+    writer.begin_string();
+    writer.append_string("ESP", 3);
+    writer.append_string(this->component_type());
+    writer.append_string(this->get_default_object_id_());
+    writer.end_string();
+  }
+
+  writer.key("device");
+  writer.begin_object();
+  writer.add("identifiers", get_mac_address());
+  writer.add("name", App.get_name());
+  writer.key("sw_version");
+  writer.begin_string();
+  writer.append_string("esphome v" ESPHOME_VERSION " ", strlen("esphome v" ESPHOME_VERSION " "));
+  writer.append_string(App.get_compilation_time());
+  writer.end_string();
 #ifdef ARDUINO_BOARD
-        device_info["model"] = ARDUINO_BOARD;
+  writer.add("model", ARDUINO_BOARD);
 #endif
-        device_info["manufacturer"] = "espressif";
-      },
-      0, discovery_info.retain);
+  writer.add("manufacturer", "espressif");
+  writer.end_object();
+  writer.end_object();
+
+  const char *message = writer.c_str();
+  const size_t len = writer.size();
+  global_mqtt_client->consume_discovery_budget(len);
+
+  if (discovery_info.retain && global_mqtt_client->is_discovery_retained(topic, message, len)) {
+    // the broker sent this exact config back as retained since connecting
+    ESP_LOGV(TAG, "'%s': Discovery unchanged, not sending.", this->friendly_name().c_str());
+    return true;
+  }
+
+  ESP_LOGV(TAG, "'%s': Sending discovery...", this->friendly_name().c_str());
+  return global_mqtt_client->publish_direct(topic, message, len, 0, discovery_info.retain);
 }
 
 bool MQTTComponent::get_retain() const { return this->retain_; }
@@ -133,10 +157,10 @@ MQTTComponent::MQTTComponent() = default;
 float MQTTComponent::get_setup_priority() const { return setup_priority::AFTER_CONNECTION; }
 void MQTTComponent::disable_discovery() { this->discovery_enabled_ = false; }
 void MQTTComponent::set_custom_state_topic(const std::string &custom_state_topic) {
-  this->custom_state_topic_ = custom_state_topic;
+  this->state_topic_ = custom_state_topic;
 }
 void MQTTComponent::set_custom_command_topic(const std::string &custom_command_topic) {
-  this->custom_command_topic_ = custom_command_topic;
+  this->command_topic_ = custom_command_topic;
 }
 
 void MQTTComponent::set_availability(std::string topic, std::string payload_available,
@@ -156,17 +180,8 @@ void MQTTComponent::call_setup() {
 
   global_mqtt_client->register_mqtt_component(this);
 
-  if (!this->is_connected_())
-    return;
-
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
-  if (!this->send_initial_state()) {
-    this->schedule_resend_state();
-  }
+  // discovery and initial state are sent from call_loop(), within the client's discovery budget
+  this->schedule_resend_state();
 }
 
 void MQTTComponent::call_loop() {
@@ -181,6 +196,11 @@ void MQTTComponent::call_loop() {
 
   this->resend_state_ = false;
   if (this->is_discovery_enabled()) {
+    if (!global_mqtt_client->has_discovery_budget()) {
+      // try again in the next loop iteration, the state is sent after the discovery message
+      this->schedule_resend_state();
+      return;
+    }
     if (!this->send_discovery_()) {
       this->schedule_resend_state();
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/components/json/json_writer.h"
 #include "mqtt_client.h"
 
 namespace esphome {
@@ -22,14 +23,15 @@ struct SendDiscoveryConfig {
 
 #define MQTT_COMPONENT_CUSTOM_TOPIC_(name, type) \
  protected: \
-  std::string custom_##name##_##type##_topic_{}; \
+  /* the custom topic, or the default topic once it has been built */ \
+  mutable std::string name##_##type##_topic_{}; \
 \
  public: \
-  void set_custom_##name##_##type##_topic(const std::string &topic) { this->custom_##name##_##type##_topic_ = topic; } \
-  const std::string get_##name##_##type##_topic() const { \
-    if (this->custom_##name##_##type##_topic_.empty()) \
-      return this->get_default_topic_for_(#name "/" #type); \
-    return this->custom_##name##_##type##_topic_; \
+  void set_custom_##name##_##type##_topic(const std::string &topic) { this->name##_##type##_topic_ = topic; } \
+  const std::string &get_##name##_##type##_topic() const { \
+    if (this->name##_##type##_topic_.empty()) \
+      this->name##_##type##_topic_ = this->get_default_topic_for_(#name "/" #type); \
+    return this->name##_##type##_topic_; \
   }
 
 #define MQTT_COMPONENT_CUSTOM_TOPIC(name, type) MQTT_COMPONENT_CUSTOM_TOPIC_(name, type)
@@ -60,8 +62,8 @@ class MQTTComponent : public Component {
 
   void call_loop() override;
 
-  /// Send discovery info the Home Assistant, override this.
-  virtual void send_discovery(JsonObject &root, SendDiscoveryConfig &config) = 0;
+  /// Send discovery info the Home Assistant, override this. Members are written into the discovery object.
+  virtual void send_discovery(json::JsonWriter &writer, SendDiscoveryConfig &config) = 0;
 
   virtual bool send_initial_state() = 0;
 
@@ -102,6 +104,8 @@ class MQTTComponent : public Component {
    * @param payload The payload.
    */
   bool publish(const std::string &topic, const std::string &payload);
+  bool publish(const std::string &topic, const char *payload, size_t payload_length);
+  bool publish(const std::string &topic, const char *payload);
 
   /** Construct and send a JSON MQTT message.
    *
@@ -150,15 +154,19 @@ class MQTTComponent : public Component {
    */
   virtual std::string unique_id();
 
-  /// Get the MQTT topic that new states will be shared to.
-  const std::string get_state_topic_() const;
+  /// Get the MQTT topic that new states will be shared to, built once.
+  const std::string &get_state_topic_() const;
 
-  /// Get the MQTT topic for listening to commands.
-  const std::string get_command_topic_() const;
+  /// Get the MQTT topic for listening to commands, built once.
+  const std::string &get_command_topic_() const;
 
   bool is_connected_() const;
 
-  /// Internal method to start sending discovery info, this will call send_discovery().
+  /** Internal method to start sending discovery info, this will call send_discovery().
+   *
+   * With retained discovery, a payload is not sent again if the broker sent back the same one as retained
+   * after connecting.
+   */
   bool send_discovery_();
 
   // ========== INTERNAL METHODS ==========
@@ -167,8 +175,9 @@ class MQTTComponent : public Component {
   std::string get_default_object_id_() const;
 
  protected:
-  std::string custom_state_topic_{};
-  std::string custom_command_topic_{};
+  /// The custom topics, or the default topics once they have been built.
+  mutable std::string state_topic_{};
+  mutable std::string command_topic_{};
   bool retain_{true};
   bool discovery_enabled_{true};
   Availability *availability_{nullptr};
@@ -60,18 +60,18 @@ void MQTTCoverComponent::dump_config() {
     ESP_LOGCONFIG(TAG, "  Tilt Command Topic: '%s'", this->get_tilt_command_topic().c_str());
   }
 }
-void MQTTCoverComponent::send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) {
+void MQTTCoverComponent::send_discovery(json::JsonWriter &writer, mqtt::SendDiscoveryConfig &config) {
   auto traits = this->cover_->get_traits();
   if (traits.get_is_assumed_state()) {
-    root["optimistic"] = true;
+    writer.add("optimistic", true);
   }
   if (traits.get_supports_position()) {
-    root["position_topic"] = this->get_position_state_topic();
-    root["set_position_topic"] = this->get_position_command_topic();
+    writer.add("position_topic", this->get_position_state_topic());
+    writer.add("set_position_topic", this->get_position_command_topic());
   }
   if (traits.get_supports_tilt()) {
-    root["tilt_status_topic"] = this->get_tilt_state_topic();
-    root["tilt_command_topic"] = this->get_tilt_command_topic();
+    writer.add("tilt_status_topic", this->get_tilt_state_topic());
+    writer.add("tilt_command_topic", this->get_tilt_command_topic());
   }
 }
 
@@ -93,12 +93,14 @@ bool MQTTCoverComponent::publish_state() {
     if (!this->publish(this->get_state_topic_(), state_s))
       success = false;
   } else {
-    std::string pos = value_accuracy_to_string(roundf(this->cover_->position * 100), 0);
+    char pos[VALUE_ACCURACY_BUF_SIZE];
+    value_accuracy_to_buf(pos, roundf(this->cover_->position * 100), 0);
     if (!this->publish(this->get_position_state_topic(), pos))
       success = false;
   }
   if (traits.get_supports_tilt()) {
-    std::string pos = value_accuracy_to_string(roundf(this->cover_->tilt * 100), 0);
+    char pos[VALUE_ACCURACY_BUF_SIZE];
+    value_accuracy_to_buf(pos, roundf(this->cover_->tilt * 100), 0);
     if (!this->publish(this->get_tilt_state_topic(), pos))
       success = false;
   }
@@ -8,6 +8,9 @@ namespace mqtt {
 
 static const char *TAG = "mqtt.light";
 
+/// Longer states (effects with long names) are moved to the heap.
+static const size_t MQTT_LIGHT_STATE_BUFFER_SIZE = 192;
+
 using namespace esphome::light;
 
 std::string MQTTJSONLightComponent::component_type() const { return "light"; }
@@ -24,27 +27,33 @@ void MQTTJSONLightComponent::setup() {
 MQTTJSONLightComponent::MQTTJSONLightComponent(LightState *state) : MQTTComponent(), state_(state) {}
 
 bool MQTTJSONLightComponent::publish_state_() {
-  return this->publish_json(this->get_state_topic_(), [this](JsonObject &root) { this->state_->dump_json(root); });
+  json::StaticJsonWriter<MQTT_LIGHT_STATE_BUFFER_SIZE> writer;
+  writer.begin_object();
+  this->state_->dump_json(writer);
+  writer.end_object();
+  return this->publish(this->get_state_topic_(), writer.c_str(), writer.size());
 }
 LightState *MQTTJSONLightComponent::get_state() const { return this->state_; }
 std::string MQTTJSONLightComponent::friendly_name() const { return this->state_->get_name(); }
-void MQTTJSONLightComponent::send_discovery(JsonObject &root, mqtt::SendDiscoveryConfig &config) {
-  root["schema"] = "json";
+void MQTTJSONLightComponent::send_discovery(json::JsonWriter &writer, mqtt::SendDiscoveryConfig &config) {
+  writer.add("schema", "json");
   auto traits = this->state_->get_traits();
   if (traits.get_supports_brightness())
-    root["brightness"] = true;
+    writer.add("brightness", true);
   if (traits.get_supports_rgb())
-    root["rgb"] = true;
+    writer.add("rgb", true);
   if (traits.get_supports_color_temperature())
-    root["color_temp"] = true;
+    writer.add("color_temp", true);
   if (traits.get_supports_rgb_white_value())
-    root["white_value"] = true;
+    writer.add("white_value", true);
   if (this->state_->supports_effects()) {
-    root["effect"] = true;
-    JsonArray &effect_list = root.createNestedArray("effect_list");
+    writer.add("effect", true);
+    writer.key("effect_list");
+    writer.begin_array();
     for (auto *effect : this->state_->get_effects())
-      effect_list.add(effect->get_name());
-    effect_list.add("None");
+      writer.value(effect->get_name());
+    writer.value("None");
+    writer.end_array();
   }
 }
 bool MQTTJSONLightComponent::send_initial_state() { return this->publish_state_(); }
@@ -0,0 +1,65 @@
+#include "mqtt_publish_queue.h"
+
+namespace esphome {
+namespace mqtt {
+
+void MQTTPublishQueue::set_max_size(size_t max_size) { this->max_size_ = max_size; }
+size_t MQTTPublishQueue::get_max_size() const { return this->max_size_; }
+
+size_t MQTTPublishQueue::message_size_(const MQTTQueuedMessage &message) {
+  return sizeof(MQTTQueuedMessage) + message.topic.size() + message.payload.size();
+}
+
+bool MQTTPublishQueue::push(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
+                            bool retain) {
+  if (sizeof(MQTTQueuedMessage) + topic.size() + payload_length > this->max_size_) {
+    this->dropped_count_++;
+    return false;
+  }
+
+  MQTTQueuedMessage *message = nullptr;
+  if (retain) {
+    for (auto &queued : this->messages_) {
+      if (queued.retain && queued.topic == topic) {
+        message = &queued;
+        break;
+      }
+    }
+  }
+  if (message != nullptr) {
+    this->used_size_ -= message->payload.size();
+    message->payload.assign(payload, payload_length);
+    message->qos = qos;
+    this->used_size_ += payload_length;
+    this->coalesced_count_++;
+  } else {
+    this->messages_.push_back(MQTTQueuedMessage{
+        .topic = topic,
+        .payload = std::string(payload, payload_length),
+        .qos = qos,
+        .retain = retain,
+    });
+    this->used_size_ += message_size_(this->messages_.back());
+    this->queued_count_++;
+  }
+
+  while (this->used_size_ > this->max_size_) {
+    this->pop();
+    this->dropped_count_++;
+  }
+  return true;
+}
+
+bool MQTTPublishQueue::empty() const { return this->messages_.empty(); }
+const MQTTQueuedMessage &MQTTPublishQueue::front() const { return this->messages_.front(); }
+void MQTTPublishQueue::pop() {
+  this->used_size_ -= message_size_(this->messages_.front());
+  this->messages_.pop_front();
+}
+
+uint32_t MQTTPublishQueue::get_queued_count() const { return this->queued_count_; }
+uint32_t MQTTPublishQueue::get_coalesced_count() const { return this->coalesced_count_; }
+uint32_t MQTTPublishQueue::get_dropped_count() const { return this->dropped_count_; }
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace esphome {
+namespace mqtt {
+
+/// A message waiting in a MQTTPublishQueue.
+struct MQTTQueuedMessage {
+  std::string topic;
+  std::string payload;
+  uint8_t qos;
+  bool retain;
+};
+
+/** Bounded queue of the messages that couldn't be published immediately (while disconnected or while the
+ * TCP send buffer is full).
+ *
+ * Retained messages are treated as state: a newer message for the same topic replaces the queued one, so only
+ * the latest value is sent. All other messages are events and are kept in order. Once the memory budget is
+ * exceeded, the oldest messages are dropped.
+ */
+class MQTTPublishQueue {
+ public:
+  /// Set the memory budget in bytes, 0 disables queueing.
+  void set_max_size(size_t max_size);
+  size_t get_max_size() const;
+
+  /// Queue a message, returns false if it doesn't fit into the budget at all.
+  bool push(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos, bool retain);
+  bool empty() const;
+  const MQTTQueuedMessage &front() const;
+  void pop();
+
+  /// Number of messages added to the queue.
+  uint32_t get_queued_count() const;
+  /// Number of queued state messages replaced by a newer one before being sent.
+  uint32_t get_coalesced_count() const;
+  /// Number of messages dropped because they didn't fit into the budget.
+  uint32_t get_dropped_count() const;
+
+ protected:
+  static size_t message_size_(const MQTTQueuedMessage &message);
+
+  std::deque<MQTTQueuedMessage> messages_;
+  size_t max_size_{0};
+  /// Memory used by the queued messages, estimated.
+  size_t used_size_{0};
+  uint32_t queued_count_{0};
+  uint32_t coalesced_count_{0};
+  uint32_t dropped_count_{0};
+};
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -0,0 +1,98 @@
+#include "mqtt_topic_trie.h"
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace mqtt {
+
+MQTTTopicTrie::MQTTTopicTrie() : nodes_(1) {}
+
+static size_t level_length(const char *topic) {
+  const char *end = strchr(topic, '/');
+  return end == nullptr ? strlen(topic) : end - topic;
+}
+
+void MQTTTopicTrie::insert(const std::string &subscription, uint16_t index) {
+  uint16_t node = 0;
+  const char *level = subscription.c_str();
+  while (true) {
+    const size_t len = level_length(level);
+    if (len == 1 && *level == '#') {
+      // multi-level wildcard, MQTT mandates that this is the last level
+      this->nodes_[node].hash_subscriptions.push_back(index);
+      return;
+    }
+    if (len == 1 && *level == '+') {
+      if (this->nodes_[node].plus_child == 0) {
+        this->nodes_.emplace_back();
+        this->nodes_.back().level = "+";
+        this->nodes_[node].plus_child = this->nodes_.size() - 1;
+      }
+      node = this->nodes_[node].plus_child;
+    } else {
+      uint16_t child = this->find_child_(node, level, len);
+      node = child != 0 ? child : this->add_child_(node, level, len);
+    }
+    if (level[len] == '\0')
+      break;
+    level += len + 1;
+  }
+  this->nodes_[node].subscriptions.push_back(index);
+}
+
+static bool level_less(const std::string &a, const char *level, size_t len) {
+  return a.compare(0, std::string::npos, level, len) < 0;
+}
+uint16_t MQTTTopicTrie::find_child_(uint16_t node, const char *level, size_t len) const {
+  const auto &children = this->nodes_[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), 0, [this, level, len](uint16_t child, int) {
+    return level_less(this->nodes_[child].level, level, len);
+  });
+  if (it != children.end() && this->nodes_[*it].level.compare(0, std::string::npos, level, len) == 0)
+    return *it;
+  return 0;
+}
+uint16_t MQTTTopicTrie::add_child_(uint16_t node, const char *level, size_t len) {
+  auto &children = this->nodes_[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), 0, [this, level, len](uint16_t child, int) {
+    return level_less(this->nodes_[child].level, level, len);
+  });
+  const uint16_t child = this->nodes_.size();
+  children.insert(it, child);
+  // invalidates children
+  this->nodes_.emplace_back();
+  this->nodes_.back().level.assign(level, len);
+  return child;
+}
+
+void MQTTTopicTrie::match(const char *topic, std::vector<uint16_t> &out) const {
+  // wildcards on the first level don't match topics starting with '$'
+  this->match_(0, topic, *topic != '$', out);
+}
+void MQTTTopicTrie::match_(uint16_t node, const char *topic, bool wildcards, std::vector<uint16_t> &out) const {
+  const MQTTTopicNode &n = this->nodes_[node];
+  if (wildcards)
+    // '#' matches all remaining levels
+    out.insert(out.end(), n.hash_subscriptions.begin(), n.hash_subscriptions.end());
+
+  const size_t len = level_length(topic);
+  const bool last = topic[len] == '\0';
+  const uint16_t children[2] = {this->find_child_(node, topic, len), wildcards ? n.plus_child : uint16_t(0)};
+  for (uint16_t child : children) {
+    if (child == 0)
+      continue;
+    if (last)
+      this->add_end_matches_(child, out);
+    else
+      this->match_(child, topic + len + 1, true, out);
+  }
+}
+void MQTTTopicTrie::add_end_matches_(uint16_t node, std::vector<uint16_t> &out) const {
+  const MQTTTopicNode &n = this->nodes_[node];
+  out.insert(out.end(), n.subscriptions.begin(), n.subscriptions.end());
+  // 'a/#' also matches 'a'
+  out.insert(out.end(), n.hash_subscriptions.begin(), n.hash_subscriptions.end());
+}
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace mqtt {
+
+/// One topic level of a MQTTTopicTrie.
+struct MQTTTopicNode {
+  std::string level;
+  /// Indices of the exact match child nodes, sorted by level.
+  std::vector<uint16_t> children;
+  /// Index of the '+' child node, 0 if there's none (the root is never a child).
+  uint16_t plus_child{0};
+  /// Subscriptions ending at this level.
+  std::vector<uint16_t> subscriptions;
+  /// Subscriptions ending with a '#' after this level.
+  std::vector<uint16_t> hash_subscriptions;
+};
+
+/** Index of the MQTT subscription topics, for matching incoming topics in time proportional to the topic depth.
+ *
+ * Subscriptions are identified by their index in MQTTClientComponent::subscriptions_.
+ */
+class MQTTTopicTrie {
+ public:
+  MQTTTopicTrie();
+  void insert(const std::string &subscription, uint16_t index);
+  /// Append the index of every subscription matching the (wildcard-free) message topic to out.
+  void match(const char *topic, std::vector<uint16_t> &out) const;
+
+ protected:
+  /// Find the exact match child node for a topic level, 0 if there's none.
+  uint16_t find_child_(uint16_t node, const char *level, size_t len) const;
+  uint16_t add_child_(uint16_t node, const char *level, size_t len);
+  void match_(uint16_t node, const char *topic, bool wildcards, std::vector<uint16_t> &out) const;
+  void add_end_matches_(uint16_t node, std::vector<uint16_t> &out) const;
+
+  /// All nodes, nodes_[0] is the root.
+  std::vector<MQTTTopicNode> nodes_;
+};
+
+}  // namespace mqtt
+}  // namespace esphome
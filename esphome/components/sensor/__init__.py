@@ -5,9 +5,10 @@ import esphome.config_validation as cv
 from esphome import automation
 from esphome.components import mqtt
 from esphome.const import CONF_ABOVE, CONF_ACCURACY_DECIMALS, CONF_ALPHA, CONF_BELOW, \
-    CONF_EXPIRE_AFTER, CONF_FILTERS, CONF_FROM, CONF_ICON, CONF_ID, CONF_INTERNAL, \
-    CONF_ON_RAW_VALUE, CONF_ON_VALUE, CONF_ON_VALUE_RANGE, \
-    CONF_SEND_EVERY, CONF_SEND_FIRST_AT, CONF_TO, CONF_TRIGGER_ID, \
+    CONF_EXPIRE_AFTER, CONF_FILTERS, CONF_FROM, CONF_HISTORY, CONF_HOURS, CONF_ICON, CONF_ID, \
+    CONF_INTERNAL, CONF_MAX_VALUE, CONF_MIN_VALUE, CONF_MINUTES, CONF_RAW, CONF_RESOLUTION, \
+    CONF_ON_RAW_VALUE, CONF_ON_VALUE, CONF_ON_VALUE_RANGE, CONF_QUANTILE, \
+    CONF_SEND_EVERY, CONF_SEND_FIRST_AT, CONF_TO, CONF_TRIGGER_ID, CONF_TYPE_ID, \
     CONF_UNIT_OF_MEASUREMENT, \
     CONF_WINDOW_SIZE, CONF_NAME, CONF_MQTT_ID
 from esphome.core import CORE, coroutine, coroutine_with_priority
@@ -25,6 +26,26 @@ def validate_send_first_at(value):
     return value
 
 
+# The fixed-point values of a history are 16 bit steps away from its base, INT16_MIN marks missing values
+HISTORY_MAX_STEPS = 32766
+
+
+def validate_history_range(value):
+    if (CONF_MIN_VALUE in value) != (CONF_MAX_VALUE in value):
+        raise cv.Invalid("min_value and max_value must be set together")
+    if CONF_MIN_VALUE not in value:
+        return value
+    if value[CONF_MIN_VALUE] >= value[CONF_MAX_VALUE]:
+        raise cv.Invalid("min_value must be smaller than max_value! {} < {}"
+                         "".format(value[CONF_MIN_VALUE], value[CONF_MAX_VALUE]))
+    min_resolution = (value[CONF_MAX_VALUE] - value[CONF_MIN_VALUE]) / 2.0 / HISTORY_MAX_STEPS
+    if CONF_RESOLUTION in value and value[CONF_RESOLUTION] < min_resolution:
+        raise cv.Invalid("The range {} to {} doesn't fit into the history with a resolution of {}, use at least "
+                         "{:.3g}".format(value[CONF_MIN_VALUE], value[CONF_MAX_VALUE], value[CONF_RESOLUTION],
+                                         min_resolution))
+    return value
+
+
 FILTER_REGISTRY = Registry()
 validate_filters = cv.validate_registry('filter', FILTER_REGISTRY)
 
@@ -61,7 +82,13 @@ SensorPublishAction = sensor_ns.class_('SensorPublishAction', automation.Action)
 
 # Filters
 Filter = sensor_ns.class_('Filter')
-SlidingWindowMovingAverageFilter = sensor_ns.class_('SlidingWindowMovingAverageFilter', Filter)
+SlidingWindowFilter = sensor_ns.class_('SlidingWindowFilter', Filter)
+SlidingWindowMovingAverageFilter = sensor_ns.class_('SlidingWindowMovingAverageFilter', SlidingWindowFilter)
+SortedSlidingWindowFilter = sensor_ns.class_('SortedSlidingWindowFilter', SlidingWindowFilter)
+MedianFilter = sensor_ns.class_('MedianFilter', SortedSlidingWindowFilter)
+QuantileFilter = sensor_ns.class_('QuantileFilter', SortedSlidingWindowFilter)
+MinFilter = sensor_ns.class_('MinFilter', SortedSlidingWindowFilter)
+MaxFilter = sensor_ns.class_('MaxFilter', SortedSlidingWindowFilter)
 ExponentialMovingAverageFilter = sensor_ns.class_('ExponentialMovingAverageFilter', Filter)
 LambdaFilter = sensor_ns.class_('LambdaFilter', Filter)
 OffsetFilter = sensor_ns.class_('OffsetFilter', Filter)
@@ -73,6 +100,14 @@ HeartbeatFilter = sensor_ns.class_('HeartbeatFilter', Filter, cg.Component)
 DeltaFilter = sensor_ns.class_('DeltaFilter', Filter)
 OrFilter = sensor_ns.class_('OrFilter', Filter)
 CalibrateLinearFilter = sensor_ns.class_('CalibrateLinearFilter', Filter)
+FusedFilter = sensor_ns.class_('FusedFilter', Filter)
+SensorHistory = sensor_ns.class_('SensorHistory')
+OffsetStage = sensor_ns.struct('OffsetStage')
+MultiplyStage = sensor_ns.struct('MultiplyStage')
+CalibrateLinearStage = sensor_ns.struct('CalibrateLinearStage')
+FilterOutValueStage = sensor_ns.struct('FilterOutValueStage')
+DeltaStage = sensor_ns.struct('DeltaStage')
+ThrottleStage = sensor_ns.struct('ThrottleStage')
 SensorInRangeCondition = sensor_ns.class_('SensorInRangeCondition', Filter)
 
 unit_of_measurement = cv.string_strict
@@ -88,6 +123,15 @@ SENSOR_SCHEMA = cv.MQTT_COMPONENT_SCHEMA.extend({
     cv.Optional(CONF_EXPIRE_AFTER): cv.All(cv.requires_component('mqtt'),
                                            cv.Any(None, cv.positive_time_period_milliseconds)),
     cv.Optional(CONF_FILTERS): validate_filters,
+    cv.Optional(CONF_HISTORY): cv.All(cv.Schema({
+        cv.GenerateID(): cv.declare_id(SensorHistory),
+        cv.Optional(CONF_RESOLUTION): cv.float_range(min=0, min_included=False),
+        cv.Optional(CONF_MIN_VALUE): cv.float_,
+        cv.Optional(CONF_MAX_VALUE): cv.float_,
+        cv.Optional(CONF_RAW, default=60): cv.int_range(min=0, max=4096),
+        cv.Optional(CONF_MINUTES, default=60): cv.int_range(min=0, max=4096),
+        cv.Optional(CONF_HOURS, default=24): cv.int_range(min=0, max=4096),
+    }), validate_history_range),
     cv.Optional(CONF_ON_VALUE): automation.validate_automation({
         cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(SensorStateTrigger),
     }),
@@ -140,6 +184,35 @@ def sliding_window_moving_average_filter_to_code(config, filter_id):
                            config[CONF_SEND_FIRST_AT])
 
 
+@FILTER_REGISTRY.register('median', MedianFilter, SLIDING_AVERAGE_SCHEMA)
+def median_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT])
+
+
+@FILTER_REGISTRY.register('quantile', QuantileFilter, cv.All(cv.Schema({
+    cv.Optional(CONF_WINDOW_SIZE, default=15): cv.positive_not_null_int,
+    cv.Optional(CONF_SEND_EVERY, default=15): cv.positive_not_null_int,
+    cv.Optional(CONF_SEND_FIRST_AT, default=1): cv.positive_not_null_int,
+    cv.Optional(CONF_QUANTILE, default=0.9): cv.zero_to_one_float,
+}), validate_send_first_at))
+def quantile_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT], config[CONF_QUANTILE])
+
+
+@FILTER_REGISTRY.register('min', MinFilter, SLIDING_AVERAGE_SCHEMA)
+def min_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT])
+
+
+@FILTER_REGISTRY.register('max', MaxFilter, SLIDING_AVERAGE_SCHEMA)
+def max_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT])
+
+
 @FILTER_REGISTRY.register('exponential_moving_average', ExponentialMovingAverageFilter, cv.Schema({
     cv.Optional(CONF_ALPHA, default=0.1): cv.positive_float,
     cv.Optional(CONF_SEND_EVERY, default=15): cv.positive_not_null_int,
@@ -162,7 +235,8 @@ def delta_filter_to_code(config, filter_id):
 
 @FILTER_REGISTRY.register('or', OrFilter, validate_filters)
 def or_filter_to_code(config, filter_id):
-    filters = yield build_filters(config)
+    # the children are parallel branches, not a chain, so they must not be fused
+    filters = yield cg.build_registry_list(FILTER_REGISTRY, config)
     yield cg.new_Pvariable(filter_id, filters)
 
 
@@ -188,15 +262,65 @@ def debounce_filter_to_code(config, filter_id):
 @FILTER_REGISTRY.register('calibrate_linear', CalibrateLinearFilter, cv.All(
     cv.ensure_list(validate_datapoint), cv.Length(min=2)))
 def calibrate_linear_filter_to_code(config, filter_id):
+    k, b = calibrate_linear_coefficients(config)
+    yield cg.new_Pvariable(filter_id, k, b)
+
+
+def calibrate_linear_coefficients(config):
     x = [conf[CONF_FROM] for conf in config]
     y = [conf[CONF_TO] for conf in config]
-    k, b = fit_linear(x, y)
-    yield cg.new_Pvariable(filter_id, k, b)
+    return fit_linear(x, y)
+
+
+# Filters that can run as a stage of a FusedFilter: name -> (stage type, function returning the stage's
+# constructor arguments from the filter's config)
+FUSABLE_FILTERS = {
+    'offset': (OffsetStage, lambda config: [config]),
+    'multiply': (MultiplyStage, lambda config: [config]),
+    'calibrate_linear': (CalibrateLinearStage, calibrate_linear_coefficients),
+    'filter_out': (FilterOutValueStage, lambda config: [config]),
+    'delta': (DeltaStage, lambda config: [config]),
+    'throttle': (ThrottleStage, lambda config: [config]),
+}
+
+
+@coroutine
+def build_fused_filter(run):
+    """Build a run of consecutive fusable filter configs as a single FusedFilter."""
+    if len(run) == 1:
+        filter_ = yield cg.build_registry_entry(FILTER_REGISTRY, run[0])
+        yield filter_
+        return
+    types, stages = [], []
+    for conf in run:
+        key, config = next((k, v) for k, v in conf.items() if k in FUSABLE_FILTERS)
+        type_, args = FUSABLE_FILTERS[key]
+        types.append(type_)
+        stages.append(type_(*args(config)))
+    # the fused filter takes the place of the first filter of the run
+    filter_id = run[0][CONF_TYPE_ID].copy()
+    filter_id.type = FusedFilter
+    yield cg.new_Pvariable(filter_id, cg.TemplateArguments(*types), *stages)
 
 
 @coroutine
 def build_filters(config):
-    yield cg.build_registry_list(FILTER_REGISTRY, config)
+    filters = []
+    run = []
+    for conf in config:
+        if any(k in FUSABLE_FILTERS for k in conf):
+            run.append(conf)
+            continue
+        if run:
+            filter_ = yield build_fused_filter(run)
+            filters.append(filter_)
+            run = []
+        filter_ = yield cg.build_registry_entry(FILTER_REGISTRY, conf)
+        filters.append(filter_)
+    if run:
+        filter_ = yield build_fused_filter(run)
+        filters.append(filter_)
+    yield filters
 
 
 @coroutine
@@ -213,6 +337,20 @@ def setup_sensor_core_(var, config):
     if CONF_FILTERS in config:
         filters = yield build_filters(config[CONF_FILTERS])
         cg.add(var.set_filters(filters))
+    if CONF_HISTORY in config:
+        conf = config[CONF_HISTORY]
+        # by default store values with the accuracy they're published with, as far as the range allows
+        resolution = 10.0 ** -config.get(CONF_ACCURACY_DECIMALS, 2)
+        if CONF_MIN_VALUE in conf:
+            span = conf[CONF_MAX_VALUE] - conf[CONF_MIN_VALUE]
+            resolution = max(resolution, span / 2.0 / HISTORY_MAX_STEPS)
+        resolution = conf.get(CONF_RESOLUTION, resolution)
+        history = cg.new_Pvariable(conf[CONF_ID], resolution, conf[CONF_RAW], conf[CONF_MINUTES],
+                                   conf[CONF_HOURS])
+        if CONF_MIN_VALUE in conf:
+            cg.add(history.set_base((conf[CONF_MIN_VALUE] + conf[CONF_MAX_VALUE]) / 2.0))
+        cg.add(var.set_history(history))
+        cg.add_define('USE_SENSOR_HISTORY')
 
     for conf in config.get(CONF_ON_VALUE, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
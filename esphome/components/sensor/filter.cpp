@@ -1,6 +1,7 @@
 #include "filter.h"
 #include "sensor.h"
 #include "esphome/core/log.h"
+#include <algorithm>
 
 namespace esphome {
 namespace sensor {
@@ -39,37 +40,246 @@ uint32_t Filter::calculate_remaining_interval(uint32_t input) {
   }
 }
 
-// SlidingWindowMovingAverageFilter
-SlidingWindowMovingAverageFilter::SlidingWindowMovingAverageFilter(size_t window_size, size_t send_every,
-                                                                   size_t send_first_at)
-    : send_every_(send_every), send_at_(send_every - send_first_at), window_size_(window_size) {}
-void SlidingWindowMovingAverageFilter::set_send_every(size_t send_every) { this->send_every_ = send_every; }
-void SlidingWindowMovingAverageFilter::set_window_size(size_t window_size) { this->window_size_ = window_size; }
-optional<float> SlidingWindowMovingAverageFilter::new_value(float value) {
+// SlidingWindowFilter
+SlidingWindowFilter::SlidingWindowFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : window_(new float[window_size]),
+      window_size_(window_size),
+      send_every_(send_every),
+      send_at_(send_every - send_first_at) {}
+void SlidingWindowFilter::set_send_every(size_t send_every) { this->send_every_ = send_every; }
+void SlidingWindowFilter::set_window_size(size_t window_size) {
+  this->window_.reset(new float[window_size]);
+  this->window_size_ = window_size;
+  this->head_ = 0;
+  this->count_ = 0;
+  this->clear_();
+}
+optional<float> SlidingWindowFilter::new_value(float value) {
   if (!isnan(value)) {
-    if (this->queue_.size() == this->window_size_) {
-      this->sum_ -= this->queue_.front();
-      this->queue_.pop();
+    if (this->count_ < this->window_size_) {
+      size_t tail = this->head_ + this->count_;
+      if (tail >= this->window_size_)
+        tail -= this->window_size_;
+      this->window_[tail] = value;
+      this->count_++;
+      this->insert_(value);
+    } else {
+      const float removed = this->window_[this->head_];
+      this->window_[this->head_] = value;
+      if (++this->head_ == this->window_size_)
+        this->head_ = 0;
+      this->replace_(removed, value);
     }
-    this->queue_.push(value);
-    this->sum_ += value;
   }
-  float average;
-  if (this->queue_.empty())
-    average = 0.0f;
-  else
-    average = this->sum_ / this->queue_.size();
-  ESP_LOGVV(TAG, "SlidingWindowMovingAverageFilter(%p)::new_value(%f) -> %f", this, value, average);
 
   if (++this->send_at_ >= this->send_every_) {
     this->send_at_ = 0;
-    ESP_LOGVV(TAG, "SlidingWindowMovingAverageFilter(%p)::new_value(%f) SENDING", this, value);
-    return average;
+    const float result = this->count_ == 0 ? NAN : this->compute_result_();
+    ESP_LOGVV(TAG, "SlidingWindowFilter(%p)::new_value(%f) SENDING %f", this, value, result);
+    return result;
   }
   return {};
 }
+uint32_t SlidingWindowFilter::expected_interval(uint32_t input) { return input * this->send_every_; }
+
+// SlidingWindowMovingAverageFilter
+SlidingWindowMovingAverageFilter::SlidingWindowMovingAverageFilter(size_t window_size, size_t send_every,
+                                                                   size_t send_first_at)
+    : SlidingWindowFilter(window_size, send_every, send_first_at) {}
+void SlidingWindowMovingAverageFilter::insert_(float value) { this->add_(value); }
+void SlidingWindowMovingAverageFilter::replace_(float removed, float value) {
+  this->add_(value);
+  this->add_(-removed);
+}
+void SlidingWindowMovingAverageFilter::clear_() {
+  this->sum_ = 0.0f;
+  this->compensation_ = 0.0f;
+}
+float SlidingWindowMovingAverageFilter::compute_result_() {
+  return (this->sum_ + this->compensation_) / this->count_;
+}
+void SlidingWindowMovingAverageFilter::add_(float value) {
+  const float sum = this->sum_ + value;
+  // recover what the addition rounded away from the smaller of the two operands
+  if (fabsf(this->sum_) >= fabsf(value))
+    this->compensation_ += (this->sum_ - sum) + value;
+  else
+    this->compensation_ += (value - sum) + this->sum_;
+  this->sum_ = sum;
+}
+
+// SortedSlidingWindowFilter
+SortedSlidingWindowFilter::SortedSlidingWindowFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SlidingWindowFilter(window_size, send_every, send_first_at) {
+  this->sorted_.reserve(window_size);
+}
+void SortedSlidingWindowFilter::insert_(float value) {
+  this->sorted_.insert(std::upper_bound(this->sorted_.begin(), this->sorted_.end(), value), value);
+}
+void SortedSlidingWindowFilter::replace_(float removed, float value) {
+  auto begin = this->sorted_.begin();
+  auto end = this->sorted_.end();
+  auto pos = std::lower_bound(begin, end, removed);
+  // shift the values between the position of the removed and the new value by one, towards the removed one
+  if (value > removed) {
+    auto target = std::upper_bound(pos, end, value);
+    std::move(pos + 1, target, pos);
+    *(target - 1) = value;
+  } else {
+    auto target = std::upper_bound(begin, pos, value);
+    std::move_backward(target, pos, pos + 1);
+    *target = value;
+  }
+}
+void SortedSlidingWindowFilter::clear_() {
+  this->sorted_.clear();
+  this->sorted_.reserve(this->window_size_);
+}
+
+// MedianFilter
+MedianFilter::MedianFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SortedSlidingWindowFilter(window_size, send_every, send_first_at) {}
+float MedianFilter::compute_result_() {
+  const size_t mid = this->count_ / 2;
+  if (this->count_ % 2 == 1)
+    return this->sorted_[mid];
+  return (this->sorted_[mid - 1] + this->sorted_[mid]) / 2.0f;
+}
+
+// QuantileFilter
+QuantileFilter::QuantileFilter(size_t window_size, size_t send_every, size_t send_first_at, float quantile)
+    : SortedSlidingWindowFilter(window_size, send_every, send_first_at), quantile_(quantile) {}
+void QuantileFilter::set_quantile(float quantile) { this->quantile_ = quantile; }
+float QuantileFilter::compute_result_() {
+  // nearest rank: the smallest value that at least quantile of the values are less than or equal to
+  const auto rank = static_cast<size_t>(ceilf(this->quantile_ * this->count_));
+  return this->sorted_[std::min(std::max(rank, size_t(1)), this->count_) - 1];
+}
+
+// MinFilter
+MinFilter::MinFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SortedSlidingWindowFilter(window_size, send_every, send_first_at) {}
+float MinFilter::compute_result_() { return this->sorted_.front(); }
+
+// MaxFilter
+MaxFilter::MaxFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SortedSlidingWindowFilter(window_size, send_every, send_first_at) {}
+float MaxFilter::compute_result_() { return this->sorted_.back(); }
+
+// MonotonicWindowQueue
+MonotonicWindowQueue::MonotonicWindowQueue(size_t capacity, bool maximum)
+    : positions_(new size_t[capacity]), capacity_(capacity), maximum_(maximum) {}
+void MonotonicWindowQueue::push(const float *window, size_t position) {
+  const float value = window[position];
+  // older values that are not better than the new one can never be the result again
+  while (this->size_ != 0) {
+    size_t back = this->front_ + this->size_ - 1;
+    if (back >= this->capacity_)
+      back -= this->capacity_;
+    const float candidate = window[this->positions_[back]];
+    if (this->maximum_ ? candidate > value : candidate < value)
+      break;
+    this->size_--;
+  }
+  size_t tail = this->front_ + this->size_;
+  if (tail >= this->capacity_)
+    tail -= this->capacity_;
+  this->positions_[tail] = position;
+  this->size_++;
+}
+void MonotonicWindowQueue::remove(size_t position) {
+  // the oldest value of the window is either the front or not a candidate anymore
+  if (this->size_ == 0 || this->positions_[this->front_] != position)
+    return;
+  if (++this->front_ == this->capacity_)
+    this->front_ = 0;
+  this->size_--;
+}
+void MonotonicWindowQueue::clear() {
+  this->front_ = 0;
+  this->size_ = 0;
+}
+void MonotonicWindowQueue::set_capacity(size_t capacity) {
+  this->positions_.reset(new size_t[capacity]);
+  this->capacity_ = capacity;
+  this->clear();
+}
 
-uint32_t SlidingWindowMovingAverageFilter::expected_interval(uint32_t input) { return input * this->send_every_; }
+// StatisticsFilter
+StatisticsFilter::StatisticsFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SlidingWindowFilter(window_size, send_every, send_first_at),
+      min_queue_(window_size, false),
+      max_queue_(window_size, true) {}
+void StatisticsFilter::set_window_size(size_t window_size) {
+  this->min_queue_.set_capacity(window_size);
+  this->max_queue_.set_capacity(window_size);
+  SlidingWindowFilter::set_window_size(window_size);
+}
+float StatisticsFilter::get_min() const {
+  return this->count_ == 0 ? NAN : this->window_[this->min_queue_.front()];
+}
+float StatisticsFilter::get_max() const {
+  return this->count_ == 0 ? NAN : this->window_[this->max_queue_.front()];
+}
+float StatisticsFilter::get_mean() const { return this->count_ == 0 ? NAN : float(this->mean_); }
+float StatisticsFilter::get_variance() const {
+  if (this->count_ < 2)
+    return NAN;
+  // the updates can round m2_ slightly below zero
+  return float(std::max(this->m2_, 0.0) / (this->count_ - 1));
+}
+void StatisticsFilter::insert_(float value) {
+  size_t position = this->head_ + this->count_ - 1;
+  if (position >= this->window_size_)
+    position -= this->window_size_;
+  this->min_queue_.push(this->window_.get(), position);
+  this->max_queue_.push(this->window_.get(), position);
+
+  const double delta = value - this->mean_;
+  this->mean_ += delta / this->count_;
+  this->m2_ += delta * (value - this->mean_);
+}
+void StatisticsFilter::replace_(float removed, float value) {
+  // the new value took the place of the removed one, which was at the head before it advanced
+  const size_t position = (this->head_ == 0 ? this->window_size_ : this->head_) - 1;
+  this->min_queue_.remove(position);
+  this->max_queue_.remove(position);
+  this->min_queue_.push(this->window_.get(), position);
+  this->max_queue_.push(this->window_.get(), position);
+
+  if (++this->replaced_ >= this->window_size_) {
+    this->recompute_moments_();
+    return;
+  }
+  // Welford's update for removing one value and adding another with the count unchanged
+  const double old_mean = this->mean_;
+  const double delta = double(value) - removed;
+  this->mean_ += delta / this->count_;
+  this->m2_ += delta * (value - this->mean_ + removed - old_mean);
+}
+void StatisticsFilter::clear_() {
+  this->min_queue_.clear();
+  this->max_queue_.clear();
+  this->mean_ = 0.0;
+  this->m2_ = 0.0;
+  this->replaced_ = 0;
+}
+float StatisticsFilter::compute_result_() { return float(this->mean_); }
+void StatisticsFilter::recompute_moments_() {
+  // once per window_size replaced values, so still O(1) amortized
+  this->replaced_ = 0;
+  double sum = 0.0;
+  for (size_t i = 0; i < this->count_; i++)
+    sum += this->window_[i];
+  const double mean = sum / this->count_;
+  double m2 = 0.0;
+  for (size_t i = 0; i < this->count_; i++) {
+    const double delta = this->window_[i] - mean;
+    m2 += delta * delta;
+  }
+  this->mean_ = mean;
+  this->m2_ = m2;
+}
 
 // ExponentialMovingAverageFilter
 ExponentialMovingAverageFilter::ExponentialMovingAverageFilter(float alpha, size_t send_every)
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <queue>
+#include <memory>
+#include <tuple>
+#include <vector>
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 
@@ -46,36 +48,200 @@ class Filter {
   Sensor *parent_{nullptr};
 };
 
-/** Simple sliding window moving average filter.
+/** Base class for filters whose output is computed from the last window_size values.
  *
- * Essentially just takes takes the average of the last window_size values and pushes them out
- * every send_every.
+ * The window is a ring buffer that is allocated once, NaN values are not added to it. Subclasses keep
+ * whatever state they need to compute their result up to date in insert_() and replace_(), so that
+ * compute_result_() doesn't have to go through the whole window. A result is pushed out every send_every values,
+ * NaN while the window is still empty.
  */
-class SlidingWindowMovingAverageFilter : public Filter {
+class SlidingWindowFilter : public Filter {
  public:
-  /** Construct a SlidingWindowMovingAverageFilter.
+  /** Construct a SlidingWindowFilter.
    *
-   * @param window_size The number of values that should be averaged.
+   * @param window_size The number of values that the result is computed from.
    * @param send_every After how many sensor values should a new one be pushed out.
    * @param send_first_at After how many values to forward the very first value. Defaults to the first value
    *   on startup being published on the first *raw* value, so with no filter applied. Must be less than or equal to
    *   send_every.
    */
-  explicit SlidingWindowMovingAverageFilter(size_t window_size, size_t send_every, size_t send_first_at);
+  SlidingWindowFilter(size_t window_size, size_t send_every, size_t send_first_at);
 
   optional<float> new_value(float value) override;
 
   void set_send_every(size_t send_every);
+  /// Change the window size, this discards the values that are currently in the window.
   void set_window_size(size_t window_size);
 
   uint32_t expected_interval(uint32_t input) override;
 
  protected:
-  float sum_{0.0};
-  std::queue<float> queue_;
+  /// Called when value was added to a window that wasn't full yet.
+  virtual void insert_(float value) = 0;
+  /// Called when value took the place of the oldest value of a full window.
+  virtual void replace_(float removed, float value) = 0;
+  /// Called when the window was emptied.
+  virtual void clear_() = 0;
+  /// The result for the values currently in the window, only called if there's at least one.
+  virtual float compute_result_() = 0;
+
+  std::unique_ptr<float[]> window_;
+  size_t window_size_;
+  /// The position of the oldest value in the window.
+  size_t head_{0};
+  size_t count_{0};
   size_t send_every_;
   size_t send_at_;
-  size_t window_size_;
+};
+
+/** Simple sliding window moving average filter.
+ *
+ * Essentially just takes takes the average of the last window_size values and pushes them out
+ * every send_every. The sum is kept with compensated (Kahan-Babuska) summation so that it doesn't drift
+ * away from the values in the window over a long uptime.
+ */
+class SlidingWindowMovingAverageFilter : public SlidingWindowFilter {
+ public:
+  SlidingWindowMovingAverageFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  void insert_(float value) override;
+  void replace_(float removed, float value) override;
+  void clear_() override;
+  float compute_result_() override;
+
+  void add_(float value);
+
+  float sum_{0.0f};
+  /// The low-order bits that got lost in sum_.
+  float compensation_{0.0f};
+};
+
+/** Base class for filters that need the values of the window in sorted order.
+ *
+ * The sorted copy is a contiguous array: a new value is placed with a binary search, and only the values
+ * between the removed and the added one are moved. For windows of a few hundred values this is faster
+ * than a tree or skip list with a node allocation and pointer chasing per value.
+ */
+class SortedSlidingWindowFilter : public SlidingWindowFilter {
+ public:
+  SortedSlidingWindowFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  void insert_(float value) override;
+  void replace_(float removed, float value) override;
+  void clear_() override;
+
+  std::vector<float> sorted_;
+};
+
+/// Sliding window filter that pushes out the median of the last window_size values.
+class MedianFilter : public SortedSlidingWindowFilter {
+ public:
+  MedianFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  float compute_result_() override;
+};
+
+/** Sliding window filter that pushes out the given quantile of the last window_size values.
+ *
+ * Uses the nearest-rank method, so the result is always one of the values in the window.
+ */
+class QuantileFilter : public SortedSlidingWindowFilter {
+ public:
+  /// @param quantile The quantile from 0 to 1, for example 0.9 for the 90th percentile.
+  QuantileFilter(size_t window_size, size_t send_every, size_t send_first_at, float quantile);
+
+  void set_quantile(float quantile);
+
+ protected:
+  float compute_result_() override;
+
+  float quantile_;
+};
+
+/// Sliding window filter that pushes out the minimum of the last window_size values.
+class MinFilter : public SortedSlidingWindowFilter {
+ public:
+  MinFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  float compute_result_() override;
+};
+
+/// Sliding window filter that pushes out the maximum of the last window_size values.
+class MaxFilter : public SortedSlidingWindowFilter {
+ public:
+  MaxFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  float compute_result_() override;
+};
+
+/** The window positions of the candidates for the minimum (or maximum) of a sliding window.
+ *
+ * The values at the positions are increasing (decreasing for the maximum) from front to back, so the front is the
+ * result. Every position is added and removed at most once, which makes an update O(1) amortized.
+ */
+class MonotonicWindowQueue {
+ public:
+  MonotonicWindowQueue(size_t capacity, bool maximum);
+
+  /// Add the position of a new value, dropping the candidates it makes obsolete.
+  void push(const float *window, size_t position);
+  /// Drop position if it's still a candidate, called when its value leaves the window.
+  void remove(size_t position);
+  void clear();
+  /// The position of the minimum (maximum), the queue must not be empty.
+  size_t front() const { return this->positions_[this->front_]; }
+  void set_capacity(size_t capacity);
+
+ protected:
+  std::unique_ptr<size_t[]> positions_;
+  size_t capacity_;
+  size_t front_{0};
+  size_t size_{0};
+  bool maximum_;
+};
+
+/** Sliding window filter that keeps minimum, maximum, mean, variance and count of the window up to date.
+ *
+ * Minimum and maximum come from monotonic queues of window positions, mean and variance from Welford's
+ * algorithm extended to remove the value that leaves the window. Both take O(1) amortized per value, so
+ * all statistics can be read after every value. The pushed out result is the mean.
+ */
+class StatisticsFilter : public SlidingWindowFilter {
+ public:
+  StatisticsFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+  void set_window_size(size_t window_size);
+
+  /// The statistics of the values currently in the window, NaN while it's empty.
+  float get_min() const;
+  float get_max() const;
+  float get_mean() const;
+  /// The sample variance, NaN for less than two values.
+  float get_variance() const;
+  size_t get_count() const { return this->count_; }
+
+ protected:
+  void insert_(float value) override;
+  void replace_(float removed, float value) override;
+  void clear_() override;
+  float compute_result_() override;
+
+  /// Compute mean_ and m2_ from the window again, this removes the rounding errors of the updates.
+  void recompute_moments_();
+
+  MonotonicWindowQueue min_queue_;
+  MonotonicWindowQueue max_queue_;
+  // double, because the variance of values that are close together is the small difference of large sums
+  double mean_{0.0};
+  /// Sum of the squared differences from the mean.
+  double m2_{0.0};
+  /// Values replaced since the last recompute_moments_().
+  size_t replaced_{0};
 };
 
 /** Simple exponential moving average filter.
@@ -243,5 +409,103 @@ class CalibrateLinearFilter : public Filter {
   float bias_;
 };
 
+/** Stages of a FusedFilter.
+ *
+ * Each stage does the same as the filter of the same name, but without a virtual call, an optional
+ * and a hop to the next filter per value. apply() modifies the value in place and returns false if
+ * the value should not be passed on.
+ */
+struct OffsetStage {
+  explicit OffsetStage(float offset) : offset(offset) {}
+  bool apply(float &value) {
+    value += this->offset;
+    return true;
+  }
+  float offset;
+};
+
+struct MultiplyStage {
+  explicit MultiplyStage(float multiplier) : multiplier(multiplier) {}
+  bool apply(float &value) {
+    value *= this->multiplier;
+    return true;
+  }
+  float multiplier;
+};
+
+struct CalibrateLinearStage {
+  CalibrateLinearStage(float slope, float bias) : slope(slope), bias(bias) {}
+  bool apply(float &value) {
+    value = value * this->slope + this->bias;
+    return true;
+  }
+  float slope;
+  float bias;
+};
+
+struct FilterOutValueStage {
+  explicit FilterOutValueStage(float value_to_filter_out) : value_to_filter_out(value_to_filter_out) {}
+  bool apply(float &value) {
+    if (isnan(this->value_to_filter_out))
+      return !isnan(value);
+    return value != this->value_to_filter_out;
+  }
+  float value_to_filter_out;
+};
+
+struct DeltaStage {
+  explicit DeltaStage(float min_delta) : min_delta(min_delta) {}
+  bool apply(float &value) {
+    if (isnan(value))
+      return false;
+    if (!isnan(this->last_value) && fabsf(value - this->last_value) < this->min_delta)
+      return false;
+    this->last_value = value;
+    return true;
+  }
+  float min_delta;
+  float last_value{NAN};
+};
+
+struct ThrottleStage {
+  explicit ThrottleStage(uint32_t min_time_between_inputs) : min_time_between_inputs(min_time_between_inputs) {}
+  bool apply(float &value) {
+    const uint32_t now = millis();
+    if (this->last_input != 0 && now - this->last_input < this->min_time_between_inputs)
+      return false;
+    this->last_input = now;
+    return true;
+  }
+  uint32_t min_time_between_inputs;
+  uint32_t last_input{0};
+};
+
+/** A run of stateless or simple filters fused into a single filter.
+ *
+ * Code generation replaces consecutive offset, multiply, calibrate_linear, filter_out, delta and throttle
+ * filters with one FusedFilter, so a value goes through all of them in one inlined call instead of one
+ * heap-allocated filter each. Other filters, like lambdas, stay separate links of the chain.
+ */
+template<typename... Stages> class FusedFilter : public Filter {
+ public:
+  explicit FusedFilter(Stages... stages) : stages_(stages...) {}
+
+  optional<float> new_value(float value) override {
+    if (!this->apply_<0>(value))
+      return {};
+    return value;
+  }
+
+ protected:
+  template<size_t I> typename std::enable_if<I == sizeof...(Stages), bool>::type apply_(float &value) {
+    return true;
+  }
+  template<size_t I> typename std::enable_if<(I < sizeof...(Stages)), bool>::type apply_(float &value) {
+    return std::get<I>(this->stages_).apply(value) && this->apply_<I + 1>(value);
+  }
+
+  std::tuple<Stages...> stages_;
+};
+
 }  // namespace sensor
 }  // namespace esphome
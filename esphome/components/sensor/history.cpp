@@ -0,0 +1,94 @@
+#include "history.h"
+#include "esphome/core/esphal.h"
+#include "esphome/core/log.h"
+#include <algorithm>
+#include <cmath>
+
+namespace esphome {
+namespace sensor {
+
+static const char *TAG = "sensor.history";
+
+SensorHistory::SensorHistory(float resolution, size_t raw_size, size_t minutes, size_t hours)
+    : resolution_(resolution) {
+  this->raw_.init(raw_size);
+  this->minutes_.period = 60;
+  this->minutes_.ring.init(minutes);
+  this->hours_.period = 3600;
+  this->hours_.ring.init(hours);
+}
+uint32_t SensorHistory::uptime() {
+  static uint32_t last_millis = 0;
+  static uint32_t overflows = 0;
+  const uint32_t now = millis();
+  if (now < last_millis)
+    overflows++;
+  last_millis = now;
+  // 2^32 ms are 4294967.296 s
+  return now / 1000 + overflows * 4294967UL + (overflows * 296UL + now % 1000) / 1000;
+}
+size_t SensorHistory::get_memory_usage() const {
+  return this->raw_.capacity() * sizeof(HistoryRawPoint) +
+         (this->minutes_.ring.capacity() + this->hours_.ring.capacity()) * sizeof(HistoryAggregate);
+}
+int16_t SensorHistory::encode_(float value) {
+  const float steps = roundf((value - this->base_) / this->resolution_);
+  // INT16_MIN is reserved for HISTORY_NO_VALUE
+  if (steps > INT16_MAX || steps < INT16_MIN + 1) {
+    if (!this->clamped_) {
+      ESP_LOGW(TAG, "Value %f is outside of the history range %f to %f and is clamped, configure its range!", value,
+               this->base_ - INT16_MAX * this->resolution_, this->base_ + INT16_MAX * this->resolution_);
+      this->clamped_ = true;
+    }
+    return steps > 0 ? INT16_MAX : INT16_MIN + 1;
+  }
+  return int16_t(steps);
+}
+void SensorHistory::add(float value) {
+  if (isnan(value))
+    return;
+  if (isnan(this->base_))
+    this->base_ = value;
+  const uint32_t now = uptime();
+
+  if (this->raw_.capacity() != 0) {
+    const bool first = this->raw_.end_seq() == 0;
+    const uint32_t delta = first ? 0 : std::min(now - this->raw_newest_time_, uint32_t(UINT16_MAX));
+    this->raw_.push(HistoryRawPoint{.delta = uint16_t(delta), .value = this->encode_(value)});
+    this->raw_newest_time_ = now;
+  }
+  this->add_to_tier_(this->minutes_, now, value);
+  this->add_to_tier_(this->hours_, now, value);
+}
+void SensorHistory::add_to_tier_(HistoryTier &tier, uint32_t now, float value) {
+  if (tier.ring.capacity() == 0)
+    return;
+  const uint32_t period = now / tier.period;
+  if (period != tier.current) {
+    if (tier.count != 0) {
+      tier.ring.push(HistoryAggregate{
+          .min = this->encode_(tier.min), .avg = this->encode_(tier.sum / tier.count), .max = this->encode_(tier.max)});
+    } else {
+      tier.ring.push(HistoryAggregate{.min = HISTORY_NO_VALUE, .avg = HISTORY_NO_VALUE, .max = HISTORY_NO_VALUE});
+    }
+    // the periods in between had no values, there's no point in filling more than the whole ring with them
+    const uint32_t skipped = std::min(period - tier.current - 1, uint32_t(tier.ring.capacity()));
+    for (uint32_t i = 0; i < skipped; i++)
+      tier.ring.push(HistoryAggregate{.min = HISTORY_NO_VALUE, .avg = HISTORY_NO_VALUE, .max = HISTORY_NO_VALUE});
+    tier.current = period;
+    tier.count = 0;
+    tier.sum = 0.0f;
+  }
+  if (tier.count == 0) {
+    tier.min = value;
+    tier.max = value;
+  } else {
+    tier.min = std::min(tier.min, value);
+    tier.max = std::max(tier.max, value);
+  }
+  tier.sum += value;
+  tier.count++;
+}
+
+}  // namespace sensor
+}  // namespace esphome
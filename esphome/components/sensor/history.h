@@ -0,0 +1,119 @@
+#pragma once
+
+#include "esphome/core/helpers.h"
+#include <memory>
+
+namespace esphome {
+namespace sensor {
+
+/// Fixed-point value that marks a period without any values in an aggregate tier.
+static const int16_t HISTORY_NO_VALUE = INT16_MIN;
+
+/// A value of the raw tier, delta is the number of seconds since the previous (older) value.
+struct HistoryRawPoint {
+  uint16_t delta;
+  int16_t value;
+};
+
+/// A period of an aggregate tier, all HISTORY_NO_VALUE if the sensor had no values in it.
+struct HistoryAggregate {
+  int16_t min;
+  int16_t avg;
+  int16_t max;
+};
+
+/** Ring buffer that keeps the last capacity entries.
+ *
+ * Entries are addressed by sequence number, which counts every push() since the start. That keeps the
+ * position of a reader stable while new entries arrive and old ones are overwritten.
+ */
+template<typename T> class HistoryRing {
+ public:
+  void init(size_t capacity) {
+    this->buffer_.reset(new T[capacity]);
+    this->capacity_ = capacity;
+  }
+  void push(const T &entry) {
+    this->buffer_[this->pushed_ % this->capacity_] = entry;
+    this->pushed_++;
+  }
+  size_t capacity() const { return this->capacity_; }
+  /// The sequence number of the next push(), one past the newest entry.
+  uint32_t end_seq() const { return this->pushed_; }
+  /// The sequence number of the oldest entry that is still stored.
+  uint32_t begin_seq() const { return this->pushed_ > this->capacity_ ? this->pushed_ - this->capacity_ : 0; }
+  /// The entry with sequence number seq, which must be in [begin_seq(), end_seq()).
+  const T &at(uint32_t seq) const { return this->buffer_[seq % this->capacity_]; }
+
+ protected:
+  std::unique_ptr<T[]> buffer_;
+  size_t capacity_{0};
+  uint32_t pushed_{0};
+};
+
+/// A tier of per-period min/avg/max values.
+struct HistoryTier {
+  /// Length of a period in seconds.
+  uint32_t period;
+  HistoryRing<HistoryAggregate> ring;
+  /// The number (uptime / period) of the period that is being accumulated, the ring ends at its start.
+  uint32_t current{0};
+  float min{NAN};
+  float max{NAN};
+  float sum{0.0f};
+  uint32_t count{0};
+};
+
+/** In-RAM history of a sensor's states in three tiers: raw values, per-minute and per-hour aggregates.
+ *
+ * All memory is allocated once in the constructor. Values are stored as 16 bit fixed-point numbers,
+ * value = base + n * resolution, with base being the middle of the configured range or else the first value
+ * that was added; values that are further than 32767 steps away from the base are clamped. Times are seconds of
+ * uptime.
+ */
+class SensorHistory {
+ public:
+  /**
+   * @param resolution The step of the fixed-point values, usually 10^-accuracy_decimals.
+   * @param raw_size The number of raw values that are kept.
+   * @param minutes The number of per-minute aggregates that are kept.
+   * @param hours The number of per-hour aggregates that are kept.
+   */
+  SensorHistory(float resolution, size_t raw_size, size_t minutes, size_t hours);
+
+  /// Center the fixed-point values on base instead of the first value.
+  void set_base(float base) { this->base_ = base; }
+
+  /// Record a state, NaN is ignored.
+  void add(float value);
+
+  float get_resolution() const { return this->resolution_; }
+  float get_base() const { return this->base_; }
+  /// Bytes used by the stored values.
+  size_t get_memory_usage() const;
+
+  const HistoryRing<HistoryRawPoint> &get_raw() const { return this->raw_; }
+  /// Uptime in seconds of the newest raw value.
+  uint32_t get_raw_newest_time() const { return this->raw_newest_time_; }
+  const HistoryTier &get_minutes() const { return this->minutes_; }
+  const HistoryTier &get_hours() const { return this->hours_; }
+
+  /// Seconds since boot, doesn't overflow with millis().
+  static uint32_t uptime();
+
+ protected:
+  int16_t encode_(float value);
+  void add_to_tier_(HistoryTier &tier, uint32_t now, float value);
+
+  float resolution_;
+  float base_{NAN};
+  /// A value was clamped, only the first one is logged.
+  bool clamped_{false};
+  HistoryRing<HistoryRawPoint> raw_;
+  uint32_t raw_newest_time_{0};
+  HistoryTier minutes_;
+  HistoryTier hours_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -90,6 +90,10 @@ void Sensor::internal_send_state_to_frontend(float state) {
   this->state = state;
   ESP_LOGD(TAG, "'%s': Sending state %.5f %s with %d decimals of accuracy", this->get_name().c_str(), state,
            this->get_unit_of_measurement().c_str(), this->get_accuracy_decimals());
+#ifdef USE_SENSOR_HISTORY
+  if (this->history_ != nullptr)
+    this->history_->add(state);
+#endif
   this->callback_.call(state);
 }
 bool Sensor::has_state() const { return this->has_state_; }
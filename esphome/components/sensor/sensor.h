@@ -1,9 +1,14 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
 #include "esphome/core/helpers.h"
 #include "esphome/components/sensor/filter.h"
 
+#ifdef USE_SENSOR_HISTORY
+#include "esphome/components/sensor/history.h"
+#endif
+
 namespace esphome {
 namespace sensor {
 
@@ -70,6 +75,13 @@ class Sensor : public Nameable {
   /// Clear the entire filter chain.
   void clear_filters();
 
+#ifdef USE_SENSOR_HISTORY
+  /// Record the states of this sensor in history.
+  void set_history(SensorHistory *history) { this->history_ = history; }
+  /// The recorded states, nullptr if this sensor doesn't keep a history.
+  SensorHistory *get_history() const { return this->history_; }
+#endif
+
   /// Getter-syntax for .value. Please use .state instead.
   float get_value() const ESPDEPRECATED(".value is deprecated, please use .state");
   /// Getter-syntax for .state.
@@ -174,6 +186,9 @@ class Sensor : public Nameable {
   optional<int8_t> accuracy_decimals_;
   Filter *filter_list_{nullptr};  ///< Store all active filters.
   bool has_state_{false};
+#ifdef USE_SENSOR_HISTORY
+  SensorHistory *history_{nullptr};
+#endif
 };
 
 class PollingSensorComponent : public PollingComponent, public Sensor {
@@ -0,0 +1,50 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import CONF_ID, CONF_SEND_EVERY, CONF_SEND_FIRST_AT, CONF_SENSOR, \
+    CONF_WINDOW_SIZE, ICON_EMPTY, UNIT_EMPTY
+
+statistics_ns = cg.esphome_ns.namespace('statistics')
+StatisticsComponent = statistics_ns.class_('StatisticsComponent', cg.Component)
+StatisticsSensor = statistics_ns.class_('StatisticsSensor', sensor.Sensor)
+
+CONF_MIN = 'min'
+CONF_MAX = 'max'
+CONF_MEAN = 'mean'
+CONF_VARIANCE = 'variance'
+CONF_STANDARD_DEVIATION = 'standard_deviation'
+CONF_COUNT = 'count'
+TYPES = [CONF_MIN, CONF_MAX, CONF_MEAN, CONF_VARIANCE, CONF_STANDARD_DEVIATION, CONF_COUNT]
+
+# unit, icon and accuracy default to the ones of the source sensor
+STATISTICS_SENSOR_SCHEMA = sensor.SENSOR_SCHEMA.extend({
+    cv.GenerateID(): cv.declare_id(StatisticsSensor),
+})
+
+CONFIG_SCHEMA = cv.All(cv.Schema({
+    cv.GenerateID(): cv.declare_id(StatisticsComponent),
+    cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+    cv.Optional(CONF_WINDOW_SIZE, default=15): cv.positive_not_null_int,
+    cv.Optional(CONF_SEND_EVERY, default=15): cv.positive_not_null_int,
+    cv.Optional(CONF_SEND_FIRST_AT, default=1): cv.positive_not_null_int,
+    cv.Optional(CONF_MIN): STATISTICS_SENSOR_SCHEMA,
+    cv.Optional(CONF_MAX): STATISTICS_SENSOR_SCHEMA,
+    cv.Optional(CONF_MEAN): STATISTICS_SENSOR_SCHEMA,
+    cv.Optional(CONF_VARIANCE): STATISTICS_SENSOR_SCHEMA,
+    cv.Optional(CONF_STANDARD_DEVIATION): STATISTICS_SENSOR_SCHEMA,
+    cv.Optional(CONF_COUNT): sensor.sensor_schema(UNIT_EMPTY, ICON_EMPTY, 0),
+}).extend(cv.COMPONENT_SCHEMA), sensor.validate_send_first_at, cv.has_at_least_one_key(*TYPES))
+
+
+def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID], config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT])
+    yield cg.register_component(var, config)
+
+    source = yield cg.get_variable(config[CONF_SENSOR])
+    cg.add(var.set_source(source))
+    for key in TYPES:
+        if key not in config:
+            continue
+        sens = yield sensor.new_sensor(config[key])
+        cg.add(getattr(var, 'set_{}_sensor'.format(key))(sens))
@@ -0,0 +1,72 @@
+#include "statistics_sensor.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace statistics {
+
+static const char *TAG = "statistics";
+
+// StatisticsSensor
+void StatisticsSensor::set_source(sensor::Sensor *source, bool squared) {
+  this->source_ = source;
+  this->squared_ = squared;
+}
+std::string StatisticsSensor::unit_of_measurement() {
+  if (this->source_ == nullptr)
+    return "";
+  std::string unit = this->source_->get_unit_of_measurement();
+  if (this->squared_ && !unit.empty())
+    unit += "²";
+  return unit;
+}
+std::string StatisticsSensor::icon() { return this->source_ == nullptr ? "" : this->source_->get_icon(); }
+int8_t StatisticsSensor::accuracy_decimals() {
+  if (this->source_ == nullptr)
+    return 0;
+  const int8_t decimals = this->source_->get_accuracy_decimals();
+  return this->squared_ ? decimals * 2 : decimals;
+}
+
+// StatisticsComponent
+StatisticsComponent::StatisticsComponent(size_t window_size, size_t send_every, size_t send_first_at)
+    : filter_(window_size, send_every, send_first_at) {}
+void StatisticsComponent::setup() {
+  for (StatisticsSensor *sens : {this->min_sensor_, this->max_sensor_, this->mean_sensor_,
+                                 this->standard_deviation_sensor_}) {
+    if (sens != nullptr)
+      sens->set_source(this->source_, false);
+  }
+  if (this->variance_sensor_ != nullptr)
+    this->variance_sensor_->set_source(this->source_, true);
+
+  this->source_->add_on_state_callback([this](float value) { this->process_value_(value); });
+}
+void StatisticsComponent::dump_config() {
+  ESP_LOGCONFIG(TAG, "Statistics of '%s':", this->source_->get_name().c_str());
+  LOG_SENSOR("  ", "Min", this->min_sensor_);
+  LOG_SENSOR("  ", "Max", this->max_sensor_);
+  LOG_SENSOR("  ", "Mean", this->mean_sensor_);
+  LOG_SENSOR("  ", "Variance", this->variance_sensor_);
+  LOG_SENSOR("  ", "Standard Deviation", this->standard_deviation_sensor_);
+  LOG_SENSOR("  ", "Count", this->count_sensor_);
+}
+void StatisticsComponent::process_value_(float value) {
+  if (!this->filter_.new_value(value).has_value())
+    return;
+
+  if (this->min_sensor_ != nullptr)
+    this->min_sensor_->publish_state(this->filter_.get_min());
+  if (this->max_sensor_ != nullptr)
+    this->max_sensor_->publish_state(this->filter_.get_max());
+  if (this->mean_sensor_ != nullptr)
+    this->mean_sensor_->publish_state(this->filter_.get_mean());
+  if (this->variance_sensor_ != nullptr)
+    this->variance_sensor_->publish_state(this->filter_.get_variance());
+  if (this->standard_deviation_sensor_ != nullptr)
+    this->standard_deviation_sensor_->publish_state(sqrtf(this->filter_.get_variance()));
+  if (this->count_sensor_ != nullptr)
+    this->count_sensor_->publish_state(this->filter_.get_count());
+}
+
+}  // namespace statistics
+}  // namespace esphome
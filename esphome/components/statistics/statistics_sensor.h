@@ -0,0 +1,62 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/sensor/filter.h"
+
+namespace esphome {
+namespace statistics {
+
+/// An output of StatisticsComponent, its unit, icon and accuracy default to the ones of the source sensor.
+class StatisticsSensor : public sensor::Sensor {
+ public:
+  /// @param squared Whether the values are in the square of the source's unit, like the variance.
+  void set_source(sensor::Sensor *source, bool squared);
+
+ protected:
+  std::string unit_of_measurement() override;
+  std::string icon() override;
+  int8_t accuracy_decimals() override;
+
+  sensor::Sensor *source_{nullptr};
+  bool squared_{false};
+};
+
+/** Windowed statistics of another sensor.
+ *
+ * All outputs share the window of a single StatisticsFilter, which keeps every statistic up to date in O(1)
+ * amortized per value. They are published together every send_every values of the source.
+ */
+class StatisticsComponent : public Component {
+ public:
+  StatisticsComponent(size_t window_size, size_t send_every, size_t send_first_at);
+
+  void set_source(sensor::Sensor *source) { this->source_ = source; }
+  void set_min_sensor(StatisticsSensor *min_sensor) { this->min_sensor_ = min_sensor; }
+  void set_max_sensor(StatisticsSensor *max_sensor) { this->max_sensor_ = max_sensor; }
+  void set_mean_sensor(StatisticsSensor *mean_sensor) { this->mean_sensor_ = mean_sensor; }
+  void set_variance_sensor(StatisticsSensor *variance_sensor) { this->variance_sensor_ = variance_sensor; }
+  void set_standard_deviation_sensor(StatisticsSensor *standard_deviation_sensor) {
+    this->standard_deviation_sensor_ = standard_deviation_sensor;
+  }
+  void set_count_sensor(sensor::Sensor *count_sensor) { this->count_sensor_ = count_sensor; }
+
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+ protected:
+  void process_value_(float value);
+
+  sensor::StatisticsFilter filter_;
+  sensor::Sensor *source_;
+  StatisticsSensor *min_sensor_{nullptr};
+  StatisticsSensor *max_sensor_{nullptr};
+  StatisticsSensor *mean_sensor_{nullptr};
+  StatisticsSensor *variance_sensor_{nullptr};
+  StatisticsSensor *standard_deviation_sensor_{nullptr};
+  sensor::Sensor *count_sensor_{nullptr};
+};
+
+}  // namespace statistics
+}  // namespace esphome
@@ -0,0 +1,70 @@
+#include "block_kernels.h"
+#include <cmath>
+
+namespace esphome {
+namespace voltage_sampler {
+
+float block_mean(const float *samples, size_t count) {
+  if (count == 0)
+    return 0.0f;
+  float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sum0 += samples[i];
+    sum1 += samples[i + 1];
+    sum2 += samples[i + 2];
+    sum3 += samples[i + 3];
+  }
+  for (; i < count; i++)
+    sum0 += samples[i];
+  return ((sum0 + sum1) + (sum2 + sum3)) / count;
+}
+
+float block_sum_of_squares(const float *samples, size_t count, float offset) {
+  float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float d0 = samples[i] - offset;
+    const float d1 = samples[i + 1] - offset;
+    const float d2 = samples[i + 2] - offset;
+    const float d3 = samples[i + 3] - offset;
+    sum0 += d0 * d0;
+    sum1 += d1 * d1;
+    sum2 += d2 * d2;
+    sum3 += d3 * d3;
+  }
+  for (; i < count; i++) {
+    const float d = samples[i] - offset;
+    sum0 += d * d;
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+float block_rms(const float *samples, size_t count, float offset) {
+  if (count == 0)
+    return 0.0f;
+  return sqrtf(block_sum_of_squares(samples, count, offset) / count);
+}
+
+void block_remove_dc(float *samples, size_t count, float offset) {
+  for (size_t i = 0; i < count; i++)
+    samples[i] -= offset;
+}
+
+void block_peak(const float *samples, size_t count, float *min, float *max) {
+  if (count == 0)
+    return;
+  float lo = samples[0], hi = samples[0];
+  for (size_t i = 1; i < count; i++) {
+    const float value = samples[i];
+    if (value < lo)
+      lo = value;
+    if (value > hi)
+      hi = value;
+  }
+  *min = lo;
+  *max = hi;
+}
+
+}  // namespace voltage_sampler
+}  // namespace esphome
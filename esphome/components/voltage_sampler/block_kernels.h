@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace esphome {
+namespace voltage_sampler {
+
+/** Kernels for processing blocks of samples, shared by the components that consume sample blocks.
+ *
+ * The loops are unrolled with independent accumulators so that the FPU pipeline stays busy instead of waiting
+ * for the previous addition of a single running sum.
+ */
+
+/// The arithmetic mean of the samples, 0 for an empty block.
+float block_mean(const float *samples, size_t count);
+
+/// The sum of (sample - offset)², pass the mean as offset to get the squared deviation from the DC level.
+float block_sum_of_squares(const float *samples, size_t count, float offset);
+
+/// The RMS of the samples around offset, 0 for an empty block.
+float block_rms(const float *samples, size_t count, float offset);
+
+/// Subtract offset from every sample in place.
+void block_remove_dc(float *samples, size_t count, float offset);
+
+/// Find the smallest and the largest sample, both are left untouched for an empty block.
+void block_peak(const float *samples, size_t count, float *min, float *max);
+
+}  // namespace voltage_sampler
+}  // namespace esphome
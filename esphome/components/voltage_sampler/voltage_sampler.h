@@ -1,15 +1,26 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include <functional>
 
 namespace esphome {
 namespace voltage_sampler {
 
+/// Callback for a block of consecutive voltage samples, in V. The samples are only valid during the call.
+using sample_block_callback_t = std::function<void(const float *samples, size_t count)>;
+
 /// Abstract interface for components to request voltage (usually ADC readings)
 class VoltageSampler {
  public:
   /// Get a voltage reading, in V.
   virtual float sample() = 0;
+
+  /** Receive the samples of a continuously sampling source in blocks.
+   *
+   * @return false if this source doesn't sample continuously. The consumer then has to call sample() itself and
+   *   callback is never called.
+   */
+  virtual bool add_on_sample_block_callback(sample_block_callback_t &&callback) { return false; }
 };
 
 }  // namespace voltage_sampler
@@ -1,25 +1,82 @@
+import gzip
+import hashlib
+import io
+import json
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import web_server_base
 from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
 from esphome.const import CONF_CSS_URL, CONF_ID, CONF_JS_URL, CONF_PORT
-from esphome.core import coroutine_with_priority
+from esphome.core import CORE, HexInt, coroutine_with_priority
 
 AUTO_LOAD = ['json', 'web_server_base']
 
 web_server_ns = cg.esphome_ns.namespace('web_server')
 WebServer = web_server_ns.class_('WebServer', cg.Component, cg.Controller)
 
+CONF_CSS_INCLUDE = 'css_include'
+CONF_JS_INCLUDE = 'js_include'
+CONF_INDEX_DATA_ID = 'index_data_id'
+CONF_CSS_DATA_ID = 'css_data_id'
+CONF_JS_DATA_ID = 'js_data_id'
+CONF_EVENT_QUEUE_SIZE = 'event_queue_size'
+CONF_EVENT_INTERVAL = 'event_interval'
+
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(WebServer),
     cv.Optional(CONF_PORT, default=80): cv.port,
     cv.Optional(CONF_CSS_URL, default="https://esphome.io/_static/webserver-v1.min.css"): cv.string,
     cv.Optional(CONF_JS_URL, default="https://esphome.io/_static/webserver-v1.min.js"): cv.string,
+    cv.Optional(CONF_CSS_INCLUDE): cv.file_,
+    cv.Optional(CONF_JS_INCLUDE): cv.file_,
+    cv.SplitDefault(CONF_EVENT_QUEUE_SIZE, esp32='4kB', esp8266='1kB'): cv.validate_bytes,
+    cv.Optional(CONF_EVENT_INTERVAL, default='0ms'): cv.positive_time_period_milliseconds,
 
     cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+    cv.GenerateID(CONF_INDEX_DATA_ID): cv.declare_id(cg.uint8),
+    cv.GenerateID(CONF_CSS_DATA_ID): cv.declare_id(cg.uint8),
+    cv.GenerateID(CONF_JS_DATA_ID): cv.declare_id(cg.uint8),
 }).extend(cv.COMPONENT_SCHEMA)
 
 
+def build_index_html(title, css_url, js_url):
+    """The static part of the index page. The script is started once the entity rows from /rows are in place."""
+    return (
+        u'<!DOCTYPE html><html><head><meta charset=UTF-8><title>{title}</title>'
+        u'<link rel="stylesheet" href="{css_url}"></head><body><article class="markdown-body"><h1>{title}</h1>'
+        u'<h2>States</h2><table id="states"><thead><tr><th>Name<th>State<th>Actions<tbody></tbody></table>'
+        u'<p>See <a href="https://esphome.io/web-api/index.html">ESPHome Web API</a> for REST API documentation.</p>'
+        u'<h2>OTA Update</h2><form method="POST" action="/update" enctype="multipart/form-data">'
+        u'<input type="file" name="update"><input type="submit" value="Update"></form>'
+        u'<h2>Debug Log</h2><pre id="log"></pre>'
+        u'<script>fetch("/rows").then(function(r){{return r.text()}}).then(function(t){{'
+        u'document.querySelector("#states tbody").innerHTML=t;var s=document.createElement("script");'
+        u's.src={js_url};document.body.appendChild(s)}})</script>'
+        u'</article></body></html>'
+    ).format(title=title, css_url=css_url, js_url=json.dumps(js_url))
+
+
+def compress(data):
+    """Gzip data without a timestamp so that unchanged files keep their ETag across builds."""
+    buf = io.BytesIO()
+    with gzip.GzipFile(fileobj=buf, mode='wb', compresslevel=9, mtime=0) as gz:
+        gz.write(data)
+    return buf.getvalue()
+
+
+def add_asset(var, id_, url, content_type, data):
+    compressed = compress(data)
+    etag = u'"{}"'.format(hashlib.sha1(compressed).hexdigest()[:16])
+    arr = cg.progmem_array(id_, [HexInt(x) for x in bytearray(compressed)])
+    cg.add(var.add_asset(url, content_type, arr, len(compressed), etag))
+
+
+def read_file(path):
+    with open(CORE.relative_config_path(path), 'rb') as f_handle:
+        return f_handle.read()
+
+
 @coroutine_with_priority(40.0)
 def to_code(config):
     paren = yield cg.get_variable(config[CONF_WEB_SERVER_BASE_ID])
@@ -28,5 +85,17 @@ def to_code(config):
     yield cg.register_component(var, config)
 
     cg.add(paren.set_port(config[CONF_PORT]))
-    cg.add(var.set_css_url(config[CONF_CSS_URL]))
-    cg.add(var.set_js_url(config[CONF_JS_URL]))
+    cg.add(var.set_event_queue_size(config[CONF_EVENT_QUEUE_SIZE]))
+    cg.add(var.set_event_interval(config[CONF_EVENT_INTERVAL]))
+
+    css_url = config[CONF_CSS_URL]
+    if CONF_CSS_INCLUDE in config:
+        css_url = u'/0.css'
+        add_asset(var, config[CONF_CSS_DATA_ID], css_url, 'text/css', read_file(config[CONF_CSS_INCLUDE]))
+    js_url = config[CONF_JS_URL]
+    if CONF_JS_INCLUDE in config:
+        js_url = u'/0.js'
+        add_asset(var, config[CONF_JS_DATA_ID], js_url, 'text/javascript', read_file(config[CONF_JS_INCLUDE]))
+
+    index = build_index_html(u'{} Web Server'.format(CORE.name), css_url, js_url)
+    add_asset(var, config[CONF_INDEX_DATA_ID], '/', 'text/html', index.encode('utf-8'))
@@ -2,7 +2,6 @@
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
 #include "esphome/core/util.h"
-#include "esphome/components/json/json_util.h"
 
 #include "StreamString.h"
 
@@ -14,6 +13,28 @@ namespace web_server {
 
 static const char *TAG = "web_server";
 
+#ifdef USE_ESP32_CAMERA
+#define CAMERA_BOUNDARY "esphomeframe"
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+/// Recursive, closing a connection from loop() runs its disconnect callbacks right away.
+static SemaphoreHandle_t connection_lock = nullptr;
+#endif
+
+/** Keeps the TCP task from deleting a connection that loop() is writing to.
+ *
+ * On the ESP32 the TCP callbacks run on their own task, which deletes the connection right after its response.
+ * On the ESP8266 they never interrupt loop(), so there's nothing to lock.
+ */
+class ConnectionLock {
+ public:
+#ifdef ARDUINO_ARCH_ESP32
+  ConnectionLock() { xSemaphoreTakeRecursive(connection_lock, portMAX_DELAY); }
+  ~ConnectionLock() { xSemaphoreGiveRecursive(connection_lock); }
+#endif
+};
+
 void write_row(AsyncResponseStream *stream, Nameable *obj, const std::string &klass, const std::string &action) {
   stream->print("<tr class=\"");
   stream->print(klass.c_str());
@@ -54,81 +75,457 @@ UrlMatch match_url(const std::string &url, bool only_domain = false) {
   return match;
 }
 
-void WebServer::set_css_url(const char *css_url) { this->css_url_ = css_url; }
-void WebServer::set_js_url(const char *js_url) { this->js_url_ = js_url; }
+/// Enough for the state JSON of most entities, longer ones are moved to the heap.
+static const size_t STATE_JSON_BUFFER_SIZE = 256;
+
+/// Respond with the JSON written by f, which goes straight into the response stream.
+template<typename F> void send_json_response(AsyncWebServerRequest *request, F f) {
+  AsyncResponseStream *stream = request->beginResponseStream("text/json");
+  json::JsonPrintWriter writer(*stream);
+  f(writer);
+  request->send(stream);
+}
+
+/// Names of the EntityDomain values, as used in the URLs.
+static const char *const DOMAIN_NAMES[] = {"sensor", "switch", "binary_sensor", "fan", "light", "text_sensor"};
+
+struct StatesCursor {
+  /// Only entities of this EntityDomain, -1 for all.
+  int domain{-1};
+  /// Only entities that changed after since.
+  bool only_changed{false};
+  uint32_t since{0};
+  uint32_t boot_id{0};
+  uint32_t seq{0};
+  /// Index of the next entity in entity_changes_.
+  size_t next{0};
+  bool started{false};
+  bool first_state{true};
+  bool finished{false};
+  /// The part that is being sent, up to part_pos has been copied to the response already.
+  std::string part;
+  size_t part_pos{0};
+};
+
+/// Write the "<domain>-<object id>" id of an entity.
+void write_id(json::JsonWriter &writer, const char *domain, Nameable *obj) {
+  writer.key("id");
+  writer.begin_string();
+  writer.append_string(domain, strlen(domain));
+  writer.append_string("-", 1);
+  writer.append_string(obj->get_object_id());
+  writer.end_string();
+}
+
+void WebServer::add_asset(const char *url, const char *content_type, const uint8_t *data, size_t length,
+                          const char *etag) {
+  this->assets_.push_back(WebServerAsset{
+      .url = url,
+      .content_type = content_type,
+      .data = data,
+      .length = length,
+      .etag = etag,
+  });
+}
 
 void WebServer::setup() {
   ESP_LOGCONFIG(TAG, "Setting up web server...");
   this->base_->init();
-
-  this->events_.onConnect([this](AsyncEventSourceClient *client) {
-    // Configure reconnect timeout
-    client->send("", "ping", millis(), 30000);
+  this->rows_etag_ = "\"" + uint32_to_string(fnv1_hash(App.get_compilation_time())) + "\"";
+  this->boot_id_ = random_uint32();
 
 #ifdef USE_SENSOR
-    for (auto *obj : App.get_sensors())
-      if (!obj->is_internal())
-        client->send(this->sensor_json(obj, obj->state).c_str(), "state");
+  for (auto *obj : App.get_sensors())
+    if (!obj->is_internal())
+      this->entity_changes_.push_back(EntityChange{.entity = obj, .domain = DOMAIN_SENSOR, .changed_seq = 0});
 #endif
-
 #ifdef USE_SWITCH
-    for (auto *obj : App.get_switches())
-      if (!obj->is_internal())
-        client->send(this->switch_json(obj, obj->state).c_str(), "state");
+  for (auto *obj : App.get_switches())
+    if (!obj->is_internal())
+      this->entity_changes_.push_back(EntityChange{.entity = obj, .domain = DOMAIN_SWITCH, .changed_seq = 0});
 #endif
-
 #ifdef USE_BINARY_SENSOR
-    for (auto *obj : App.get_binary_sensors())
-      if (!obj->is_internal())
-        client->send(this->binary_sensor_json(obj, obj->state).c_str(), "state");
+  for (auto *obj : App.get_binary_sensors())
+    if (!obj->is_internal())
+      this->entity_changes_.push_back(EntityChange{.entity = obj, .domain = DOMAIN_BINARY_SENSOR, .changed_seq = 0});
 #endif
-
 #ifdef USE_FAN
-    for (auto *obj : App.get_fans())
-      if (!obj->is_internal())
-        client->send(this->fan_json(obj).c_str(), "state");
+  for (auto *obj : App.get_fans())
+    if (!obj->is_internal())
+      this->entity_changes_.push_back(EntityChange{.entity = obj, .domain = DOMAIN_FAN, .changed_seq = 0});
 #endif
-
 #ifdef USE_LIGHT
-    for (auto *obj : App.get_lights())
-      if (!obj->is_internal())
-        client->send(this->light_json(obj).c_str(), "state");
+  for (auto *obj : App.get_lights())
+    if (!obj->is_internal())
+      this->entity_changes_.push_back(EntityChange{.entity = obj, .domain = DOMAIN_LIGHT, .changed_seq = 0});
 #endif
-
 #ifdef USE_TEXT_SENSOR
-    for (auto *obj : App.get_text_sensors())
-      if (!obj->is_internal())
-        client->send(this->text_sensor_json(obj, obj->state).c_str(), "state");
+  for (auto *obj : App.get_text_sensors())
+    if (!obj->is_internal())
+      this->entity_changes_.push_back(EntityChange{.entity = obj, .domain = DOMAIN_TEXT_SENSOR, .changed_seq = 0});
 #endif
-  });
 
 #ifdef USE_LOGGER
   if (logger::global_logger != nullptr)
     logger::global_logger->add_on_log_callback(
-        [this](int level, const char *tag, const char *message) { this->events_.send(message, "log", millis()); });
+        [this](int level, const char *tag, const char *message) { this->on_log_(message); });
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+  connection_lock = xSemaphoreCreateRecursiveMutex();
 #endif
-  this->base_->add_handler(&this->events_);
   this->base_->add_handler(this);
   this->base_->add_ota_handler();
 
-  this->set_interval(10000, [this]() { this->events_.send("", "ping", millis(), 30000); });
+  this->set_interval(10000, [this]() {
+    for (EventClient *c : this->event_clients_) {
+      if (c != nullptr)
+        c->ping_due = true;
+    }
+  });
+
+#ifdef USE_ESP32_CAMERA
+  this->camera_client_queue_ = xQueueCreate(MAX_CAMERA_STREAMS + 2, sizeof(CameraClient *));
+  if (esp32_camera::global_esp32_camera != nullptr) {
+    esp32_camera::global_esp32_camera->add_image_callback([this](std::shared_ptr<esp32_camera::CameraImage> image) {
+      for (auto *c : this->camera_clients_) {
+        // skip frames for clients that are still busy with the previous one
+        if (c->disconnected || c->finished || c->image_reader.available() || c->data_in_flight())
+          continue;
+        c->image_reader.set_image(image);
+        c->part_started = false;
+      }
+    });
+  }
+#endif
+}
+void WebServer::loop() {
+  ConnectionLock lock;
+  for (auto &slot : this->event_clients_) {
+    EventClient *c = slot;
+    if (c == nullptr)
+      continue;
+    if (c->disconnected) {
+      if (c->coalesced != 0 || c->dropped_logs != 0)
+        ESP_LOGD(TAG, "Event client disconnected, %u state events coalesced, %u log lines dropped", c->coalesced,
+                 c->dropped_logs);
+      delete c;
+      slot = nullptr;
+      continue;
+    }
+    this->send_events_(c);
+  }
+#ifdef USE_ESP32_CAMERA
+  this->process_camera_clients_();
+#endif
 }
 void WebServer::dump_config() {
   ESP_LOGCONFIG(TAG, "Web Server:");
   ESP_LOGCONFIG(TAG, "  Address: %s:%u", network_get_address().c_str(), this->base_->get_port());
+  ESP_LOGCONFIG(TAG, "  Event Queue Size: %u bytes", this->event_queue_size_);  // NOLINT
+  if (this->event_interval_ != 0)
+    ESP_LOGCONFIG(TAG, "  Event Interval: %u ms", this->event_interval_);
+}
+
+EventResponse::~EventResponse() {
+  // the connection is deleted right after this, WebServer::loop() deletes the client once it sees the flag
+  ConnectionLock lock;
+  this->client_->disconnected = true;
+}
+void EventResponse::_respond(AsyncWebServerRequest *request) {
+  this->_state = RESPONSE_CONTENT;
+  this->client_->client = request->client();
+}
+
+void WebServer::handle_events_request(AsyncWebServerRequest *request) {
+  for (auto &slot : this->event_clients_) {
+    if (slot != nullptr)
+      continue;
+    auto *client = new EventClient{};
+    request->send(new EventResponse(client));
+    // only published once send() has handed over the connection
+    slot = client;
+    return;
+  }
+  request->send(503);
+}
+void WebServer::on_state_change_(Nameable *entity) {
+  for (uint16_t i = 0; i < this->entity_changes_.size(); i++) {
+    EntityChange &change = this->entity_changes_[i];
+    if (change.entity != entity)
+      continue;
+    change.changed_seq = ++this->state_seq_;
+    for (EventClient *c : this->event_clients_) {
+      if (c == nullptr)
+        continue;
+      // the state is read when it's sent, so a queued entry always sends the latest one
+      if (std::find(c->pending_states.begin(), c->pending_states.end(), i) != c->pending_states.end())
+        c->coalesced++;
+      else
+        c->pending_states.push_back(i);
+    }
+    return;
+  }
+}
+void WebServer::on_log_(const char *message) {
+  const size_t len = strlen(message);
+  for (EventClient *c : this->event_clients_) {
+    if (c == nullptr)
+      continue;
+    // make room by dropping the oldest lines, the newest are the most interesting ones
+    while (!c->pending_logs.empty() && c->pending_logs_size + len > this->event_queue_size_) {
+      c->pending_logs_size -= c->pending_logs.front().size();
+      c->pending_logs.pop_front();
+      c->dropped_logs++;
+    }
+    if (len > this->event_queue_size_) {
+      c->dropped_logs++;
+      continue;
+    }
+    c->pending_logs.emplace_back(message, len);
+    c->pending_logs_size += len;
+  }
+}
+void WebServer::send_events_(EventClient *c) {
+  if (!c->head_sent) {
+    static const char HEAD[] = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+                               "Connection: keep-alive\r\nAccess-Control-Allow-Origin: *\r\n\r\n"
+                               // reconnect timeout of the browser
+                               "retry: 30000\r\n\r\n";
+    if (c->client->space() < sizeof(HEAD) - 1)
+      return;
+    c->client->add(HEAD, sizeof(HEAD) - 1);
+    c->head_sent = true;
+    // the initial state of all entities
+    c->pending_states.clear();
+    for (uint16_t i = 0; i < this->entity_changes_.size(); i++)
+      c->pending_states.push_back(i);
+  }
+
+  bool sent = false;
+  while (!c->pending_logs.empty()) {
+    const std::string &line = c->pending_logs.front();
+    if (!this->write_event_(c, "log", line.data(), line.size()))
+      break;
+    c->pending_logs_size -= line.size();
+    c->pending_logs.pop_front();
+    sent = true;
+  }
+
+  const uint32_t now = millis();
+  if (!c->pending_states.empty() && now - c->last_states_sent >= this->event_interval_) {
+    size_t count = 0;
+    for (uint16_t index : c->pending_states) {
+      json::StaticJsonWriter<STATE_JSON_BUFFER_SIZE> writer;
+      this->write_state_json_(writer, this->entity_changes_[index]);
+      if (!this->write_event_(c, "state", writer.c_str(), writer.size()))
+        break;
+      count++;
+    }
+    if (count != 0) {
+      c->pending_states.erase(c->pending_states.begin(), c->pending_states.begin() + count);
+      c->last_states_sent = now;
+      sent = true;
+    }
+  }
+
+  if (c->ping_due && this->write_event_(c, "ping", "", 0)) {
+    c->ping_due = false;
+    sent = true;
+  }
+  if (sent)
+    c->client->send();
+}
+bool WebServer::write_event_(EventClient *c, const char *event, const char *data, size_t len) {
+  std::string &buf = this->event_buffer_;
+  buf.clear();
+  buf += "event: ";
+  buf += event;
+  buf += "\r\n";
+  // every line of the data needs its own field
+  size_t start = 0;
+  while (true) {
+    const auto *newline = static_cast<const char *>(memchr(data + start, '\n', len - start));
+    const size_t end = newline == nullptr ? len : newline - data;
+    buf += "data: ";
+    buf.append(data + start, end - start);
+    buf += "\r\n";
+    if (newline == nullptr)
+      break;
+    start = end + 1;
+  }
+  buf += "\r\n";
+  if (c->client->space() < buf.size())
+    return false;
+  c->client->add(buf.data(), buf.size());
+  return true;
 }
 float WebServer::get_setup_priority() const { return setup_priority::WIFI - 1.0f; }
 
-void WebServer::handle_index_request(AsyncWebServerRequest *request) {
+#ifdef USE_ESP32_CAMERA
+void CameraClient::write(const void *data, size_t len, bool copy) {
+  this->tx_queued += this->client->add(reinterpret_cast<const char *>(data), len, copy ? ASYNC_WRITE_FLAG_COPY : 0);
+}
+CameraResponse::~CameraResponse() {
+  // the connection is deleted right after this, WebServer::loop() deletes the client once it sees the flag
+  ConnectionLock lock;
+  this->client_->disconnected = true;
+}
+void CameraResponse::_respond(AsyncWebServerRequest *request) {
+  this->_state = RESPONSE_CONTENT;
+  this->client_->client = request->client();
+}
+size_t CameraResponse::_ack(AsyncWebServerRequest *request, size_t len, uint32_t time) {
+  this->client_->tx_acked += len;
+  return 0;
+}
+
+void WebServer::process_camera_clients_() {
+  // drop disconnected clients first, so they don't count against the stream limit
+  for (auto it = this->camera_clients_.begin(); it != this->camera_clients_.end();) {
+    if ((*it)->disconnected) {
+      delete *it;
+      it = this->camera_clients_.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  CameraClient *new_client;
+  while (xQueueReceive(this->camera_client_queue_, &new_client, 0L) == pdTRUE) {
+    if (new_client->disconnected) {
+      delete new_client;
+      continue;
+    }
+    if (new_client->stream) {
+      uint8_t streams = 0;
+      for (auto *c : this->camera_clients_)
+        streams += c->stream && !c->finished;
+      if (streams >= MAX_CAMERA_STREAMS) {
+        ESP_LOGW(TAG, "Too many camera streams, rejecting client");
+        static const char RESPONSE[] = "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n";
+        new_client->write(RESPONSE, sizeof(RESPONSE) - 1);
+        new_client->client->send();
+        new_client->finished = true;
+        // runs the disconnect callbacks, the client is deleted with the next call
+        new_client->client->close();
+      }
+    } else {
+      esp32_camera::global_esp32_camera->request_image();
+    }
+    this->camera_clients_.push_back(new_client);
+  }
+
+  bool streaming = false;
+  for (auto *c : this->camera_clients_) {
+    if (c->disconnected || c->finished)
+      continue;
+    if (c->image_in_flight && !c->data_in_flight()) {
+      c->image_in_flight.reset();
+      if (!c->stream) {
+        c->finished = true;
+        c->client->close();
+        continue;
+      }
+    }
+    if (c->image_reader.available())
+      this->send_camera_data_(c);
+    streaming |= c->stream;
+  }
+  if (streaming)
+    esp32_camera::global_esp32_camera->request_stream();
+}
+void WebServer::send_camera_data_(CameraClient *c) {
+  // room for the headers and at least some image data
+  if (c->client->space() < 256)
+    return;
+
+  char buffer[160];
+  const unsigned length = c->image_reader.get_image()->get_data_length();
+  if (!c->head_sent) {
+    int len;
+    if (c->stream) {
+      len = snprintf(buffer, sizeof(buffer),
+                     "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace;boundary=" CAMERA_BOUNDARY
+                     "\r\nConnection: close\r\nAccess-Control-Allow-Origin: *\r\n\r\n");
+    } else {
+      len = snprintf(buffer, sizeof(buffer),
+                     "HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n"
+                     "Connection: close\r\nAccess-Control-Allow-Origin: *\r\n\r\n",
+                     length);
+    }
+    c->write(buffer, len);
+    c->head_sent = true;
+  }
+  if (c->stream && !c->part_started) {
+    int len = snprintf(buffer, sizeof(buffer),
+                       "--" CAMERA_BOUNDARY "\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n", length);
+    c->write(buffer, len);
+    c->part_started = true;
+  }
+
+  // keep 2 bytes for the part trailer
+  const size_t to_send = std::min(c->client->space() - 2, c->image_reader.available());
+  // no copy, the image is kept alive until this data has been acknowledged
+  c->write(c->image_reader.peek_data_buffer(), to_send, false);
+  c->image_release_at = c->tx_queued;
+  c->image_reader.consume_data(to_send);
+  if (!c->image_reader.available()) {
+    if (c->stream)
+      c->write("\r\n", 2);
+    c->image_in_flight = c->image_reader.get_image();
+    c->image_reader.return_image();
+  }
+  c->client->send();
+}
+void WebServer::handle_camera_request(AsyncWebServerRequest *request, UrlMatch match) {
+  if (esp32_camera::global_esp32_camera == nullptr || (match.id != "stream" && match.id != "snapshot")) {
+    request->send(404);
+    return;
+  }
+  if (uxQueueSpacesAvailable(this->camera_client_queue_) == 0) {
+    request->send(503);
+    return;
+  }
+  auto *client = new CameraClient{};
+  client->stream = match.id == "stream";
+  request->send(new CameraResponse(client));
+  xQueueSend(this->camera_client_queue_, &client, 0L);
+}
+#endif
+
+bool WebServer::send_not_modified_(AsyncWebServerRequest *request, const char *etag) {
+  AsyncWebHeader *header = request->getHeader("If-None-Match");
+  if (header == nullptr || header->value() != etag)
+    return false;
+  AsyncWebServerResponse *response = request->beginResponse(304);
+  response->addHeader("ETag", etag);
+  request->send(response);
+  return true;
+}
+void WebServer::handle_asset_request_(AsyncWebServerRequest *request, const WebServerAsset &asset) {
+  if (this->send_not_modified_(request, asset.etag))
+    return;
+  AsyncWebServerResponse *response = request->beginResponse_P(200, asset.content_type, asset.data, asset.length);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", asset.etag);
+  // may be cached, but has to be revalidated: the ETag changes with every build that changes the file
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+const WebServerAsset *WebServer::find_asset_(const String &url) const {
+  for (auto &asset : this->assets_) {
+    if (url == asset.url)
+      return &asset;
+  }
+  return nullptr;
+}
+
+void WebServer::handle_rows_request(AsyncWebServerRequest *request) {
+  if (this->send_not_modified_(request, this->rows_etag_.c_str()))
+    return;
   AsyncResponseStream *stream = request->beginResponseStream("text/html");
-  std::string title = App.get_name() + " Web Server";
-  stream->print(F("<!DOCTYPE html><html><head><meta charset=UTF-8><title>"));
-  stream->print(title.c_str());
-  stream->print(F("</title><link rel=\"stylesheet\" href=\""));
-  stream->print(this->css_url_);
-  stream->print(F("\"></head><body><article class=\"markdown-body\"><h1>"));
-  stream->print(title.c_str());
-  stream->print(F("</h1><h2>States</h2><table id=\"states\"><thead><tr><th>Name<th>State<th>Actions<tbody>"));
+  stream->addHeader("ETag", this->rows_etag_.c_str());
+  stream->addHeader("Cache-Control", "no-cache");
 
 #ifdef USE_SENSOR
   for (auto *obj : App.get_sensors())
@@ -166,21 +563,12 @@ void WebServer::handle_index_request(AsyncWebServerRequest *request) {
       write_row(stream, obj, "text_sensor", "");
 #endif
 
-  stream->print(F("</tbody></table><p>See <a href=\"https://esphome.io/web-api/index.html\">ESPHome Web API</a> for "
-                  "REST API documentation.</p>"
-                  "<h2>OTA Update</h2><form method=\"POST\" action=\"/update\" enctype=\"multipart/form-data\"><input "
-                  "type=\"file\" name=\"update\"><input type=\"submit\" value=\"Update\"></form>"
-                  "<h2>Debug Log</h2><pre id=\"log\"></pre>"
-                  "<script src=\""));
-  stream->print(this->js_url_);
-  stream->print(F("\"></script></article></body></html>"));
-
   request->send(stream);
 }
 
 #ifdef USE_SENSOR
 void WebServer::on_sensor_update(sensor::Sensor *obj, float state) {
-  this->events_.send(this->sensor_json(obj, state).c_str(), "state");
+  this->on_state_change_(obj);
 }
 void WebServer::handle_sensor_request(AsyncWebServerRequest *request, UrlMatch match) {
   for (sensor::Sensor *obj : App.get_sensors()) {
@@ -188,27 +576,32 @@ void WebServer::handle_sensor_request(AsyncWebServerRequest *request, UrlMatch m
       continue;
     if (obj->get_object_id() != match.id)
       continue;
-    std::string data = this->sensor_json(obj, obj->state);
-    request->send(200, "text/json", data.c_str());
+    send_json_response(request, [this, obj](json::JsonWriter &writer) { this->sensor_json(writer, obj, obj->state); });
     return;
   }
   request->send(404);
 }
-std::string WebServer::sensor_json(sensor::Sensor *obj, float value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "sensor-" + obj->get_object_id();
-    std::string state = value_accuracy_to_string(value, obj->get_accuracy_decimals());
-    if (!obj->get_unit_of_measurement().empty())
-      state += " " + obj->get_unit_of_measurement();
-    root["state"] = state;
-    root["value"] = value;
-  });
+void WebServer::sensor_json(json::JsonWriter &writer, sensor::Sensor *obj, float value) {
+  writer.begin_object();
+  write_id(writer, "sensor", obj);
+  writer.key("state");
+  writer.begin_string();
+  char buf[VALUE_ACCURACY_BUF_SIZE];
+  writer.append_string(buf, value_accuracy_to_buf(buf, value, obj->get_accuracy_decimals()));
+  const std::string unit = obj->get_unit_of_measurement();
+  if (!unit.empty()) {
+    writer.append_string(" ", 1);
+    writer.append_string(unit);
+  }
+  writer.end_string();
+  writer.add("value", value);
+  writer.end_object();
 }
 #endif
 
 #ifdef USE_TEXT_SENSOR
 void WebServer::on_text_sensor_update(text_sensor::TextSensor *obj, std::string state) {
-  this->events_.send(this->text_sensor_json(obj, state).c_str(), "state");
+  this->on_state_change_(obj);
 }
 void WebServer::handle_text_sensor_request(AsyncWebServerRequest *request, UrlMatch match) {
   for (text_sensor::TextSensor *obj : App.get_text_sensors()) {
@@ -216,31 +609,31 @@ void WebServer::handle_text_sensor_request(AsyncWebServerRequest *request, UrlMa
       continue;
     if (obj->get_object_id() != match.id)
       continue;
-    std::string data = this->text_sensor_json(obj, obj->state);
-    request->send(200, "text/json", data.c_str());
+    send_json_response(request,
+                       [this, obj](json::JsonWriter &writer) { this->text_sensor_json(writer, obj, obj->state); });
     return;
   }
   request->send(404);
 }
-std::string WebServer::text_sensor_json(text_sensor::TextSensor *obj, const std::string &value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "text_sensor-" + obj->get_object_id();
-    root["state"] = value;
-    root["value"] = value;
-  });
+void WebServer::text_sensor_json(json::JsonWriter &writer, text_sensor::TextSensor *obj, const std::string &value) {
+  writer.begin_object();
+  write_id(writer, "text_sensor", obj);
+  writer.add("state", value);
+  writer.add("value", value);
+  writer.end_object();
 }
 #endif
 
 #ifdef USE_SWITCH
 void WebServer::on_switch_update(switch_::Switch *obj, bool state) {
-  this->events_.send(this->switch_json(obj, state).c_str(), "state");
+  this->on_state_change_(obj);
 }
-std::string WebServer::switch_json(switch_::Switch *obj, bool value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "switch-" + obj->get_object_id();
-    root["state"] = value ? "ON" : "OFF";
-    root["value"] = value;
-  });
+void WebServer::switch_json(json::JsonWriter &writer, switch_::Switch *obj, bool value) {
+  writer.begin_object();
+  write_id(writer, "switch", obj);
+  writer.add("state", value ? "ON" : "OFF");
+  writer.add("value", value);
+  writer.end_object();
 }
 void WebServer::handle_switch_request(AsyncWebServerRequest *request, UrlMatch match) {
   for (switch_::Switch *obj : App.get_switches()) {
@@ -250,8 +643,8 @@ void WebServer::handle_switch_request(AsyncWebServerRequest *request, UrlMatch m
       continue;
 
     if (request->method() == HTTP_GET) {
-      std::string data = this->switch_json(obj, obj->state);
-      request->send(200, "text/json", data.c_str());
+      send_json_response(request,
+                         [this, obj](json::JsonWriter &writer) { this->switch_json(writer, obj, obj->state); });
     } else if (match.method == "toggle") {
       this->defer([obj]() { obj->toggle(); });
       request->send(200);
@@ -274,14 +667,14 @@ void WebServer::handle_switch_request(AsyncWebServerRequest *request, UrlMatch m
 void WebServer::on_binary_sensor_update(binary_sensor::BinarySensor *obj, bool state) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->binary_sensor_json(obj, state).c_str(), "state");
+  this->on_state_change_(obj);
 }
-std::string WebServer::binary_sensor_json(binary_sensor::BinarySensor *obj, bool value) {
-  return json::build_json([obj, value](JsonObject &root) {
-    root["id"] = "binary_sensor-" + obj->get_object_id();
-    root["state"] = value ? "ON" : "OFF";
-    root["value"] = value;
-  });
+void WebServer::binary_sensor_json(json::JsonWriter &writer, binary_sensor::BinarySensor *obj, bool value) {
+  writer.begin_object();
+  write_id(writer, "binary_sensor", obj);
+  writer.add("state", value ? "ON" : "OFF");
+  writer.add("value", value);
+  writer.end_object();
 }
 void WebServer::handle_binary_sensor_request(AsyncWebServerRequest *request, UrlMatch match) {
   for (binary_sensor::BinarySensor *obj : App.get_binary_sensors()) {
@@ -289,8 +682,8 @@ void WebServer::handle_binary_sensor_request(AsyncWebServerRequest *request, Url
       continue;
     if (obj->get_object_id() != match.id)
       continue;
-    std::string data = this->binary_sensor_json(obj, obj->state);
-    request->send(200, "text/json", data.c_str());
+    send_json_response(request,
+                       [this, obj](json::JsonWriter &writer) { this->binary_sensor_json(writer, obj, obj->state); });
     return;
   }
   request->send(404);
@@ -301,29 +694,29 @@ void WebServer::handle_binary_sensor_request(AsyncWebServerRequest *request, Url
 void WebServer::on_fan_update(fan::FanState *obj) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->fan_json(obj).c_str(), "state");
-}
-std::string WebServer::fan_json(fan::FanState *obj) {
-  return json::build_json([obj](JsonObject &root) {
-    root["id"] = "fan-" + obj->get_object_id();
-    root["state"] = obj->state ? "ON" : "OFF";
-    root["value"] = obj->state;
-    if (obj->get_traits().supports_speed()) {
-      switch (obj->speed) {
-        case fan::FAN_SPEED_LOW:
-          root["speed"] = "low";
-          break;
-        case fan::FAN_SPEED_MEDIUM:
-          root["speed"] = "medium";
-          break;
-        case fan::FAN_SPEED_HIGH:
-          root["speed"] = "high";
-          break;
-      }
+  this->on_state_change_(obj);
+}
+void WebServer::fan_json(json::JsonWriter &writer, fan::FanState *obj) {
+  writer.begin_object();
+  write_id(writer, "fan", obj);
+  writer.add("state", obj->state ? "ON" : "OFF");
+  writer.add("value", obj->state);
+  if (obj->get_traits().supports_speed()) {
+    switch (obj->speed) {
+      case fan::FAN_SPEED_LOW:
+        writer.add("speed", "low");
+        break;
+      case fan::FAN_SPEED_MEDIUM:
+        writer.add("speed", "medium");
+        break;
+      case fan::FAN_SPEED_HIGH:
+        writer.add("speed", "high");
+        break;
     }
-    if (obj->get_traits().supports_oscillation())
-      root["oscillation"] = obj->oscillating;
-  });
+  }
+  if (obj->get_traits().supports_oscillation())
+    writer.add("oscillation", obj->oscillating);
+  writer.end_object();
 }
 void WebServer::handle_fan_request(AsyncWebServerRequest *request, UrlMatch match) {
   for (fan::FanState *obj : App.get_fans()) {
@@ -333,8 +726,7 @@ void WebServer::handle_fan_request(AsyncWebServerRequest *request, UrlMatch matc
       continue;
 
     if (request->method() == HTTP_GET) {
-      std::string data = this->fan_json(obj);
-      request->send(200, "text/json", data.c_str());
+      send_json_response(request, [this, obj](json::JsonWriter &writer) { this->fan_json(writer, obj); });
     } else if (match.method == "toggle") {
       this->defer([obj]() { obj->toggle().perform(); });
       request->send(200);
@@ -380,7 +772,7 @@ void WebServer::handle_fan_request(AsyncWebServerRequest *request, UrlMatch matc
 void WebServer::on_light_update(light::LightState *obj) {
   if (obj->is_internal())
     return;
-  this->events_.send(this->light_json(obj).c_str(), "state");
+  this->on_state_change_(obj);
 }
 void WebServer::handle_light_request(AsyncWebServerRequest *request, UrlMatch match) {
   for (light::LightState *obj : App.get_lights()) {
@@ -390,8 +782,7 @@ void WebServer::handle_light_request(AsyncWebServerRequest *request, UrlMatch ma
       continue;
 
     if (request->method() == HTTP_GET) {
-      std::string data = this->light_json(obj);
-      request->send(200, "text/json", data.c_str());
+      send_json_response(request, [this, obj](json::JsonWriter &writer) { this->light_json(writer, obj); });
     } else if (match.method == "toggle") {
       this->defer([obj]() { obj->toggle().perform(); });
       request->send(200);
@@ -438,18 +829,136 @@ void WebServer::handle_light_request(AsyncWebServerRequest *request, UrlMatch ma
   }
   request->send(404);
 }
-std::string WebServer::light_json(light::LightState *obj) {
-  return json::build_json([obj](JsonObject &root) {
-    root["id"] = "light-" + obj->get_object_id();
-    root["state"] = obj->remote_values.is_on() ? "ON" : "OFF";
-    obj->dump_json(root);
-  });
+void WebServer::light_json(json::JsonWriter &writer, light::LightState *obj) {
+  writer.begin_object();
+  write_id(writer, "light", obj);
+  // dump_json() writes the state
+  obj->dump_json(writer);
+  writer.end_object();
 }
 #endif
 
+void WebServer::write_state_json_(json::JsonWriter &writer, const EntityChange &change) {
+  switch (change.domain) {
+#ifdef USE_SENSOR
+    case DOMAIN_SENSOR: {
+      auto *obj = static_cast<sensor::Sensor *>(change.entity);
+      this->sensor_json(writer, obj, obj->state);
+      break;
+    }
+#endif
+#ifdef USE_SWITCH
+    case DOMAIN_SWITCH: {
+      auto *obj = static_cast<switch_::Switch *>(change.entity);
+      this->switch_json(writer, obj, obj->state);
+      break;
+    }
+#endif
+#ifdef USE_BINARY_SENSOR
+    case DOMAIN_BINARY_SENSOR: {
+      auto *obj = static_cast<binary_sensor::BinarySensor *>(change.entity);
+      this->binary_sensor_json(writer, obj, obj->state);
+      break;
+    }
+#endif
+#ifdef USE_FAN
+    case DOMAIN_FAN:
+      this->fan_json(writer, static_cast<fan::FanState *>(change.entity));
+      break;
+#endif
+#ifdef USE_LIGHT
+    case DOMAIN_LIGHT:
+      this->light_json(writer, static_cast<light::LightState *>(change.entity));
+      break;
+#endif
+#ifdef USE_TEXT_SENSOR
+    case DOMAIN_TEXT_SENSOR: {
+      auto *obj = static_cast<text_sensor::TextSensor *>(change.entity);
+      this->text_sensor_json(writer, obj, obj->state);
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+}
+void WebServer::handle_states_request(AsyncWebServerRequest *request) {
+  auto cursor = std::make_shared<StatesCursor>();
+  if (request->hasParam("domain")) {
+    const String &domain = request->getParam("domain")->value();
+    for (int i = 0; i < int(sizeof(DOMAIN_NAMES) / sizeof(DOMAIN_NAMES[0])); i++) {
+      if (domain == DOMAIN_NAMES[i])
+        cursor->domain = i;
+    }
+    if (cursor->domain < 0) {
+      request->send(404);
+      return;
+    }
+  }
+  cursor->seq = this->state_seq_;
+  cursor->boot_id = this->boot_id_;
+  // a sequence number from before a reboot, the client needs everything
+  if (request->hasParam("since") && request->hasParam("boot") &&
+      strtoul(request->getParam("boot")->value().c_str(), nullptr, 10) == this->boot_id_) {
+    cursor->since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+    cursor->only_changed = cursor->since <= cursor->seq;
+  }
+  // called from the TCP stack whenever there's room for more data, until it returns 0
+  auto filler = [this, cursor](uint8_t *buffer, size_t max_len, size_t index) {
+    return this->fill_states_response_(*cursor, buffer, max_len);
+  };
+  request->send(request->beginChunkedResponse("text/json", filler));
+}
+bool WebServer::next_states_part_(StatesCursor &cursor) {
+  cursor.part.clear();
+  cursor.part_pos = 0;
+  if (!cursor.started) {
+    cursor.started = true;
+    char buf[48];
+    snprintf(buf, sizeof(buf), "{\"boot\":%u,\"seq\":%u,\"states\":[", cursor.boot_id, cursor.seq);
+    cursor.part = buf;
+    return true;
+  }
+  while (cursor.next < this->entity_changes_.size()) {
+    const EntityChange &change = this->entity_changes_[cursor.next++];
+    if (cursor.domain >= 0 && change.domain != cursor.domain)
+      continue;
+    if (cursor.only_changed && change.changed_seq <= cursor.since)
+      continue;
+    json::StaticJsonWriter<STATE_JSON_BUFFER_SIZE> writer;
+    this->write_state_json_(writer, change);
+    if (!cursor.first_state)
+      cursor.part += ',';
+    cursor.first_state = false;
+    cursor.part.append(writer.c_str(), writer.size());
+    return true;
+  }
+  if (cursor.finished)
+    return false;
+  cursor.finished = true;
+  cursor.part = "]}";
+  return true;
+}
+size_t WebServer::fill_states_response_(StatesCursor &cursor, uint8_t *buffer, size_t max_len) {
+  size_t len = 0;
+  while (len < max_len) {
+    if (cursor.part_pos == cursor.part.size() && !this->next_states_part_(cursor))
+      break;
+    const size_t n = std::min(max_len - len, cursor.part.size() - cursor.part_pos);
+    memcpy(buffer + len, cursor.part.data() + cursor.part_pos, n);
+    len += n;
+    cursor.part_pos += n;
+  }
+  return len;
+}
+
 bool WebServer::canHandle(AsyncWebServerRequest *request) {
-  if (request->url() == "/")
+  if (request->method() == HTTP_GET && (request->url() == "/states" || request->url() == "/events"))
+    return true;
+  if (request->method() == HTTP_GET && (request->url() == "/rows" || this->find_asset_(request->url()) != nullptr)) {
+    request->addInterestingHeader("If-None-Match");
     return true;
+  }
 
   UrlMatch match = match_url(request->url().c_str(), true);
   if (!match.valid)
@@ -484,11 +993,29 @@ bool WebServer::canHandle(AsyncWebServerRequest *request) {
     return true;
 #endif
 
+#ifdef USE_ESP32_CAMERA
+  if (request->method() == HTTP_GET && match.domain == "camera")
+    return true;
+#endif
+
   return false;
 }
 void WebServer::handleRequest(AsyncWebServerRequest *request) {
-  if (request->url() == "/") {
-    this->handle_index_request(request);
+  if (request->url() == "/rows") {
+    this->handle_rows_request(request);
+    return;
+  }
+  if (request->url() == "/states") {
+    this->handle_states_request(request);
+    return;
+  }
+  if (request->url() == "/events") {
+    this->handle_events_request(request);
+    return;
+  }
+  const WebServerAsset *asset = this->find_asset_(request->url());
+  if (asset != nullptr) {
+    this->handle_asset_request_(request, *asset);
     return;
   }
 
@@ -534,6 +1061,13 @@ void WebServer::handleRequest(AsyncWebServerRequest *request) {
     return;
   }
 #endif
+
+#ifdef USE_ESP32_CAMERA
+  if (match.domain == "camera") {
+    this->handle_camera_request(request, match);
+    return;
+  }
+#endif
 }
 
 bool WebServer::isRequestHandlerTrivial() { return false; }
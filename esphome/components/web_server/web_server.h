@@ -3,9 +3,15 @@
 #include "esphome/core/component.h"
 #include "esphome/core/controller.h"
 #include "esphome/components/web_server_base/web_server_base.h"
+#include "esphome/components/json/json_writer.h"
 
+#include <deque>
 #include <vector>
 
+#ifdef USE_ESP32_CAMERA
+#include "esphome/components/esp32_camera/esp32_camera.h"
+#endif
+
 namespace esphome {
 namespace web_server {
 
@@ -17,6 +23,126 @@ struct UrlMatch {
   bool valid;          ///< Whether this match is valid
 };
 
+/// A file compiled into flash, gzip compressed at build time.
+struct WebServerAsset {
+  const char *url;
+  const char *content_type;
+  const uint8_t *data;  ///< PROGMEM
+  size_t length;
+  const char *etag;  ///< Strong ETag (quoted), derived from the content
+};
+
+/// The entity types served by the web server.
+enum EntityDomain : uint8_t {
+  DOMAIN_SENSOR,
+  DOMAIN_SWITCH,
+  DOMAIN_BINARY_SENSOR,
+  DOMAIN_FAN,
+  DOMAIN_LIGHT,
+  DOMAIN_TEXT_SENSOR,
+};
+
+/// A non-internal entity with the sequence number of its latest state change, 0 if it hasn't changed yet.
+struct EntityChange {
+  Nameable *entity;
+  EntityDomain domain;
+  uint32_t changed_seq;
+};
+
+/// Progress of a '/states' response that is being streamed.
+struct StatesCursor;
+
+/// Maximum number of concurrent '/events' clients, further clients get a 503 response.
+static const uint8_t MAX_EVENT_CLIENTS = 4;
+
+/** An '/events' (Server-Sent Events) client.
+ *
+ * Events are queued per client and written from WebServer::loop() as far as the connection has room, so a
+ * slow client only delays its own events. States are queued by entity and always sent with the entity's
+ * latest state, log lines are queued up to the configured number of bytes.
+ */
+struct EventClient {
+  /// Only used by loop(), the TCP task deletes it right after setting disconnected.
+  AsyncClient *client{nullptr};
+  /// Set from the TCP task (under the connection lock) once the connection is gone.
+  volatile bool disconnected{false};
+  bool head_sent{false};
+  bool ping_due{false};
+  /// Indices into WebServer::entity_changes_ of the entities with an unsent state change.
+  std::vector<uint16_t> pending_states;
+  std::deque<std::string> pending_logs;
+  size_t pending_logs_size{0};
+  uint32_t last_states_sent{0};
+  /// State changes merged into one that was still queued.
+  uint32_t coalesced{0};
+  /// Log lines dropped because the queue was full.
+  uint32_t dropped_logs{0};
+};
+
+/** Response that hands the connection of an '/events' request over to WebServer::loop().
+ *
+ * AsyncWebServer calls this from its TCP task and deletes it once the client disconnects.
+ */
+class EventResponse : public AsyncWebServerResponse {
+ public:
+  EventResponse(EventClient *client) : client_(client) {}
+  ~EventResponse() override;
+  void _respond(AsyncWebServerRequest *request) override;
+  size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time) override { return 0; }
+  bool _sourceValid() const override { return true; }
+
+ protected:
+  EventClient *client_;
+};
+
+#ifdef USE_ESP32_CAMERA
+/// Maximum number of concurrent '/camera/stream' clients, further clients get a 503 response.
+static const uint8_t MAX_CAMERA_STREAMS = 2;
+
+/// A '/camera/stream' (multipart MJPEG) or '/camera/snapshot' (single JPEG) client.
+struct CameraClient {
+  /// Only used by loop(), the TCP task deletes it right after setting disconnected.
+  AsyncClient *client;
+  /// Set from the TCP task (under the connection lock) once the connection is gone.
+  volatile bool disconnected{false};
+  bool stream;
+  bool head_sent{false};
+  /// The multipart header of the current image has been sent.
+  bool part_started{false};
+  /// The snapshot has been sent completely or the client was rejected, the connection is being closed.
+  bool finished{false};
+  esp32_camera::CameraImageReader image_reader;
+  /// Fully queued image, kept alive until its data has been acknowledged.
+  std::shared_ptr<esp32_camera::CameraImage> image_in_flight;
+  /// Bytes queued on / acknowledged by the connection (wrapping).
+  uint32_t tx_queued{0};
+  volatile uint32_t tx_acked{0};
+  /// Value of tx_queued after the last queued image data.
+  uint32_t image_release_at{0};
+
+  /// Queue data on the connection. Without copy, data must stay valid until the peer acknowledged it.
+  void write(const void *data, size_t len, bool copy = true);
+  /// Whether image data queued without copying still waits for a TCP acknowledgement.
+  bool data_in_flight() const { return int32_t(this->tx_acked - this->image_release_at) < 0; }
+};
+
+/** Response that hands the connection of a camera request over to WebServer::loop(), which sends the images.
+ *
+ * AsyncWebServer calls this from its TCP task and deletes it once the client disconnects.
+ */
+class CameraResponse : public AsyncWebServerResponse {
+ public:
+  CameraResponse(CameraClient *client) : client_(client) {}
+  ~CameraResponse() override;
+  void _respond(AsyncWebServerRequest *request) override;
+  size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time) override;
+  bool _sourceValid() const override { return true; }
+
+ protected:
+  CameraClient *client_;
+};
+#endif
+
 /** This class allows users to create a web server with their ESP nodes.
  *
  * Behind the scenes it's using AsyncWebServer to set up the server. It exposes 3 things:
@@ -25,44 +151,65 @@ struct UrlMatch {
  * all state updates in real time + the debug log. Lastly, there's an REST API available
  * under the '/light/...', '/sensor/...', ... URLs. A full documentation for this API
  * can be found under https://esphome.io/web-api/index.html.
+ *
+ * The index page is static and generated at build time (see add_asset()), it loads the rows of
+ * the entity table from '/rows' before starting the script.
  */
 class WebServer : public Controller, public Component, public AsyncWebHandler {
  public:
   WebServer(web_server_base::WebServerBase *base) : base_(base) {}
-  /** Set the URL to the CSS <link> that's sent to each client. Defaults to
-   * https://esphome.io/_static/webserver-v1.min.css
+  /** Serve a file from flash. The data has to be gzip compressed, it's sent with "Content-Encoding: gzip"
+   * and answered with 304 Not Modified when the client already has this version.
    *
-   * @param css_url The url to the web server stylesheet.
+   * @param url The path of the file, for example "/" for the index page.
+   * @param content_type The MIME type of the uncompressed file.
+   * @param data The compressed data in PROGMEM.
+   * @param length The length of the compressed data.
+   * @param etag The quoted strong ETag of this version of the file.
    */
-  void set_css_url(const char *css_url);
-
-  /** Set the URL to the script that's embedded in the index page. Defaults to
-   * https://esphome.io/_static/webserver-v1.min.js
-   *
-   * @param js_url The url to the web server script.
-   */
-  void set_js_url(const char *js_url);
+  void add_asset(const char *url, const char *content_type, const uint8_t *data, size_t length, const char *etag);
+  /// Set the maximum number of bytes of log lines queued per '/events' client, older lines are dropped.
+  void set_event_queue_size(size_t event_queue_size) { this->event_queue_size_ = event_queue_size; }
+  /// Set the minimum time between two batches of state events to an '/events' client.
+  void set_event_interval(uint32_t event_interval) { this->event_interval_ = event_interval; }
 
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
   /// Setup the internal web server and register handlers.
   void setup() override;
+  /// Send queued events, and camera images to the stream and snapshot clients.
+  void loop() override;
 
   void dump_config() override;
 
   /// MQTT setup priority.
   float get_setup_priority() const override;
 
-  /// Handle an index request under '/'.
-  void handle_index_request(AsyncWebServerRequest *request);
+  /// Handle a request for the rows of the index page's entity table under '/rows'.
+  void handle_rows_request(AsyncWebServerRequest *request);
+
+  /// Handle a Server-Sent Events request under '/events'.
+  void handle_events_request(AsyncWebServerRequest *request);
+
+  /** Handle a request for the states of all entities under '/states'.
+   *
+   * Responds with {"boot":<boot>,"seq":<seq>,"states":[...]}, the states are in the same format as those of the
+   * per-entity endpoints. Optional parameters:
+   *  - domain: only entities of this type, for example "sensor".
+   *  - since, boot: only entities whose state changed after the "seq" of an earlier response with this "boot".
+   *    The sequence numbers start over when the device reboots, a different boot gets the states of all entities.
+   *
+   * The response is chunked and serialized while it's sent, so it needs memory for one state at a time.
+   */
+  void handle_states_request(AsyncWebServerRequest *request);
 
 #ifdef USE_SENSOR
   void on_sensor_update(sensor::Sensor *obj, float state) override;
   /// Handle a sensor request under '/sensor/<id>'.
   void handle_sensor_request(AsyncWebServerRequest *request, UrlMatch match);
 
-  /// Dump the sensor state with its value as a JSON string.
-  std::string sensor_json(sensor::Sensor *obj, float value);
+  /// Write the sensor state with its value as JSON.
+  void sensor_json(json::JsonWriter &writer, sensor::Sensor *obj, float value);
 #endif
 
 #ifdef USE_SWITCH
@@ -71,8 +218,8 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
   /// Handle a switch request under '/switch/<id>/</turn_on/turn_off/toggle>'.
   void handle_switch_request(AsyncWebServerRequest *request, UrlMatch match);
 
-  /// Dump the switch state with its value as a JSON string.
-  std::string switch_json(switch_::Switch *obj, bool value);
+  /// Write the switch state with its value as JSON.
+  void switch_json(json::JsonWriter &writer, switch_::Switch *obj, bool value);
 #endif
 
 #ifdef USE_BINARY_SENSOR
@@ -81,8 +228,8 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
   /// Handle a binary sensor request under '/binary_sensor/<id>'.
   void handle_binary_sensor_request(AsyncWebServerRequest *request, UrlMatch match);
 
-  /// Dump the binary sensor state with its value as a JSON string.
-  std::string binary_sensor_json(binary_sensor::BinarySensor *obj, bool value);
+  /// Write the binary sensor state with its value as JSON.
+  void binary_sensor_json(json::JsonWriter &writer, binary_sensor::BinarySensor *obj, bool value);
 #endif
 
 #ifdef USE_FAN
@@ -91,8 +238,8 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
   /// Handle a fan request under '/fan/<id>/</turn_on/turn_off/toggle>'.
   void handle_fan_request(AsyncWebServerRequest *request, UrlMatch match);
 
-  /// Dump the fan state as a JSON string.
-  std::string fan_json(fan::FanState *obj);
+  /// Write the fan state as JSON.
+  void fan_json(json::JsonWriter &writer, fan::FanState *obj);
 #endif
 
 #ifdef USE_LIGHT
@@ -101,8 +248,8 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
   /// Handle a light request under '/light/<id>/</turn_on/turn_off/toggle>'.
   void handle_light_request(AsyncWebServerRequest *request, UrlMatch match);
 
-  /// Dump the light state as a JSON string.
-  std::string light_json(light::LightState *obj);
+  /// Write the light state as JSON.
+  void light_json(json::JsonWriter &writer, light::LightState *obj);
 #endif
 
 #ifdef USE_TEXT_SENSOR
@@ -111,8 +258,13 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
   /// Handle a text sensor request under '/text_sensor/<id>'.
   void handle_text_sensor_request(AsyncWebServerRequest *request, UrlMatch match);
 
-  /// Dump the text sensor state with its value as a JSON string.
-  std::string text_sensor_json(text_sensor::TextSensor *obj, const std::string &value);
+  /// Write the text sensor state with its value as JSON.
+  void text_sensor_json(json::JsonWriter &writer, text_sensor::TextSensor *obj, const std::string &value);
+#endif
+
+#ifdef USE_ESP32_CAMERA
+  /// Handle a camera request under '/camera/stream' (multipart MJPEG) or '/camera/snapshot' (JPEG).
+  void handle_camera_request(AsyncWebServerRequest *request, UrlMatch match);
 #endif
 
   /// Override the web handler's canHandle method.
@@ -124,9 +276,46 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
 
  protected:
   web_server_base::WebServerBase *base_;
-  AsyncEventSource events_{"/events"};
-  const char *css_url_{nullptr};
-  const char *js_url_{nullptr};
+  /// Answer with 304 if the client's cached copy matches etag, returns whether a response was sent.
+  bool send_not_modified_(AsyncWebServerRequest *request, const char *etag);
+  /// Record a state change of entity for '/states?since=' and queue it for the '/events' clients.
+  void on_state_change_(Nameable *entity);
+  /// Queue a log line for the '/events' clients.
+  void on_log_(const char *message);
+  /// Write the queued events of a client as far as the connection has room.
+  void send_events_(EventClient *client);
+  /// Append an event to the connection, returns false if it doesn't have room for it.
+  bool write_event_(EventClient *client, const char *event, const char *data, size_t len);
+  void write_state_json_(json::JsonWriter &writer, const EntityChange &change);
+  /// Put the next part of a '/states' response into the cursor, returns false once the response is complete.
+  bool next_states_part_(StatesCursor &cursor);
+  size_t fill_states_response_(StatesCursor &cursor, uint8_t *buffer, size_t max_len);
+  void handle_asset_request_(AsyncWebServerRequest *request, const WebServerAsset &asset);
+  const WebServerAsset *find_asset_(const String &url) const;
+
+  /// Written from the TCP task when a client connects, cleared by loop() after the client disconnected.
+  EventClient *volatile event_clients_[MAX_EVENT_CLIENTS]{};
+  size_t event_queue_size_{2048};
+  uint32_t event_interval_{0};
+  /// Reused buffer for formatting events.
+  std::string event_buffer_;
+  std::vector<WebServerAsset> assets_;
+  /// The entity rows only change with the firmware, so their ETag is derived from the compilation time.
+  std::string rows_etag_;
+  /// All non-internal entities in the order of the index page.
+  std::vector<EntityChange> entity_changes_;
+  /// Incremented with every state change.
+  uint32_t state_seq_{0};
+  /// Random for every boot, tells the sequence numbers of different boots apart.
+  uint32_t boot_id_{0};
+#ifdef USE_ESP32_CAMERA
+  void process_camera_clients_();
+  void send_camera_data_(CameraClient *client);
+
+  /// New camera clients, passed from the TCP task to loop().
+  QueueHandle_t camera_client_queue_;
+  std::vector<CameraClient *> camera_clients_;
+#endif
 };
 
 }  // namespace web_server
@@ -167,6 +167,7 @@ CONF_HEAT_ACTION = 'heat_action'
 CONF_HIDDEN = 'hidden'
 CONF_HIGH = 'high'
 CONF_HIGH_VOLTAGE_REFERENCE = 'high_voltage_reference'
+CONF_HISTORY = 'history'
 CONF_HOUR = 'hour'
 CONF_HOURS = 'hours'
 CONF_HUMIDITY = 'humidity'
@@ -318,6 +319,7 @@ CONF_PROTOCOL = 'protocol'
 CONF_PULL_MODE = 'pull_mode'
 CONF_PULSE_LENGTH = 'pulse_length'
 CONF_QOS = 'qos'
+CONF_QUANTILE = 'quantile'
 CONF_RANDOM = 'random'
 CONF_RANGE = 'range'
 CONF_RANGE_FROM = 'range_from'
@@ -429,6 +431,7 @@ CONF_UART_ID = 'uart_id'
 CONF_UID = 'uid'
 CONF_UNIQUE = 'unique'
 CONF_UNIT_OF_MEASUREMENT = 'unit_of_measurement'
+CONF_UPDATE_ALIGNMENT = 'update_alignment'
 CONF_UPDATE_INTERVAL = 'update_interval'
 CONF_UPDATE_ON_BOOT = 'update_on_boot'
 CONF_USERNAME = 'username'
@@ -31,6 +31,7 @@ const uint32_t STATUS_LED_MASK = 0xFF00;
 const uint32_t STATUS_LED_OK = 0x0000;
 const uint32_t STATUS_LED_WARNING = 0x0100;
 const uint32_t STATUS_LED_ERROR = 0x0200;
+const uint32_t UPDATE_PHASE_GROUP_SPACING = 250;
 
 uint32_t global_state = 0;
 
@@ -146,7 +147,13 @@ void PollingComponent::call_setup() {
   this->setup();
 
   // Register interval.
-  this->set_interval("update", this->get_update_interval(), [this]() { this->update(); });
+  if (this->update_phase_group_.has_value()) {
+    const uint32_t phase = *this->update_phase_group_ * UPDATE_PHASE_GROUP_SPACING;
+    App.scheduler.set_aligned_interval(this, "update", this->get_update_interval(), phase,
+                                       [this]() { this->update(); });
+  } else {
+    this->set_interval("update", this->get_update_interval(), [this]() { this->update(); });
+  }
 }
 
 uint32_t PollingComponent::get_update_interval() const { return this->update_interval_; }
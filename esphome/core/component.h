@@ -52,6 +52,8 @@ extern const uint32_t STATUS_LED_MASK;
 extern const uint32_t STATUS_LED_OK;
 extern const uint32_t STATUS_LED_WARNING;
 extern const uint32_t STATUS_LED_ERROR;
+/// Distance in ms between the phases of consecutive update phase groups.
+extern const uint32_t UPDATE_PHASE_GROUP_SPACING;
 
 class Component {
  public:
@@ -223,6 +225,16 @@ class PollingComponent : public Component {
    */
   virtual void set_update_interval(uint32_t update_interval);
 
+  /** Align the updates of this component with the other polling components in phase group group.
+   *
+   * Instead of at a random offset, update() is called when millis() is a multiple of the update interval plus the
+   * phase of the group. Components of a group whose update intervals are multiples of each other therefore update
+   * back to back in one wake-up.
+   *
+   * @param group The phase group, the groups' phases are UPDATE_PHASE_GROUP_SPACING ms apart.
+   */
+  void set_update_phase_group(uint32_t group) { this->update_phase_group_ = group; }
+
   // ========== OVERRIDE METHODS ==========
   // (You'll only need this when creating your own custom sensor)
   virtual void update() = 0;
@@ -236,6 +248,7 @@ class PollingComponent : public Component {
 
  protected:
   uint32_t update_interval_;
+  optional<uint32_t> update_phase_group_;
 };
 
 /// Helper class that enables naming of objects so that it doesn't have to be re-implement every time.
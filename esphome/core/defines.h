@@ -5,6 +5,7 @@
 #define USE_LOGGER
 #define USE_BINARY_SENSOR
 #define USE_SENSOR
+#define USE_SENSOR_HISTORY
 #define USE_SWITCH
 #define USE_WIFI
 #define USE_STATUS_LED
@@ -105,11 +105,16 @@ std::string truncate_string(const std::string &s, size_t length) {
 }
 
 std::string value_accuracy_to_string(float value, int8_t accuracy_decimals) {
+  char tmp[VALUE_ACCURACY_BUF_SIZE];
+  value_accuracy_to_buf(tmp, value, accuracy_decimals);
+  return std::string(tmp);
+}
+size_t value_accuracy_to_buf(char *buf, float value, int8_t accuracy_decimals) {
   auto multiplier = float(pow10(accuracy_decimals));
   float value_rounded = roundf(value * multiplier) / multiplier;
-  char tmp[32];  // should be enough, but we should maybe improve this at some point.
-  dtostrf(value_rounded, 0, uint8_t(std::max(0, int(accuracy_decimals))), tmp);
-  return std::string(tmp);
+  // should be enough, but we should maybe improve this at some point.
+  dtostrf(value_rounded, 0, uint8_t(std::max(0, int(accuracy_decimals))), buf);
+  return strlen(buf);
 }
 std::string uint64_to_string(uint64_t num) {
   char buffer[17];
@@ -114,6 +114,10 @@ float gamma_correct(float value, float gamma);
 
 /// Create a string from a value and an accuracy in decimals.
 std::string value_accuracy_to_string(float value, int8_t accuracy_decimals);
+/// Size of the buffer for value_accuracy_to_buf().
+static const size_t VALUE_ACCURACY_BUF_SIZE = 32;
+/// Format a value with an accuracy in decimals into buf (VALUE_ACCURACY_BUF_SIZE bytes), returns the length.
+size_t value_accuracy_to_buf(char *buf, float value, int8_t accuracy_decimals);
 
 /// Convert a uint64_t to a hex string
 std::string uint64_to_string(uint64_t num);
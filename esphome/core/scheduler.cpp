@@ -36,27 +36,40 @@ bool HOT Scheduler::cancel_timeout(Component *component, const std::string &name
 }
 void HOT Scheduler::set_interval(Component *component, const std::string &name, uint32_t interval,
                                  std::function<void()> &&func) {
-  const uint32_t now = millis();
-
+  // only put offset in lower half
+  uint32_t offset = 0;
+  if (interval != 0 && interval != SCHEDULER_DONT_RUN)
+    offset = (random_uint32() % interval) / 2;
+  this->add_interval_(component, name, interval, millis() - offset, std::move(func));
+}
+void HOT Scheduler::set_aligned_interval(Component *component, const std::string &name, uint32_t interval,
+                                         uint32_t phase, std::function<void()> &&func) {
+  // pretend the last execution was at the latest multiple of interval plus phase. That's computed from the
+  // milliseconds since boot rather than millis(), 2^32 usually isn't a multiple of interval.
+  const uint32_t now = this->millis_();
+  uint32_t offset = 0;
+  if (interval != 0 && interval != SCHEDULER_DONT_RUN) {
+    const uint32_t since_boot = (uint64_t(this->millis_major_) << 32 | now) % interval;
+    offset = (since_boot + interval - phase % interval) % interval;
+  }
+  this->add_interval_(component, name, interval, now - offset, std::move(func));
+}
+void HOT Scheduler::add_interval_(Component *component, const std::string &name, uint32_t interval,
+                                  uint32_t last_execution, std::function<void()> &&func) {
   if (!name.empty())
     this->cancel_interval(component, name);
 
   if (interval == SCHEDULER_DONT_RUN)
     return;
 
-  // only put offset in lower half
-  uint32_t offset = 0;
-  if (interval != 0)
-    offset = (random_uint32() % interval) / 2;
-
-  ESP_LOGVV(TAG, "set_interval(name='%s', interval=%u, offset=%u)", name.c_str(), interval, offset);
+  ESP_LOGVV(TAG, "set_interval(name='%s', interval=%u, last_execution=%u)", name.c_str(), interval, last_execution);
 
   auto *item = new SchedulerItem();
   item->component = component;
   item->name = name;
   item->type = SchedulerItem::INTERVAL;
   item->interval = interval;
-  item->last_execution = now - offset;
+  item->last_execution = last_execution;
   item->f = std::move(func);
   item->remove = false;
   this->push_(item);
@@ -75,8 +88,9 @@ optional<uint32_t> HOT Scheduler::next_schedule_in() {
   return next_time - now;
 }
 void ICACHE_RAM_ATTR HOT Scheduler::call() {
-  const uint32_t now = millis();
+  const uint32_t now = this->millis_();
   this->process_to_add();
+  bool ran = false;
 
   while (true) {
     this->cleanup_();
@@ -106,7 +120,10 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
     // Warning: During f(), a lot of stuff can happen, including:
     //  - timeouts/intervals get added, potentially invalidating vector pointers
     //  - timeouts/intervals get cancelled
+    const uint32_t start = micros();
     item->f();
+    this->active_time_ += micros() - start;
+    ran = true;
 
     // Only pop after function call, this ensures we were reachable
     // during the function call and know if we were cancelled.
@@ -129,6 +146,8 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
     }
   }
 
+  if (ran)
+    this->wakeups_++;
   this->process_to_add();
 }
 void HOT Scheduler::process_to_add() {
@@ -158,6 +177,14 @@ void HOT Scheduler::pop_raw_() {
   this->items_.pop_back();
 }
 void HOT Scheduler::push_(Scheduler::SchedulerItem *item) { this->to_add_.push_back(item); }
+uint32_t HOT Scheduler::millis_() {
+  const uint32_t now = millis();
+  // call() runs often enough to see every overflow
+  if (now < this->last_millis_)
+    this->millis_major_++;
+  this->last_millis_ = now;
+  return now;
+}
 bool HOT Scheduler::cancel_item_(Component *component, const std::string &name, Scheduler::SchedulerItem::Type type) {
   bool ret = false;
   for (auto *it : this->items_)
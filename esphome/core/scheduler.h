@@ -12,6 +12,14 @@ class Scheduler {
   void set_timeout(Component *component, const std::string &name, uint32_t timeout, std::function<void()> &&func);
   bool cancel_timeout(Component *component, const std::string &name);
   void set_interval(Component *component, const std::string &name, uint32_t interval, std::function<void()> &&func);
+  /** Like set_interval(), but instead of at a random offset the interval runs when millis() is a multiple of
+   * interval plus phase.
+   *
+   * Aligned intervals with the same phase whose lengths are multiples of each other run in the same call(), so
+   * they cost one wake-up instead of one each.
+   */
+  void set_aligned_interval(Component *component, const std::string &name, uint32_t interval, uint32_t phase,
+                            std::function<void()> &&func);
   bool cancel_interval(Component *component, const std::string &name);
 
   optional<uint32_t> next_schedule_in();
@@ -20,6 +28,11 @@ class Scheduler {
 
   void process_to_add();
 
+  /// Number of call()s that ran at least one timeout or interval, wrapping.
+  uint32_t get_wakeups() const { return this->wakeups_; }
+  /// Total time in microseconds spent running timeouts and intervals, wrapping.
+  uint32_t get_active_time() const { return this->active_time_; }
+
  protected:
   struct SchedulerItem {
     Component *component;
@@ -36,6 +49,10 @@ class Scheduler {
     static bool cmp(SchedulerItem *a, SchedulerItem *b);
   };
 
+  void add_interval_(Component *component, const std::string &name, uint32_t interval, uint32_t last_execution,
+                     std::function<void()> &&func);
+  /// millis(), keeping track of its overflows.
+  uint32_t millis_();
   void cleanup_();
   void pop_raw_();
   void push_(SchedulerItem *item);
@@ -43,6 +60,11 @@ class Scheduler {
 
   std::vector<SchedulerItem *> items_;
   std::vector<SchedulerItem *> to_add_;
+  uint32_t wakeups_{0};
+  uint32_t active_time_{0};
+  uint32_t last_millis_{0};
+  /// Number of millis() overflows, the upper half of the milliseconds since boot.
+  uint32_t millis_major_{0};
 };
 
 }  // namespace esphome
@@ -9,7 +9,7 @@ from esphome.const import ARDUINO_VERSION_ESP32_DEV, ARDUINO_VERSION_ESP8266_DEV
     CONF_ARDUINO_VERSION, CONF_BOARD, CONF_BOARD_FLASH_MODE, CONF_BUILD_PATH, \
     CONF_ESPHOME, CONF_INCLUDES, CONF_LIBRARIES, \
     CONF_NAME, CONF_ON_BOOT, CONF_ON_LOOP, CONF_ON_SHUTDOWN, CONF_PLATFORM, \
-    CONF_PLATFORMIO_OPTIONS, CONF_PRIORITY, CONF_TRIGGER_ID, \
+    CONF_PLATFORMIO_OPTIONS, CONF_PRIORITY, CONF_TRIGGER_ID, CONF_UPDATE_ALIGNMENT, \
     CONF_ESP8266_RESTORE_FROM_FLASH, ARDUINO_VERSION_ESP8266_2_3_0, \
     ARDUINO_VERSION_ESP8266_2_5_0, ARDUINO_VERSION_ESP8266_2_5_1, ARDUINO_VERSION_ESP8266_2_5_2
 from esphome.core import CORE, coroutine_with_priority
@@ -19,6 +19,11 @@ from esphome.pins import ESP8266_FLASH_SIZES, ESP8266_LD_SCRIPTS
 _LOGGER = logging.getLogger(__name__)
 
 BUILD_FLASH_MODES = ['qio', 'qout', 'dio', 'dout']
+# How the updates of polling components are spread out:
+#  NONE: every component at its own random offset
+#  BUS: components on the same i2c/spi/uart bus, and the others with each other, update back to back
+#  ALL: all polling components update back to back, the fewest wake-ups
+UPDATE_ALIGNMENTS = ['NONE', 'BUS', 'ALL']
 StartupTrigger = cg.esphome_ns.class_('StartupTrigger', cg.Component, automation.Trigger.template())
 ShutdownTrigger = cg.esphome_ns.class_('ShutdownTrigger', cg.Component,
                                        automation.Trigger.template())
@@ -135,6 +140,7 @@ CONFIG_SCHEMA = cv.Schema({
     }),
     cv.Optional(CONF_INCLUDES, default=[]): cv.ensure_list(valid_include),
     cv.Optional(CONF_LIBRARIES, default=[]): cv.ensure_list(cv.string_strict),
+    cv.Optional(CONF_UPDATE_ALIGNMENT, default='NONE'): cv.one_of(*UPDATE_ALIGNMENTS, upper=True),
 
     cv.Optional('esphome_core_version'): cv.invalid("The esphome_core_version option has been "
                                                     "removed in 1.13 - the esphome core source "
@@ -1,8 +1,9 @@
-from esphome.const import CONF_INVERTED, CONF_MODE, CONF_NUMBER, CONF_SETUP_PRIORITY, \
-    CONF_UPDATE_INTERVAL, CONF_TYPE_ID
+from esphome.const import CONF_ESPHOME, CONF_I2C_ID, CONF_ID, CONF_INVERTED, CONF_MODE, CONF_NUMBER, \
+    CONF_SETUP_PRIORITY, CONF_SPI_ID, CONF_UART_ID, CONF_UPDATE_ALIGNMENT, CONF_UPDATE_INTERVAL, \
+    CONF_TYPE_ID
 from esphome.core import coroutine, ID, CORE
 from esphome.cpp_generator import RawExpression, add, get_variable
-from esphome.cpp_types import App, GPIOPin
+from esphome.cpp_types import App, GPIOPin, PollingComponent
 from esphome.py_compat import text_type
 
 
@@ -26,6 +27,29 @@ def gpio_pin_expression(conf):
     yield GPIOPin.new(number, RawExpression(mode), inverted)
 
 
+BUS_DOMAINS = [('i2c', CONF_I2C_ID), ('spi', CONF_SPI_ID), ('uart', CONF_UART_ID)]
+
+
+def update_phase_group(config):
+    """The update phase group of a polling component for the update_alignment option.
+
+    With BUS alignment every bus gets its own group (1, 2, ...), components that don't use a bus
+    share group 0. Returns None if the updates are not aligned.
+    """
+    alignment = CORE.config.get(CONF_ESPHOME, {}).get(CONF_UPDATE_ALIGNMENT, 'NONE')
+    if alignment == 'NONE':
+        return None
+    if alignment == 'ALL':
+        return 0
+    group = 0
+    for domain, key in BUS_DOMAINS:
+        for bus in CORE.config.get(domain, []):
+            group += 1
+            if key in config and config[key] == bus[CONF_ID]:
+                return group
+    return 0
+
+
 @coroutine
 def register_component(var, config):
     """Register the given obj as a component.
@@ -45,6 +69,10 @@ def register_component(var, config):
         add(var.set_setup_priority(config[CONF_SETUP_PRIORITY]))
     if CONF_UPDATE_INTERVAL in config:
         add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    if isinstance(var.base, ID) and var.base.type.inherits_from(PollingComponent):
+        group = update_phase_group(config)
+        if group is not None:
+            add(var.set_update_phase_group(group))
     add(App.register_component(var))
     yield var
 
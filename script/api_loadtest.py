@@ -0,0 +1,277 @@
+#!/usr/bin/env python
+"""Load generator for the native API of a running node.
+
+Opens several API connections at once, performs the same handshake as Home Assistant
+(hello, connect, list entities, subscribe states) and then toggles the node's switches and
+lights from every connection, measuring the time from sending a command until the matching
+state message arrives. Prints connection setup time, command-to-state latency percentiles
+and the number of state messages received per second:
+
+    script/api_loadtest.py livingroom.local --connections 4 --rate 5 --duration 30
+
+Connection i toggles entity i % (number of switches and lights), so use at most as many
+connections as there are such entities to get clean latency numbers.
+"""
+from __future__ import print_function
+
+import argparse
+import os
+import socket
+import sys
+import threading
+import time
+
+sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), '..')))
+
+import esphome.api.api_pb2 as pb  # noqa: E402 pylint: disable=wrong-import-position
+from esphome.api.client import MESSAGE_TYPE_TO_PROTO  # noqa: E402 pylint: disable=wrong-import-position
+
+PROTO_TO_MESSAGE_TYPE = {v: k for k, v in MESSAGE_TYPE_TO_PROTO.items()}
+STATE_RESPONSES = (pb.BinarySensorStateResponse, pb.CoverStateResponse, pb.FanStateResponse,
+                   pb.LightStateResponse, pb.SensorStateResponse, pb.SwitchStateResponse,
+                   pb.TextSensorStateResponse)
+
+
+class LoadTestError(Exception):
+    pass
+
+
+def encode_varint(value):
+    ret = bytearray()
+    while value > 0x7F:
+        ret.append((value & 0x7F) | 0x80)
+        value >>= 7
+    ret.append(value)
+    return ret
+
+
+def decode_varint(buf, pos):
+    """Return (value, new position) or (None, pos) if the varint is incomplete."""
+    result = 0
+    shift = 0
+    while pos < len(buf):
+        val = buf[pos]
+        pos += 1
+        result |= (val & 0x7F) << shift
+        shift += 7
+        if (val & 0x80) == 0:
+            return result, pos
+    return None, pos
+
+
+class Stats(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.setup_times = []
+        self.latencies = []
+        self.timeouts = 0
+        self.states = 0
+        self.failed = 0
+
+    def add(self, client):
+        with self.lock:
+            if client.setup_time is not None:
+                self.setup_times.append(client.setup_time)
+            self.latencies += client.latencies
+            self.timeouts += client.timeouts
+            self.states += client.states
+            if client.error is not None:
+                self.failed += 1
+
+
+class LoadClient(threading.Thread):
+    def __init__(self, index, args):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self.index = index
+        self.args = args
+        self.socket = None
+        self.buffer = bytearray()
+        self.setup_time = None
+        self.latencies = []
+        self.timeouts = 0
+        self.states = 0
+        self.error = None
+
+    def send(self, msg):
+        encoded = msg.SerializeToString()
+        frame = bytearray([0x00]) + encode_varint(len(encoded))
+        frame += encode_varint(PROTO_TO_MESSAGE_TYPE[type(msg)]) + bytearray(encoded)
+        self.socket.sendall(bytes(frame))
+
+    def recv(self, timeout):
+        """Receive the next message, or None on timeout. Keepalive requests are answered here."""
+        deadline = time.time() + timeout
+        while True:
+            msg = self._parse_message()
+            if msg is not None:
+                if isinstance(msg, pb.PingRequest):
+                    self.send(pb.PingResponse())
+                    continue
+                if isinstance(msg, pb.GetTimeRequest):
+                    self.send(pb.GetTimeResponse(epoch_seconds=int(time.time())))
+                    continue
+                if isinstance(msg, pb.DisconnectRequest):
+                    raise LoadTestError("Node closed the connection")
+                return msg
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                return None
+            self.socket.settimeout(remaining)
+            try:
+                data = self.socket.recv(4096)
+            except socket.timeout:
+                return None
+            if not data:
+                raise LoadTestError("Connection closed")
+            self.buffer += bytearray(data)
+
+    def _parse_message(self):
+        while self.buffer:
+            if self.buffer[0] != 0x00:
+                raise LoadTestError("Invalid preamble")
+            length, pos = decode_varint(self.buffer, 1)
+            if length is None:
+                return None
+            msg_type, pos = decode_varint(self.buffer, pos)
+            if msg_type is None or len(self.buffer) < pos + length:
+                return None
+            raw = bytes(self.buffer[pos:pos + length])
+            del self.buffer[:pos + length]
+            if msg_type not in MESSAGE_TYPE_TO_PROTO:
+                continue
+            msg = MESSAGE_TYPE_TO_PROTO[msg_type]()
+            msg.ParseFromString(raw)
+            return msg
+        return None
+
+    def request(self, msg, response_type, timeout=10.0):
+        self.send(msg)
+        deadline = time.time() + timeout
+        while True:
+            resp = self.recv(deadline - time.time())
+            if resp is None:
+                raise LoadTestError("Timeout waiting for {}".format(response_type.__name__))
+            if isinstance(resp, response_type):
+                return resp
+
+    def handshake(self):
+        start = time.time()
+        self.socket = socket.create_connection((self.args.host, self.args.port), 10.0)
+        self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.request(pb.HelloRequest(client_info='api_loadtest'), pb.HelloResponse)
+        resp = self.request(pb.ConnectRequest(password=self.args.password), pb.ConnectResponse)
+        if resp.invalid_password:
+            raise LoadTestError("Invalid password")
+
+        targets = []
+        self.send(pb.ListEntitiesRequest())
+        while True:
+            msg = self.recv(10.0)
+            if msg is None:
+                raise LoadTestError("Timeout waiting for ListEntitiesDoneResponse")
+            if isinstance(msg, (pb.ListEntitiesSwitchResponse, pb.ListEntitiesLightResponse)):
+                targets.append(msg)
+            if isinstance(msg, pb.ListEntitiesDoneResponse):
+                break
+        self.setup_time = time.time() - start
+        self.send(pb.SubscribeStatesRequest())
+        return targets
+
+    def command_loop(self, target, deadline):
+        is_light = isinstance(target, pb.ListEntitiesLightResponse)
+        state_type = pb.LightStateResponse if is_light else pb.SwitchStateResponse
+        interval = 1.0 / self.args.rate if self.args.rate > 0 else None
+        current = None
+        pending = None  # (expected state, send time)
+        next_command = time.time()
+
+        while time.time() < deadline:
+            now = time.time()
+            if pending is None and interval is not None and current is not None and now >= next_command:
+                pending = (not current, now)
+                if is_light:
+                    self.send(pb.LightCommandRequest(key=target.key, has_state=True, state=pending[0]))
+                else:
+                    self.send(pb.SwitchCommandRequest(key=target.key, state=pending[0]))
+                next_command = now + interval
+            elif pending is not None and now - pending[1] > self.args.timeout:
+                self.timeouts += 1
+                pending = None
+
+            wait = min(deadline, next_command if pending is None else pending[1] + self.args.timeout) - now
+            msg = self.recv(max(wait, 0.001))
+            if msg is None or not isinstance(msg, STATE_RESPONSES):
+                continue
+            self.states += 1
+            if isinstance(msg, state_type) and msg.key == target.key:
+                current = msg.state
+                if pending is not None and msg.state == pending[0]:
+                    self.latencies.append(time.time() - pending[1])
+                    pending = None
+
+    def run(self):
+        try:
+            targets = self.handshake()
+            deadline = time.time() + self.args.duration
+            if targets:
+                self.command_loop(targets[self.index % len(targets)], deadline)
+            else:
+                # nothing to command, only measure the state message rate
+                while time.time() < deadline:
+                    msg = self.recv(deadline - time.time())
+                    if isinstance(msg, STATE_RESPONSES):
+                        self.states += 1
+            self.send(pb.DisconnectRequest())
+        except (socket.error, LoadTestError) as err:
+            self.error = err
+        finally:
+            if self.socket is not None:
+                self.socket.close()
+
+
+def format_times(values):
+    if not values:
+        return "no samples"
+    values = sorted(values)
+
+    def percentile(p):
+        return values[min(len(values) - 1, int(p / 100.0 * len(values)))] * 1000.0
+
+    return "p50 {:.1f}ms  p90 {:.1f}ms  p99 {:.1f}ms  max {:.1f}ms  ({} samples)".format(
+        percentile(50), percentile(90), percentile(99), values[-1] * 1000.0, len(values))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the native API of a running node.")
+    parser.add_argument('host', help="Address of the node")
+    parser.add_argument('--port', type=int, default=6053)
+    parser.add_argument('--password', default='')
+    parser.add_argument('-c', '--connections', type=int, default=1, help="Number of parallel connections")
+    parser.add_argument('-d', '--duration', type=float, default=10.0, help="Seconds to send commands for")
+    parser.add_argument('-r', '--rate', type=float, default=2.0,
+                        help="Commands per second per connection, 0 to only count state messages")
+    parser.add_argument('--timeout', type=float, default=2.0, help="Seconds to wait for a command's state")
+    args = parser.parse_args()
+
+    stats = Stats()
+    clients = [LoadClient(i, args) for i in range(args.connections)]
+    start = time.time()
+    for client in clients:
+        client.start()
+    for client in clients:
+        client.join()
+        stats.add(client)
+        if client.error is not None:
+            print("Connection {} failed: {}".format(client.index, client.error), file=sys.stderr)
+    elapsed = time.time() - start
+
+    print("Connections:           {} ({} failed)".format(args.connections, stats.failed))
+    print("Connect + list:        {}".format(format_times(stats.setup_times)))
+    print("Command -> state:      {}, {} timeouts".format(format_times(stats.latencies), stats.timeouts))
+    print("State messages:        {} ({:.1f}/s)".format(stats.states, stats.states / elapsed))
+    return 1 if stats.failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,241 @@
+#!/usr/bin/env python
+"""Generate the native API message structs from api.proto.
+
+Every message becomes a plain struct plus a static field table (stored in flash) that the
+generic decoder/encoder in esphome/components/api/proto.cpp walks. Run this script after
+changing api.proto and commit the generated api_pb2.h/api_pb2.cpp with it:
+
+    script/api_protobuf.py
+"""
+from __future__ import print_function
+
+import os
+import re
+import sys
+
+root_path = os.path.abspath(os.path.normpath(os.path.join(__file__, '..', '..')))
+api_path = os.path.join(root_path, 'esphome', 'components', 'api')
+
+# proto type -> (C++ type, ProtoFieldType, default initializer)
+SCALAR_TYPES = {
+    'bool': ('bool', 'PROTO_TYPE_BOOL', 'false'),
+    'uint32': ('uint32_t', 'PROTO_TYPE_UINT32', '0'),
+    'int32': ('int32_t', 'PROTO_TYPE_INT32', '0'),
+    'fixed32': ('uint32_t', 'PROTO_TYPE_FIXED32', '0'),
+    'float': ('float', 'PROTO_TYPE_FLOAT', '0.0f'),
+    'string': ('std::string', 'PROTO_TYPE_STRING', None),
+    'bytes': ('std::string', 'PROTO_TYPE_STRING', None),
+}
+
+HEADER = """\
+// This file was automatically generated with script/api_protobuf.py
+// from api.proto - do not edit it by hand.
+"""
+
+ID_RE = re.compile(r'^//\s*ID:\s*(\d+)\s*$')
+MESSAGE_RE = re.compile(r'^message\s+(\w+)\s*\{\s*$')
+ENUM_RE = re.compile(r'^enum\s+(\w+)\s*\{\s*$')
+FIELD_RE = re.compile(r'^(repeated\s+)?(\w+)\s+(\w+)\s*=\s*(\d+)\s*;$')
+ENUM_VALUE_RE = re.compile(r'^(\w+)\s*=\s*(\d+)\s*;$')
+
+
+class ProtoError(Exception):
+    pass
+
+
+class Enum(object):
+    def __init__(self, name):
+        self.name = name
+        self.values = []
+
+
+class Field(object):
+    def __init__(self, repeated, type_, name, number):
+        self.repeated = repeated
+        self.type = type_
+        self.name = name
+        self.number = number
+
+
+class Message(object):
+    def __init__(self, name, id_):
+        self.name = name
+        self.id = id_
+        self.fields = []
+
+
+def upper_snake(name):
+    return re.sub(r'(?<=[a-z0-9])([A-Z])', r'_\1', name).upper()
+
+
+def parse_proto(path):
+    enums = []
+    messages = []
+    stack = []
+    pending_id = None
+    with open(path) as f:
+        lines = f.read().splitlines()
+    for lineno, raw in enumerate(lines, 1):
+        line = raw.strip()
+        match = ID_RE.match(line)
+        if match:
+            pending_id = int(match.group(1))
+            continue
+        line = line.split('//')[0].strip()
+        if not line or line.startswith('syntax'):
+            continue
+        match = MESSAGE_RE.match(line)
+        if match:
+            if any(isinstance(x, Message) for x in stack):
+                raise ProtoError("{}: nested messages are not supported".format(lineno))
+            msg = Message(match.group(1), pending_id)
+            pending_id = None
+            messages.append(msg)
+            stack.append(msg)
+            continue
+        match = ENUM_RE.match(line)
+        if match:
+            # nested enums are hoisted to the namespace under their own name
+            enum = Enum(match.group(1))
+            enums.append(enum)
+            stack.append(enum)
+            continue
+        if line == '}':
+            if not stack:
+                raise ProtoError("{}: unbalanced '}}'".format(lineno))
+            stack.pop()
+            continue
+        if stack and isinstance(stack[-1], Enum):
+            match = ENUM_VALUE_RE.match(line)
+            if match is None:
+                raise ProtoError("{}: invalid enum value '{}'".format(lineno, line))
+            stack[-1].values.append((match.group(1), int(match.group(2))))
+            continue
+        if stack and isinstance(stack[-1], Message):
+            match = FIELD_RE.match(line)
+            if match is None:
+                raise ProtoError("{}: unsupported field '{}'".format(lineno, line))
+            stack[-1].fields.append(Field(bool(match.group(1)), match.group(2), match.group(3),
+                                          int(match.group(4))))
+            continue
+        raise ProtoError("{}: cannot parse '{}'".format(lineno, line))
+    if stack:
+        raise ProtoError("Unexpected end of file")
+
+    names = [x.name for x in enums] + [x.name for x in messages]
+    duplicates = {x for x in names if names.count(x) > 1}
+    if duplicates:
+        raise ProtoError("Duplicate type names: {}".format(', '.join(sorted(duplicates))))
+    return enums, messages
+
+
+def cpp_field(field, enums, messages):
+    if field.type in SCALAR_TYPES:
+        cpp_type, proto_type, default = SCALAR_TYPES[field.type]
+    elif field.type in enums:
+        enum = enums[field.type]
+        cpp_type, proto_type = enum.name, 'PROTO_TYPE_ENUM'
+        default = next(upper_snake(enum.name) + '_' + name for name, value in enum.values if value == 0)
+    elif field.type in messages:
+        cpp_type, proto_type, default = field.type, 'PROTO_TYPE_MESSAGE', None
+    else:
+        raise ProtoError("Unknown type '{}' of field {}".format(field.type, field.name))
+    if field.repeated:
+        return 'std::vector<{}>'.format(cpp_type), cpp_type, proto_type, None
+    return cpp_type, cpp_type, proto_type, default
+
+
+def wrap_line(line, limit=120):
+    """Wrap a too long table line like clang-format: after a comma aligned to the opening brace if
+    that helps, otherwise after the opening brace with a continuation indent."""
+    if len(line) <= limit:
+        return [line]
+    brace = line.find('{')
+    split = line.rfind(', ', 0, limit)
+    if split > brace + 1 and brace + 1 + len(line) - split - 2 <= limit:
+        return [line[:split + 1]] + wrap_line(' ' * (brace + 1) + line[split + 2:], limit)
+    if brace < 0:
+        return [line]
+    return [line[:brace + 1]] + wrap_line('    ' + line[brace + 1:], limit)
+
+
+def generate(enums, messages):
+    enum_map = {x.name: x for x in enums}
+    message_map = {}
+    header = [HEADER, '#pragma once', '', '#include "proto.h"', '', 'namespace esphome {', 'namespace api {', '']
+    source = [HEADER, '#include "api_pb2.h"', '#include <cstddef>', '',
+              '// the structs are not standard-layout because of their std::string members, but offsetof',
+              '// is well-defined for them with GCC', '#pragma GCC diagnostic ignored "-Winvalid-offsetof"', '',
+              'namespace esphome {', 'namespace api {', '']
+
+    header.append('enum class APIMessageType {')
+    for msg in sorted((x for x in messages if x.id is not None), key=lambda x: x.id):
+        header.append('  {} = {},'.format(upper_snake(msg.name), msg.id))
+    header += ['};', '']
+
+    for enum in enums:
+        header.append('enum {} : uint32_t {{'.format(enum.name))
+        for name, value in enum.values:
+            header.append('  {}_{} = {},'.format(upper_snake(enum.name), name, value))
+        header += ['};', '']
+
+    for msg in messages:
+        header.append('struct {} {{'.format(msg.name))
+        if msg.id is not None:
+            header.append('  static const APIMessageType MESSAGE_TYPE = APIMessageType::{};'.format(
+                upper_snake(msg.name)))
+        header.append('  static const ProtoMessageInfo INFO;')
+        if msg.fields:
+            header.append('')
+
+        by_number = {}
+        for field in msg.fields:
+            member_type, element_type, proto_type, default = cpp_field(field, enum_map, message_map)
+            if default is None:
+                header.append('  {} {};'.format(member_type, field.name))
+            else:
+                header.append('  {} {}{{{}}};'.format(member_type, field.name, default))
+            nested = '&{}::INFO'.format(element_type) if proto_type == 'PROTO_TYPE_MESSAGE' else 'nullptr'
+            repeated_ops = '&ProtoRepeated<{}>::OPS'.format(element_type) if field.repeated else 'nullptr'
+            if field.number in by_number:
+                raise ProtoError("Duplicate field number {} in {}".format(field.number, msg.name))
+            by_number[field.number] = '    {{{}, {}, offsetof({}, {}), {}, {}}},'.format(
+                proto_type, 'true' if field.repeated else 'false', msg.name, field.name, nested, repeated_ops)
+        header += ['};', '']
+        message_map[msg.name] = msg
+
+        if not by_number:
+            source.append('const ProtoMessageInfo {}::INFO PROGMEM = {{nullptr, 0}};'.format(msg.name))
+            source.append('')
+            continue
+        # the table is indexed by field number, gaps get an unused entry
+        table = '{}_FIELDS'.format(upper_snake(msg.name))
+        count = max(by_number)
+        source.append('static const ProtoField {}[{}] PROGMEM = {{'.format(table, count))
+        for number in range(1, count + 1):
+            source += wrap_line(by_number.get(number, '    {PROTO_TYPE_NONE, false, 0, nullptr, nullptr},'))
+        source.append('};')
+        source += wrap_line('const ProtoMessageInfo {}::INFO PROGMEM = {{{}, {}}};'.format(msg.name, table, count))
+        source.append('')
+
+    footer = ['', '}  // namespace api', '}  // namespace esphome', '']
+    return '\n'.join(header[:-1] + footer), '\n'.join(source[:-1] + footer)
+
+
+def main():
+    try:
+        enums, messages = parse_proto(os.path.join(api_path, 'api.proto'))
+        header, source = generate(enums, messages)
+    except ProtoError as err:
+        print("Error: {}".format(err), file=sys.stderr)
+        return 1
+    with open(os.path.join(api_path, 'api_pb2.h'), 'w') as f:
+        f.write(header)
+    with open(os.path.join(api_path, 'api_pb2.cpp'), 'w') as f:
+        f.write(source)
+    print("Generated {} messages and {} enums".format(len(messages), len(enums)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,296 @@
+#!/usr/bin/env python
+"""Minimal MQTT 3.1.1/5 broker stand-in for measuring the traffic of a node.
+
+Accepts connections, acknowledges everything and prints what the clients send, without routing
+messages between clients. For MQTT 5 clients it grants topic aliases and a receive maximum so that
+those code paths are exercised. Point a node (or any client) at it and watch the per-message byte
+counts:
+
+    script/mqtt_broker_stub.py --port 1883 --topic-alias-maximum 32 --receive-maximum 16 -v
+
+Statistics are printed every --interval seconds and when a client disconnects. "TCP reads" counts
+the chunks the data arrived in, which shows how well a client batches its packets.
+"""
+from __future__ import print_function
+
+import argparse
+import socket
+import struct
+import sys
+import threading
+
+CONNECT, CONNACK, PUBLISH, PUBACK, PUBREC, PUBREL, PUBCOMP = 1, 2, 3, 4, 5, 6, 7
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK, PINGREQ, PINGRESP, DISCONNECT = 8, 9, 10, 11, 12, 13, 14
+
+PROPERTY_TOPIC_ALIAS = 0x23
+# property id -> size in bytes, 'v' for varint, 's' for length prefixed, 'p' for a pair of strings
+PROPERTY_SIZES = {
+    0x01: 1, 0x02: 4, 0x03: 's', 0x08: 's', 0x09: 's', 0x0B: 'v', 0x11: 4, 0x12: 's', 0x13: 2,
+    0x15: 's', 0x16: 's', 0x17: 1, 0x18: 4, 0x19: 1, 0x1A: 's', 0x1C: 's', 0x1F: 's', 0x21: 2,
+    0x22: 2, 0x23: 2, 0x24: 1, 0x25: 1, 0x26: 'p', 0x27: 4, 0x28: 1, 0x29: 1, 0x2A: 1,
+}
+
+
+class ProtocolError(Exception):
+    pass
+
+
+def encode_varint(value):
+    ret = bytearray()
+    while value > 0x7F:
+        ret.append((value & 0x7F) | 0x80)
+        value >>= 7
+    ret.append(value)
+    return ret
+
+
+def decode_varint(buf, pos):
+    """Return (value, new position) or (None, pos) if the varint is incomplete."""
+    result = 0
+    for shift in range(0, 28, 7):
+        if pos >= len(buf):
+            return None, pos
+        val = buf[pos]
+        pos += 1
+        result |= (val & 0x7F) << shift
+        if (val & 0x80) == 0:
+            return result, pos
+    raise ProtocolError("Malformed varint")
+
+
+def read_u16(buf, pos):
+    if pos + 2 > len(buf):
+        raise ProtocolError("Truncated packet")
+    return struct.unpack('>H', bytes(buf[pos:pos + 2]))[0], pos + 2
+
+
+def read_string(buf, pos):
+    length, pos = read_u16(buf, pos)
+    if pos + length > len(buf):
+        raise ProtocolError("Truncated string")
+    return bytes(buf[pos:pos + length]), pos + length
+
+
+def read_properties(buf, pos):
+    """Return ({id: value}, new position), only integer values are decoded."""
+    length, pos = decode_varint(buf, pos)
+    if length is None or pos + length > len(buf):
+        raise ProtocolError("Truncated properties")
+    end = pos + length
+    props = {}
+    while pos < end:
+        prop_id = buf[pos]
+        pos += 1
+        size = PROPERTY_SIZES.get(prop_id)
+        if size is None:
+            raise ProtocolError("Unknown property 0x{:02X}".format(prop_id))
+        if size == 'v':
+            props[prop_id], pos = decode_varint(buf, pos)
+        elif size == 's':
+            _, pos = read_string(buf, pos)
+        elif size == 'p':
+            _, pos = read_string(buf, pos)
+            _, pos = read_string(buf, pos)
+        else:
+            props[prop_id] = int(''.join('{:02x}'.format(b) for b in buf[pos:pos + size]), 16)
+            pos += size
+    return props, end
+
+
+def packet(packet_type, flags, body):
+    return bytes(bytearray([(packet_type << 4) | flags]) + encode_varint(len(body)) + body)
+
+
+class Stats(object):
+    def __init__(self):
+        self.publishes = 0
+        self.publish_bytes = 0
+        self.payload_bytes = 0
+        self.aliased = 0
+        self.reads = 0
+        self.read_bytes = 0
+
+    def __str__(self):
+        if not self.publishes:
+            return "no PUBLISH packets, {} bytes in {} TCP reads".format(self.read_bytes, self.reads)
+        return ("{} PUBLISH packets: {:.1f} bytes each on average ({:.1f} payload), {} sent with a topic alias; "
+                "{} bytes in {} TCP reads ({:.1f} packets per read)").format(
+                    self.publishes, float(self.publish_bytes) / self.publishes,
+                    float(self.payload_bytes) / self.publishes, self.aliased, self.read_bytes, self.reads,
+                    float(self.publishes) / max(self.reads, 1))
+
+
+class ClientHandler(threading.Thread):
+    def __init__(self, sock, address, args):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self.sock = sock
+        self.name = '{}:{}'.format(*address)
+        self.args = args
+        self.version = None
+        self.aliases = {}
+        self.stats = Stats()
+        self.lock = threading.Lock()
+
+    def log(self, msg):
+        print("[{}] {}".format(self.name, msg))
+
+    def send(self, data):
+        self.sock.sendall(data)
+
+    def run(self):
+        buf = bytearray()
+        try:
+            while True:
+                data = self.sock.recv(4096)
+                if not data:
+                    break
+                with self.lock:
+                    self.stats.reads += 1
+                    self.stats.read_bytes += len(data)
+                buf += bytearray(data)
+                while True:
+                    if len(buf) < 2:
+                        break
+                    length, pos = decode_varint(buf, 1)
+                    if length is None or len(buf) < pos + length:
+                        break
+                    self.handle(buf[0], buf[pos:pos + length], pos + length)
+                    del buf[:pos + length]
+        except (socket.error, ProtocolError) as err:
+            self.log("Error: {}".format(err))
+        finally:
+            self.sock.close()
+            self.log("Disconnected, {}".format(self.stats))
+
+    def handle(self, header, body, size):
+        packet_type = header >> 4
+        if self.version is None and packet_type != CONNECT:
+            raise ProtocolError("Expected CONNECT")
+        if packet_type == CONNECT:
+            self.handle_connect(body)
+        elif packet_type == PUBLISH:
+            self.handle_publish(header & 0x0F, body, size)
+        elif packet_type == PUBREL:
+            self.send(packet(PUBCOMP, 0, body[:2]))
+        elif packet_type == SUBSCRIBE:
+            packet_id, pos = read_u16(body, 0)
+            if self.version == 5:
+                _, pos = read_properties(body, pos)
+            codes = bytearray()
+            while pos < len(body):
+                topic, pos = read_string(body, pos)
+                codes.append(body[pos] & 0x03)
+                pos += 1
+                if self.args.verbose:
+                    self.log("SUBSCRIBE {}".format(topic.decode('utf-8', 'replace')))
+            props = bytearray([0]) if self.version == 5 else bytearray()
+            self.send(packet(SUBACK, 0, bytearray(struct.pack('>H', packet_id)) + props + codes))
+        elif packet_type == UNSUBSCRIBE:
+            packet_id, _ = read_u16(body, 0)
+            self.send(packet(UNSUBACK, 0, bytearray(struct.pack('>H', packet_id))))
+        elif packet_type == PINGREQ:
+            self.send(packet(PINGRESP, 0, bytearray()))
+        elif packet_type == DISCONNECT:
+            self.log("DISCONNECT")
+        elif packet_type not in (PUBACK, PUBREC, PUBCOMP):
+            raise ProtocolError("Unexpected packet type {}".format(packet_type))
+
+    def handle_connect(self, body):
+        name, pos = read_string(body, 0)
+        if name != b'MQTT':
+            raise ProtocolError("Unsupported protocol {!r}".format(name))
+        self.version = body[pos]
+        pos += 4
+        if self.version == 5:
+            props = bytearray([0x21]) + bytearray(struct.pack('>H', self.args.receive_maximum))
+            if self.args.topic_alias_maximum:
+                props += bytearray([0x22]) + bytearray(struct.pack('>H', self.args.topic_alias_maximum))
+            self.send(packet(CONNACK, 0, bytearray([0, 0]) + encode_varint(len(props)) + props))
+        elif self.version == 4:
+            self.send(packet(CONNACK, 0, bytearray([0, 0])))
+        else:
+            raise ProtocolError("Unsupported protocol version {}".format(self.version))
+        self.log("CONNECT, MQTT {}".format('5' if self.version == 5 else '3.1.1'))
+
+    def handle_publish(self, flags, body, size):
+        qos = (flags >> 1) & 0x03
+        topic, pos = read_string(body, 0)
+        topic_sent = bool(topic)
+        packet_id = None
+        if qos > 0:
+            packet_id, pos = read_u16(body, pos)
+        alias = None
+        if self.version == 5:
+            props, pos = read_properties(body, pos)
+            alias = props.get(PROPERTY_TOPIC_ALIAS)
+        if alias is not None:
+            if alias == 0 or alias > self.args.topic_alias_maximum:
+                raise ProtocolError("Invalid topic alias {}".format(alias))
+            if topic_sent:
+                self.aliases[alias] = topic
+            elif alias not in self.aliases:
+                raise ProtocolError("Unknown topic alias {}".format(alias))
+            else:
+                topic = self.aliases[alias]
+        elif not topic:
+            raise ProtocolError("PUBLISH without topic")
+        payload = bytes(body[pos:])
+
+        with self.lock:
+            self.stats.publishes += 1
+            self.stats.publish_bytes += size
+            self.stats.payload_bytes += len(payload)
+            if not topic_sent:
+                self.stats.aliased += 1
+        if self.args.verbose:
+            self.log("PUBLISH {} = {!r} ({} bytes{})".format(
+                topic.decode('utf-8', 'replace'), payload, size, ", alias {}".format(alias) if alias else ""))
+
+        if qos == 1:
+            self.send(packet(PUBACK, 0, bytearray(struct.pack('>H', packet_id))))
+        elif qos == 2:
+            self.send(packet(PUBREC, 0, bytearray(struct.pack('>H', packet_id))))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="MQTT broker stand-in that prints per-message traffic.")
+    parser.add_argument('--port', type=int, default=1883)
+    parser.add_argument('--topic-alias-maximum', type=int, default=32,
+                        help="Topic aliases granted to MQTT 5 clients, 0 to disable")
+    parser.add_argument('--receive-maximum', type=int, default=16,
+                        help="Unacknowledged QoS 1/2 messages allowed per MQTT 5 client")
+    parser.add_argument('--interval', type=float, default=10.0, help="Seconds between statistics output")
+    parser.add_argument('-v', '--verbose', action='store_true', help="Print every message")
+    args = parser.parse_args()
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('', args.port))
+    server.listen(5)
+    server.settimeout(args.interval)
+    print("Listening on port {}".format(args.port))
+
+    clients = []
+    try:
+        while True:
+            try:
+                sock, address = server.accept()
+            except socket.timeout:
+                clients = [c for c in clients if c.is_alive()]
+                for client in clients:
+                    with client.lock:
+                        client.log(str(client.stats))
+                continue
+            client = ClientHandler(sock, address, args)
+            client.start()
+            clients.append(client)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())